@@ -0,0 +1,185 @@
+/// @file
+/// @brief Checks that the agents of the mbe::CooperativePathPlanner do not collide when they cross a wall through two narrow corridors
+/// @details The map is 40x21 tiles with a wall in the middle that has two corridors of width one. Half of the agents start left of the wall
+/// and go to the right, the other half go the other way. In the round trip mode, every agent requests the path back to its start
+/// from the mbe::event::GoalReachedEvent callback. Prints the number of arrived agents, time steps, collisions and the update time
+/// for 16, 32, 48 and 64 agents in both modes. A collision is two agents on the same tile or two agents swapping their tiles.
+/// @n A run stops after 2000 time steps. Agents that meet head on inside a corridor may block each other for good, since backing out
+/// does not bring them closer to their goal within the window, so not every run ends with all agents arrived.
+/// @n Build it with optimisations together with the sources of the MBE library, using the Include directory and SFML as include paths.
+
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/CooperativePathPlanner.h>
+#include <MBE/Core/EntityManager.h>
+
+using namespace mbe;
+
+namespace
+{
+	// Diagonal moves are only possible if both adjacent straight neighbours are walkable
+	struct CorridorTileMap
+	{
+		typedef sf::Vector2i Position;
+
+		int width;
+		int height;
+		// The movement speed of each tile. Blocked tiles are 0.
+		std::vector<float> movementSpeedList;
+
+		sf::Vector2u GetSize() const { return sf::Vector2u(width, height); }
+
+		bool IsTileWalkable(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height && movementSpeedList[y * width + x] > 0.f; }
+
+		float GetTileMovementSpeed(int x, int y) const { return movementSpeedList[y * width + x]; }
+
+		std::vector<Position> GetReachableTiles(Position position) const
+		{
+			std::vector<Position> reachableTileList;
+			for (int offsetY = -1; offsetY <= 1; offsetY++)
+			{
+				for (int offsetX = -1; offsetX <= 1; offsetX++)
+				{
+					if ((offsetX == 0 && offsetY == 0) || IsTileWalkable(position.x + offsetX, position.y + offsetY) == false)
+						continue;
+
+					if (offsetX != 0 && offsetY != 0 && (IsTileWalkable(position.x + offsetX, position.y) == false || IsTileWalkable(position.x, position.y + offsetY) == false))
+						continue;
+
+					reachableTileList.push_back(Position(position.x + offsetX, position.y + offsetY));
+				}
+			}
+			return reachableTileList;
+		}
+	};
+
+	CorridorTileMap CreateMap()
+	{
+		CorridorTileMap map{ 40, 21, std::vector<float>(40 * 21, 1.f) };
+		for (int y = 0; y < map.height; y++)
+		{
+			for (int x = 15; x < 25; x++)
+				map.movementSpeedList[y * map.width + x] = y == 5 || y == 15 ? 1.f : 0.f;
+		}
+		return map;
+	}
+
+	struct Result
+	{
+		int arrivedCount = 0;
+		int timeStepCount = 0;
+		int collisionCount = 0;
+		double updateDuration = 0.0;
+	};
+
+	Result Run(const CorridorTileMap & map, size_t agentCount, bool roundTrip)
+	{
+		// The agents with even indices start on the left
+		std::mt19937 random(1);
+		std::vector<sf::Vector2i> startList, goalList;
+		std::set<int> usedStartSet, usedGoalSet;
+		while (startList.size() < agentCount)
+		{
+			const bool left = startList.size() % 2 == 0;
+			const sf::Vector2i start(left ? random() % 10 : 30 + random() % 10, random() % map.height);
+			const sf::Vector2i goal(left ? 30 + random() % 10 : random() % 10, random() % map.height);
+			if (usedStartSet.insert(start.y * map.width + start.x).second == false)
+				continue;
+			if (usedGoalSet.insert(goal.y * map.width + goal.x).second == false)
+			{
+				usedStartSet.erase(start.y * map.width + start.x);
+				continue;
+			}
+
+			startList.push_back(start);
+			goalList.push_back(goal);
+		}
+
+		EventManager eventManager;
+		EntityManager entityManager(eventManager);
+		CooperativePathPlanner<CorridorTileMap> planner(map, eventManager);
+		std::vector<Entity::ID> entityIdList;
+		std::vector<bool> returningList(agentCount, false);
+		Result result;
+
+		const auto goalReachedSubscription = eventManager.Subscribe(EventManager::TCallback<event::GoalReachedEvent>([&](const event::GoalReachedEvent & event)
+			{
+				result.arrivedCount++;
+				for (size_t i = 0; roundTrip && i < agentCount; i++)
+				{
+					if (entityIdList[i] == event.GetEntityID() && returningList[i] == false)
+					{
+						returningList[i] = true;
+						planner.Request(entityIdList[i], goalList[i], startList[i]);
+					}
+				}
+			}));
+
+		for (size_t i = 0; i < agentCount; i++)
+		{
+			entityIdList.push_back(entityManager.CreateEntity().GetHandleID());
+			planner.Request(entityIdList[i], startList[i], goalList[i]);
+		}
+
+		std::vector<sf::Vector2i> previousPositionList = startList;
+		for (; result.timeStepCount < 2000 && planner.GetAgentCount() > 0; result.timeStepCount++)
+		{
+			const auto startTime = std::chrono::steady_clock::now();
+			planner.Update();
+			const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+			result.updateDuration += duration.count();
+
+			planner.AdvanceTime();
+
+			std::vector<sf::Vector2i> positionList = previousPositionList;
+			for (size_t i = 0; i < agentCount; i++)
+			{
+				if (planner.HasRequest(entityIdList[i]))
+					positionList[i] = planner.GetPosition(entityIdList[i]);
+			}
+
+			for (size_t i = 0; i < agentCount; i++)
+			{
+				for (size_t j = i + 1; j < agentCount; j++)
+				{
+					if (planner.HasRequest(entityIdList[i]) == false || planner.HasRequest(entityIdList[j]) == false)
+						continue;
+
+					const bool sameTile = positionList[i] == positionList[j];
+					const bool swapped = positionList[i] == previousPositionList[j] && positionList[j] == previousPositionList[i] && positionList[i] != positionList[j];
+					if (sameTile || swapped)
+						result.collisionCount++;
+				}
+			}
+
+			previousPositionList = positionList;
+		}
+
+		eventManager.UnSubscribe<event::GoalReachedEvent>(goalReachedSubscription);
+		return result;
+	}
+} // namespace
+
+int main()
+{
+	const CorridorTileMap map = CreateMap();
+
+	for (const bool roundTrip : { false, true })
+	{
+		for (const size_t agentCount : { 16u, 32u, 48u, 64u })
+		{
+			const Result result = Run(map, agentCount, roundTrip);
+			std::printf("%-10s %2zu agents: arrived %3d, time steps %4d, collisions %d, update %8.2f ms\n",
+				roundTrip ? "round trip" : "one way", agentCount, result.arrivedCount, result.timeStepCount, result.collisionCount, result.updateDuration);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,170 @@
+/// @file
+/// @brief Compares the mbe::HierarchicalPathfinder with the mbe::AStarPathfinder
+/// @details Uses a 1024x1024 map with uniform movement cost and 10% of the tiles blocked at random. Prints:
+/// @n - the time it takes to construct the hierarchical pathfinder (best of 3)
+/// @n - the time of a query from the top left to the bottom right corner (best of 100)
+/// @n - the median and mean time of 101 queries between random tiles that are at least 512 tiles apart,
+/// once on a newly constructed pathfinder and once after the same queries have been made before
+/// @n - how much longer the paths of the hierarchical pathfinder are on average
+/// @n Build it with optimisations together with Source/MBE/Core/PathSearchSpace.cpp and Source/MBE/Core/EventManager.cpp
+/// (and their dependencies), using the Include directory and SFML as include paths.
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/AStarPathfinder.h>
+#include <MBE/Core/HierarchicalPathfinder.h>
+
+using namespace mbe;
+
+namespace
+{
+	// Diagonal moves are only possible if both adjacent straight neighbours are walkable
+	struct BenchmarkTileMap
+	{
+		typedef sf::Vector2i Position;
+
+		static constexpr bool HAS_REACHABLE_TILE_MASK = true;
+
+		int width;
+		int height;
+		// The movement speed of each tile. Blocked tiles are 0.
+		std::vector<float> movementSpeedList;
+		std::vector<TileNeighbourMask> reachableTileMaskList;
+
+		sf::Vector2u GetSize() const { return sf::Vector2u(width, height); }
+
+		bool IsTileWalkable(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height && movementSpeedList[y * width + x] > 0.f; }
+
+		float GetTileMovementSpeed(int x, int y) const { return movementSpeedList[y * width + x]; }
+
+		TileNeighbourMask GetReachableTileMask(int x, int y) const { return reachableTileMaskList[y * width + x]; }
+
+		void CreateReachableTileMasks()
+		{
+			reachableTileMaskList.assign(movementSpeedList.size(), 0);
+			for (int y = 0; y < height; y++)
+			{
+				for (int x = 0; x < width; x++)
+				{
+					for (unsigned int i = 0u; i < 8u; i++)
+					{
+						const int offsetX = detail::TILE_NEIGHBOUR_OFFSET_X[i];
+						const int offsetY = detail::TILE_NEIGHBOUR_OFFSET_Y[i];
+						if (IsTileWalkable(x + offsetX, y + offsetY) == false)
+							continue;
+
+						if (offsetX != 0 && offsetY != 0 && (IsTileWalkable(x + offsetX, y) == false || IsTileWalkable(x, y + offsetY) == false))
+							continue;
+
+						reachableTileMaskList[y * width + x] |= static_cast<TileNeighbourMask>(1u << i);
+					}
+				}
+			}
+		}
+	};
+
+	double GetMilliseconds(std::chrono::steady_clock::time_point startTime)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	double GetMedian(std::vector<double> durationList)
+	{
+		std::sort(durationList.begin(), durationList.end());
+		return durationList[durationList.size() / 2];
+	}
+
+	double GetMean(const std::vector<double> & durationList)
+	{
+		double sum = 0.0;
+		for (const auto duration : durationList)
+			sum += duration;
+
+		return sum / durationList.size();
+	}
+} // namespace
+
+int main()
+{
+	const int mapSize = 1024;
+	const size_t queryCount = 101;
+
+	std::mt19937 random(7);
+	BenchmarkTileMap map{ mapSize, mapSize, std::vector<float>(static_cast<size_t>(mapSize) * mapSize) };
+	for (auto & movementSpeed : map.movementSpeedList)
+		movementSpeed = random() % 10 == 0 ? 0.f : 1.f;
+	map.movementSpeedList.front() = map.movementSpeedList.back() = 1.f;
+	map.CreateReachableTileMasks();
+
+	std::vector<std::pair<sf::Vector2i, sf::Vector2i>> queryList;
+	while (queryList.size() < queryCount)
+	{
+		const sf::Vector2i start(random() % mapSize, random() % mapSize);
+		const sf::Vector2i end(random() % mapSize, random() % mapSize);
+		if (map.IsTileWalkable(start.x, start.y) && map.IsTileWalkable(end.x, end.y) && std::max(std::abs(start.x - end.x), std::abs(start.y - end.y)) >= mapSize / 2)
+			queryList.push_back({ start, end });
+	}
+
+	double constructionDuration = 1e30;
+	for (int run = 0; run < 3; run++)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		HierarchicalPathfinder<BenchmarkTileMap> pathfinder(map);
+		constructionDuration = std::min(constructionDuration, GetMilliseconds(startTime));
+	}
+
+	HierarchicalPathfinder<BenchmarkTileMap> hierarchicalPathfinder(map);
+	AStarPathfinder<BenchmarkTileMap> aStarPathfinder(map);
+	std::vector<sf::Vector2i> path;
+
+	// The first queries build the intra edges of the clusters they reach
+	std::vector<double> firstDurationList, hierarchicalDurationList, aStarDurationList;
+	double hierarchicalPathLength = 0.0, aStarPathLength = 0.0;
+	for (const auto & query : queryList)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		hierarchicalPathfinder.FindPath(query.first, query.second, path);
+		firstDurationList.push_back(GetMilliseconds(startTime));
+		hierarchicalPathLength += path.size();
+
+		startTime = std::chrono::steady_clock::now();
+		aStarPathfinder.FindPath(query.first, query.second, path);
+		aStarDurationList.push_back(GetMilliseconds(startTime));
+		aStarPathLength += path.size();
+	}
+
+	for (const auto & query : queryList)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		hierarchicalPathfinder.FindPath(query.first, query.second, path);
+		hierarchicalDurationList.push_back(GetMilliseconds(startTime));
+	}
+
+	double hierarchicalCornerDuration = 1e30, aStarCornerDuration = 1e30;
+	for (int run = 0; run < 100; run++)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		hierarchicalPathfinder.FindPath({ 0, 0 }, { mapSize - 1, mapSize - 1 }, path);
+		hierarchicalCornerDuration = std::min(hierarchicalCornerDuration, GetMilliseconds(startTime));
+
+		startTime = std::chrono::steady_clock::now();
+		aStarPathfinder.FindPath({ 0, 0 }, { mapSize - 1, mapSize - 1 }, path);
+		aStarCornerDuration = std::min(aStarCornerDuration, GetMilliseconds(startTime));
+	}
+
+	std::printf("construction  HPA* %8.1f ms\n", constructionDuration);
+	std::printf("corner        HPA* %8.3f ms  A* %8.3f ms\n", hierarchicalCornerDuration, aStarCornerDuration);
+	std::printf("long (first)  HPA* %8.3f ms  A* %8.3f ms (median)\n", GetMedian(firstDurationList), GetMedian(aStarDurationList));
+	std::printf("              HPA* %8.3f ms  A* %8.3f ms (mean)\n", GetMean(firstDurationList), GetMean(aStarDurationList));
+	std::printf("long (again)  HPA* %8.3f ms (median), %.3f ms (mean)\n", GetMedian(hierarchicalDurationList), GetMean(hierarchicalDurationList));
+	std::printf("HPA* paths are %.2f%% longer\n", 100.0 * (hierarchicalPathLength / aStarPathLength - 1.0));
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+/// @file
+/// @brief Compares the a star and the jump point search mode of the mbe::AStarPathfinder
+/// @details Runs 100 random queries on three 512x512 maps and prints the best time of 5 runs and the number of expanded nodes:
+/// @n - open: uniform movement cost with 10% of the tiles blocked at random
+/// @n - maze: uniform movement cost with walls every 6 tiles that have random gaps
+/// @n - mixed: random rectangles with movement speeds from 1 to 4, a quarter of which are blocked
+/// @n Build it with optimisations together with Source/MBE/Core/PathSearchSpace.cpp, using the Include directory and SFML as include paths.
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/AStarPathfinder.h>
+
+using namespace mbe;
+
+namespace
+{
+	// Diagonal moves are only possible if both adjacent straight neighbours are walkable
+	struct BenchmarkTileMap
+	{
+		typedef sf::Vector2i Position;
+
+		int width;
+		int height;
+		// The movement speed of each tile. Blocked tiles are 0.
+		std::vector<float> movementSpeedList;
+
+		sf::Vector2u GetSize() const { return sf::Vector2u(width, height); }
+
+		bool IsTileWalkable(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height && movementSpeedList[y * width + x] > 0.f; }
+
+		float GetTileMovementSpeed(int x, int y) const { return movementSpeedList[y * width + x]; }
+
+		std::vector<Position> GetReachableTiles(Position position) const
+		{
+			std::vector<Position> reachableTileList;
+			for (int offsetY = -1; offsetY <= 1; offsetY++)
+			{
+				for (int offsetX = -1; offsetX <= 1; offsetX++)
+				{
+					if ((offsetX == 0 && offsetY == 0) || IsTileWalkable(position.x + offsetX, position.y + offsetY) == false)
+						continue;
+
+					if (offsetX != 0 && offsetY != 0 && (IsTileWalkable(position.x + offsetX, position.y) == false || IsTileWalkable(position.x, position.y + offsetY) == false))
+						continue;
+
+					reachableTileList.push_back(Position(position.x + offsetX, position.y + offsetY));
+				}
+			}
+			return reachableTileList;
+		}
+	};
+
+	enum class MapKind { Open, Maze, Mixed };
+
+	BenchmarkTileMap CreateMap(MapKind kind, int size, std::mt19937 & random)
+	{
+		BenchmarkTileMap map{ size, size, std::vector<float>(static_cast<size_t>(size) * size, 1.f) };
+
+		if (kind == MapKind::Open)
+		{
+			for (auto & movementSpeed : map.movementSpeedList)
+				movementSpeed = random() % 10 == 0 ? 0.f : 1.f;
+		}
+		else if (kind == MapKind::Maze)
+		{
+			for (int y = 0; y < size; y++)
+			{
+				for (int x = 0; x < size; x++)
+				{
+					if ((x % 6 == 0 && random() % 8 != 0) || (y % 6 == 0 && random() % 8 != 0))
+						map.movementSpeedList[y * size + x] = 0.f;
+				}
+			}
+		}
+		else
+		{
+			for (int i = 0; i < size * size / 150; i++)
+			{
+				const int left = random() % size;
+				const int top = random() % size;
+				const int right = std::min(size, left + 1 + static_cast<int>(random() % 12));
+				const int bottom = std::min(size, top + 1 + static_cast<int>(random() % 12));
+				const float movementSpeed = random() % 4 == 0 ? 0.f : static_cast<float>(1 + random() % 4);
+
+				for (int y = top; y < bottom; y++)
+				{
+					for (int x = left; x < right; x++)
+						map.movementSpeedList[y * size + x] = movementSpeed;
+				}
+			}
+		}
+
+		return map;
+	}
+} // namespace
+
+int main()
+{
+	const char * mapNameList[] = { "open", "maze", "mixed" };
+	const MapKind mapKindList[] = { MapKind::Open, MapKind::Maze, MapKind::Mixed };
+	const PathSearchMode searchModeList[] = { PathSearchMode::AStar, PathSearchMode::JumpPointSearch };
+	const int mapSize = 512;
+	const size_t queryCount = 100;
+	const int runCount = 5;
+
+	for (int mapIndex = 0; mapIndex < 3; mapIndex++)
+	{
+		std::mt19937 random(11 + mapIndex);
+		const BenchmarkTileMap map = CreateMap(mapKindList[mapIndex], mapSize, random);
+
+		std::vector<std::pair<sf::Vector2i, sf::Vector2i>> queryList;
+		while (queryList.size() < queryCount)
+		{
+			const sf::Vector2i start(random() % mapSize, random() % mapSize);
+			const sf::Vector2i end(random() % mapSize, random() % mapSize);
+			if (map.IsTileWalkable(start.x, start.y) && map.IsTileWalkable(end.x, end.y))
+				queryList.push_back({ start, end });
+		}
+
+		AStarPathfinder<BenchmarkTileMap> pathfinder(map);
+		std::vector<sf::Vector2i> path;
+
+		std::printf("%-6s", mapNameList[mapIndex]);
+		for (const auto searchMode : searchModeList)
+		{
+			double bestDuration = 1e30;
+			size_t expandedNodeCount = 0;
+			for (int run = 0; run < runCount; run++)
+			{
+				expandedNodeCount = 0;
+				const auto startTime = std::chrono::steady_clock::now();
+				for (const auto & query : queryList)
+				{
+					pathfinder.FindPath(query.first, query.second, path, searchMode);
+					expandedNodeCount += pathfinder.GetExpandedNodeCount();
+				}
+				const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+				bestDuration = std::min(bestDuration, duration.count());
+			}
+
+			std::printf("  %s %7.1f ms (%8zu expanded)", searchMode == PathSearchMode::AStar ? "A*" : "JPS", bestDuration, expandedNodeCount);
+		}
+		std::printf("\n");
+	}
+
+	return 0;
+}
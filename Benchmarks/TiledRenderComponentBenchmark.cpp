@@ -0,0 +1,80 @@
+/// @file
+/// @brief Measures how long mbe::TiledRenderComponent::Create() takes with and without a mbe::ThreadPool
+/// @details Creates a 1024x1024 layer of 32x32 pixel tiles from a 512x512 tileset and prints the best time of 20 runs
+/// on the calling thread and with thread pools of 1, 2, 4 and std::thread::hardware_concurrency() threads.
+/// @n The mbe::TiledTerrain passes its thread pool (see mbe::TiledTerrain::SetThreadPool()) to the same function.
+/// @n Build it with optimisations together with the sources of the MBE library and link it against SFML.
+
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+
+#include <MBE/Core/EventManager.h>
+#include <MBE/Core/EntityManager.h>
+#include <MBE/Core/ThreadPool.h>
+#include <MBE/Graphics/TiledRenderComponent.h>
+
+using namespace mbe;
+
+namespace
+{
+	double MeasureCreate(TiledRenderComponent& renderComponent, const std::vector<size_t>& tileIndexList, ThreadPool* threadPool)
+	{
+		double bestDuration = 1e30;
+		for (int run = 0; run < 20; run++)
+		{
+			const auto startTime = std::chrono::steady_clock::now();
+			renderComponent.Create(tileIndexList, threadPool);
+			const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+			bestDuration = std::min(bestDuration, duration.count());
+		}
+
+		return bestDuration;
+	}
+} // namespace
+
+int main()
+{
+	const sf::Vector2u layerSize(1024u, 1024u);
+	const sf::Vector2u tileSize(32u, 32u);
+
+	sf::Texture tileset;
+	if (tileset.create(512u, 512u) == false)
+	{
+		std::printf("The tileset texture could not be created\n");
+		return 1;
+	}
+
+	EventManager eventManager;
+	EntityManager entityManager(eventManager);
+	auto& entity = entityManager.CreateEntity();
+	auto& renderComponent = entity.AddComponent<TiledRenderComponent>(layerSize, tileSize);
+
+	sf::RenderStates renderStates;
+	renderStates.texture = &tileset;
+	renderComponent.SetRenderStates(renderStates);
+
+	// Every tile of the 16x16 tileset is used
+	std::vector<size_t> tileIndexList(static_cast<size_t>(layerSize.x) * layerSize.y);
+	for (size_t i = 0; i < tileIndexList.size(); i++)
+		tileIndexList[i] = (i * 7u) % 256u;
+
+	std::printf("calling thread   %7.2f ms\n", MeasureCreate(renderComponent, tileIndexList, nullptr));
+
+	std::vector<size_t> threadCountList = { 1u, 2u, 4u };
+	if (std::thread::hardware_concurrency() > 4u)
+		threadCountList.push_back(std::thread::hardware_concurrency());
+
+	for (const auto threadCount : threadCountList)
+	{
+		ThreadPool threadPool(threadCount);
+		std::printf("%2zu pool threads  %7.2f ms\n", threadCount, MeasureCreate(renderComponent, tileIndexList, &threadPool));
+	}
+
+	return 0;
+}
@@ -3,21 +3,17 @@
 /// @file
 /// @brief Class mbe::AStarPathfinder
 
-#include <iostream>
-#include <string>
 #include <vector>
-#include <unordered_map>
-#include <array>
-#include <queue>
-#include <unordered_set>
 #include <algorithm>
 #include <limits>
-#include <memory>
+#include <cstdint>
 #include <cassert>
 
 #include <SFML/System/Vector2.hpp>
 
-#include <MBE/Core/AStarNode.h>
+#include <MBE/Core/PathSearchSpace.h>
+#include <MBE/Core/TileConnectivity.h>
+#include <MBE/Map/ReachableTileList.h>
 
 // Change assert(speed >= 1.f) to assert(speed >= defaultSpeed) where default speed may be declared in the constants class or the gird
 // Somehow make sure that the tile movement speed it always greater that 1 (the heuristic movement speed)
@@ -36,6 +32,23 @@ namespace mbe
 		HeuristicCount
 	};
 
+	/// @brief The algorithm used by the mbe::AStarPathfinder
+	enum class PathSearchMode : unsigned short int
+	{
+		/// @brief Every reachable neighbour of an expanded node is added to the open list
+		AStar,
+		/// @brief Jump point search
+		/// @details Symmetric paths through areas of equal movement cost are pruned by jumping along straight and diagonal lines
+		/// and only adding the points where the path may have to turn to the open list. Tiles next to tiles with a different
+		/// movement cost are expanded like in the a star mode.
+		/// @n The found paths cost the same as with PathSearchMode::AStar. This requires that GetReachableTiles() returns the walkable
+		/// straight and diagonal neighbours of a tile, where diagonal moves are only possible if both adjacent straight neighbours are walkable.
+		/// @n It pays off on maps where large areas share the same movement cost and are separated by walls (e.g. rooms and corridors).
+		/// On maps with many different movement speeds it can rarely jump and is slower than PathSearchMode::AStar.
+		/// On open maps with scattered obstacles both modes take about as long (see Benchmarks/PathSearchModeBenchmark.cpp).
+		JumpPointSearch
+	};
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////
 	/// @brief Class that can be used to perform a star pathfinding on a tile map
 	/// @tparam TTileMap The type of tile map the pathfinding is performed on.
@@ -43,9 +56,21 @@ namespace mbe
 	/// @n - Position GetSize() const
 	/// @n - float GetTileMovementSpeed(unsigned int x, unsigned int y)
 	/// @n - std::vector<Position> GetReachableTiles(unsigned int x, unsigned int y)
+	/// @n - mbe::TileNeighbourMask GetReachableTileMask(int x, int y) const and static constexpr bool HAS_REACHABLE_TILE_MASK = true
+	/// (Optional, used instead of GetReachableTiles() so that expanding a node does not allocate, see mbe::detail::HasReachableTileMask).
+	/// Tile maps derived from mbe::TileMapBase provide it.
+	/// @n - bool IsTileWalkable(int x, int y) const (Only used by the jump point search)
 	/// @n - typedef Position with an x and a y member.
-	//// @details STUFF ON MULTITHREADING
-	template <class TTileMap/*, Heuristic heuristic = Heuristic::PythagorasDistance*/>
+	/// @tparam defaultSearchMode The search mode that is used if none is passed to FindPath()
+	/// @details The state of the search is stored in a mbe::detail::PathSearchSpace with one node per tile, which is allocated in the constructor.
+	/// Starting a new search is O(1) and the open list supports decreasing the key of a node that is already in it.
+	/// @n The heuristic is the number of straight or diagonal moves to the goal (see mbe::detail::PathStepDistance()),
+	/// so the found paths are the cheapest ones as long as every tile movement speed is at least 1.
+	/// Since many nodes have the same estimated cost, nodes with equal f and g values are expanded in the order of their straight line distance to the goal.
+	/// @n The size of the tile map is read in the constructor. A pathfinder must be recreated if the size of the map changes.
+	/// @n A pathfinder is not thread safe. To find paths on multiple threads, each thread should use its own pathfinder
+	/// (the tile map must then be safe to read concurrently).
+	template <class TTileMap, PathSearchMode defaultSearchMode = PathSearchMode::AStar/*, Heuristic heuristic = Heuristic::PythagorasDistance*/>
 	class AStarPathfinder
 	{
 	public:
@@ -53,226 +78,473 @@ namespace mbe
 		/// @details This will be the same as the position type the tile map is using
 		typedef typename TTileMap::Position Position;
 
-	private:
-		struct CompareNodes
-		{
-			bool operator () (const detail::AStarNode::Ptr & lhs, const detail::AStarNode::Ptr & rhs) const
-			{
-				return lhs->GetF() > rhs->GetF();
-			}
-		};
-
 	public:
 		/// @brief Constructor
 		/// @param tileMap A reference to the tileMap on which the pathfinding is performed
 		AStarPathfinder(const TTileMap & tileMap);
 
-		/// @brief Destructor
-		~AStarPathfinder();
+		/// @brief Default destructor
+		~AStarPathfinder() = default;
 
 		/// @brief Finds the best path between two points on the tileMap
 		/// @param startPos The start position
 		/// @param endPos The end position
+		/// @param searchMode The algorithm that is used
 		/// @returns The path as a list of positions. If no path could be found, an empty list is returned
-		std::vector<Position> FindPath(Position startPos, Position endPos);
+		std::vector<Position> FindPath(Position startPos, Position endPos, PathSearchMode searchMode = defaultSearchMode);
+
+		/// @brief Finds the best path between two points on the tileMap
+		/// @details Unlike the overload that returns the path, this does not allocate if the capacity of the passed in list is large enough.
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @param path The list the path is written to. It is cleared if no path could be found.
+		/// @param searchMode The algorithm that is used
+		/// @returns True if a path has been found, false otherwise
+		bool FindPath(Position startPos, Position endPos, std::vector<Position> & path, PathSearchMode searchMode = defaultSearchMode);
+
+		/// @brief Sets the connectivity labels that are used to reject unreachable goals without searching
+		/// @details Without the labels, a search for an unreachable goal expands every tile that can be reached from the start.
+		/// The labels must be kept up to date by calling mbe::TileConnectivity::InvalidateTiles() when the tile map changes.
+		/// @param connectivity The labels of the tile map or nullptr to search without them. They must outlive the pathfinder.
+		inline void SetConnectivity(const TileConnectivity<TTileMap> * connectivity) { this->connectivity = connectivity; }
+
+		/// @brief Returns the number of nodes that have been expanded by the last search
+		inline size_t GetExpandedNodeCount() const { return expandedNodeCount; }
 
 	private:
-		void ExpandNode(detail::AStarNode::Ptr currentNode, Position endPosition);
+		void ExpandNode(size_t nodeIndex, Position endPosition);
 
-		// Takes care that only nodes are created that are examined by the algorithm
-		// The actual logic of what is a neighbour on the graph lies withing the TTileMap::GetReachableTiles() method
-		std::vector<detail::AStarNode::Ptr> GetNeighbours(Position nodePosition);
+		// Adds the jump points that are reached from the node to the open list
+		// The directions are pruned if the node has a parent and all of its neighbours have the same movement cost
+		void ExpandJumpPoint(size_t nodeIndex, Position endPosition);
 
-		inline bool DoesNodeExist(Position position) const;
-		inline void SetNode(detail::AStarNode::Ptr node);
-		inline detail::AStarNode::Ptr GetNode(Position position) const;
+		// Jumps from the node in the direction and adds the found jump point to the open list
+		void AddJumpPoint(size_t nodeIndex, Position position, int directionX, int directionY, Position endPosition);
 
-		// Clear the open and closed lists and node map
-		void Reset();
+		// Steps from the position in the direction until reaching a jump point
+		// Returns detail::INVALID_NODE_INDEX if there is none. Otherwise, the number of steps is written to stepCount.
+		size_t Jump(Position position, int directionX, int directionY, Position endPosition, unsigned int & stepCount) const;
+
+		// Jump() for straight directions
+		// The results are cached for every tile on the way since the diagonal jumps scan the same lines many times
+		size_t JumpStraight(Position position, int directionX, int directionY, Position endPosition, unsigned int & stepCount) const;
+
+		// Returns false for tiles outside the map
+		inline bool IsWalkable(long long x, long long y) const;
+
+		inline bool CanMove(Position position, int directionX, int directionY) const;
+
+		// Whether all walkable neighbours of the tile have the same movement cost as the tile
+		bool HasUniformNeighbourhood(Position position) const;
+
+		// Returns the cached flags of a tile (they are reset when a new jump point search starts)
+		inline unsigned char& GetTileFlags(size_t nodeIndex) const;
+
+		inline size_t GetNodeIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline Position GetNodePosition(size_t nodeIndex) const;
 
 	private:
-		// The open and closed lists are used to keep items (std::shared_ptrs) alive
-		std::priority_queue<detail::AStarNode::Ptr, std::vector<detail::AStarNode::Ptr>, CompareNodes> openList;
-		std::vector<detail::AStarNode::Ptr> closedList;
+		enum TileFlag : unsigned char
+		{
+			WalkableKnown = 1 << 0,
+			Walkable = 1 << 1,
+			UniformNeighbourhoodKnown = 1 << 2,
+			UniformNeighbourhood = 1 << 3,
+			// Shifted by the index of the straight direction (right, left, down, up)
+			StraightJumpKnown = 1 << 4
+		};
+
+		// The search state of each node (indexed by y * width + x)
+		detail::PathSearchSpace searchSpace;
+
+		// The jump point search visits the same tiles many times, so the map is only queried once per tile and search
+		// The flags of a tile are only valid if its generation is the current one (The lists are allocated by the first jump point search)
+		mutable std::vector<unsigned char> tileFlagList;
+		mutable std::vector<unsigned int> tileFlagGenerationList;
+		unsigned int tileFlagGeneration;
+		// The number of steps to the next jump point in each straight direction or 0 if there is none
+		mutable std::vector<std::uint16_t> straightJumpDistanceList;
 
-		// Keeps track of the nodes that have already been created
-		detail::AStarNode::Ptr * nodeMap;
-		const unsigned int nodeMapLength;
+		const size_t width;
+		const size_t height;
+		const size_t nodeCount;
+		size_t expandedNodeCount;
 
 		const TTileMap & map;
+		const TileConnectivity<TTileMap> * connectivity;
 	};
 
 
 #pragma region Template Implementation
 
-	template <class TTileMap>
-	AStarPathfinder<TTileMap>::AStarPathfinder(const TTileMap & tileMap) :
-		nodeMapLength(tileMap.GetSize().x * tileMap.GetSize().y),
-		map(tileMap)
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	AStarPathfinder<TTileMap, defaultSearchMode>::AStarPathfinder(const TTileMap & tileMap) :
+		searchSpace(tileMap.GetSize().x * tileMap.GetSize().y),
+		tileFlagGeneration(0u),
+		width(tileMap.GetSize().x),
+		height(tileMap.GetSize().y),
+		nodeCount(tileMap.GetSize().x * tileMap.GetSize().y),
+		expandedNodeCount(0),
+		map(tileMap),
+		connectivity(nullptr)
 	{
-		//nodeMap = std::make_unique<NodeMap[]>(map.GetSize().x * map.GetSize().y);
-		nodeMap = new detail::AStarNode::Ptr[nodeMapLength];
 	}
 
-	template<class TTileMap>
-	inline AStarPathfinder<TTileMap>::~AStarPathfinder()
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	std::vector<typename AStarPathfinder<TTileMap, defaultSearchMode>::Position> AStarPathfinder<TTileMap, defaultSearchMode>::FindPath(Position startPos, Position endPos, PathSearchMode searchMode)
 	{
-		delete[] nodeMap;
+		std::vector<Position> path;
+		FindPath(startPos, endPos, path, searchMode);
+		return path;
 	}
 
-	template <class TTileMap>
-	std::vector<detail::AStarNode::Ptr> AStarPathfinder<TTileMap>::GetNeighbours(Position nodePosition)
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	bool AStarPathfinder<TTileMap, defaultSearchMode>::FindPath(Position startPos, Position endPos, std::vector<Position> & path, PathSearchMode searchMode)
 	{
-		// Check whether the tile is in bound
-		assert(nodePosition.x >= 0 && nodePosition.x < map.GetSize().x && nodePosition.y >= 0 && nodePosition.y< map.GetSize().y && "AStartPathfinder: The tile lies outside the map");
+		// Check whether the tiles are in bound
+		assert(startPos.x >= 0 && static_cast<size_t>(startPos.x) < width && startPos.y >= 0 && GetNodeIndex(startPos) < nodeCount && "AStartPathfinder: The start tile lies outside the map");
+		assert(endPos.x >= 0 && static_cast<size_t>(endPos.x) < width && endPos.y >= 0 && GetNodeIndex(endPos) < nodeCount && "AStartPathfinder: The end tile lies outside the map");
 
-		// Doesn't work because of mutex
-		//std::vector<Position> neighbourPositions = std::move(map.GetReachableTiles(nodePosition));
-		auto neighbourPositions = map.GetReachableTiles(nodePosition);
-		std::vector<detail::AStarNode::Ptr> neighbours;
+		searchSpace.Reset();
+		expandedNodeCount = 0;
+		path.clear();
 
-		for (const auto & neighbourPosition : neighbourPositions)
+		if (connectivity != nullptr && connectivity->IsReachable(startPos, endPos) == false)
+			return false;
+
+		if (searchMode == PathSearchMode::JumpPointSearch)
 		{
-			detail::AStarNode::Ptr nodePtr;
-			// If this node has not been created yet
-			if (DoesNodeExist(neighbourPosition) == false)
+			if (tileFlagGenerationList.size() != nodeCount)
 			{
-				// Create it
-				nodePtr = std::make_shared<detail::AStarNode>(neighbourPosition);
-				SetNode(nodePtr);
+				assert(width <= std::numeric_limits<std::uint16_t>::max() && height <= std::numeric_limits<std::uint16_t>::max() && "AStartPathfinder: The map is too large for the jump point search");
+				tileFlagList.resize(nodeCount);
+				tileFlagGenerationList.assign(nodeCount, 0u);
+				straightJumpDistanceList.resize(4 * nodeCount);
 			}
-			else
+
+			// When the generation wraps around, tiles of the generation that is now reused would appear to be cached
+			if (++tileFlagGeneration == 0u)
 			{
-				// Return the existing node
-				nodePtr = GetNode(neighbourPosition);
+				std::fill(tileFlagGenerationList.begin(), tileFlagGenerationList.end(), 0u);
+				tileFlagGeneration = 1u;
 			}
-
-			neighbours.emplace_back(nodePtr);
 		}
 
-		return neighbours;
-	}
-
-	template <class TTileMap>
-	std::vector<typename AStarPathfinder<TTileMap>::Position> AStarPathfinder<TTileMap>::FindPath(Position startPos, Position endPos)
-	{
-		Reset();
-
-		// Create the start node
-		auto startNode = std::make_shared<detail::AStarNode>(startPos);
-		startNode->g = 0;
-		startNode->h = startNode->DistanceTo(endPos);
-
-
-		startNode->open = true;
-		openList.push(startNode);
+		const size_t startIndex = GetNodeIndex(startPos);
+		const size_t endIndex = GetNodeIndex(endPos);
 
+		searchSpace.Relax(startIndex, 0.f, detail::PathStepDistance(startPos, endPos), detail::INVALID_NODE_INDEX);
 
-		while (!openList.empty())
+		while (searchSpace.HasOpenNodes())
 		{
-			// Get the most promising node from the openList (The current node is kept alive)
-			auto currentNode = openList.top();
-			currentNode->open = false;
-			// Current node can be popped since it is the last item in the vector through the sort
-			openList.pop();
-
-			// Add the currentNode to the closed list in order to prevent cycles
-			currentNode->closed = true;
-			closedList.push_back(currentNode);
+			// Get the most promising node from the openList
+			// It is added to the closed list in order to prevent cycles
+			const size_t currentIndex = searchSpace.PopOpenNode();
 
 			// End condition
-			if (currentNode->position == endPos)
+			if (currentIndex == endIndex)
 			{
 				// FOUND! Return the path
-				std::vector<Position> path;
-
-				while (currentNode != nullptr)
+				for (size_t nodeIndex = currentIndex; nodeIndex != detail::INVALID_NODE_INDEX; nodeIndex = searchSpace.GetParent(nodeIndex))
 				{
-					path.push_back(currentNode->position);
-					currentNode = currentNode->previousNode.lock();
+					path.push_back(GetNodePosition(nodeIndex));
+
+					// Consecutive jump points are connected by a straight or diagonal line
+					const size_t parentIndex = searchSpace.GetParent(nodeIndex);
+					if (searchMode != PathSearchMode::JumpPointSearch || parentIndex == detail::INVALID_NODE_INDEX)
+						continue;
+
+					const Position parentPosition = GetNodePosition(parentIndex);
+					const int directionX = (parentPosition.x > path.back().x) - (parentPosition.x < path.back().x);
+					const int directionY = (parentPosition.y > path.back().y) - (parentPosition.y < path.back().y);
+					for (Position position(path.back().x + directionX, path.back().y + directionY); position != parentPosition; position = Position(position.x + directionX, position.y + directionY))
+						path.push_back(position);
 				}
 
 				// Reverse the path
 				std::reverse(path.begin(), path.end());
-				return path;
+				return true;
 			}
 
-			this->ExpandNode(currentNode, endPos);
+			if (searchMode == PathSearchMode::JumpPointSearch)
+				this->ExpandJumpPoint(currentIndex, endPos);
+			else
+				this->ExpandNode(currentIndex, endPos);
 		}
 
 		// No Path has been found, return an emtpy list
-		return std::vector<Position>();
+		return false;
 	}
 
-	template <class TTileMap>
-	void AStarPathfinder<TTileMap>::Reset()
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	void AStarPathfinder<TTileMap, defaultSearchMode>::ExpandNode(size_t nodeIndex, Position endPosition)
 	{
-		while (!openList.empty())
-			openList.pop();
+		expandedNodeCount++;
+
+		const Position nodePosition = GetNodePosition(nodeIndex);
+		for (const auto & succeedingPosition : detail::GetReachableTileList(map, nodePosition))
+		{
+			const size_t succeedingIndex = GetNodeIndex(succeedingPosition);
+
+			// If the succeeding node is already on the closed list, continue
+			if (searchSpace.IsClosed(succeedingIndex))
+				continue;
 
-		closedList.clear();
+			// The movement cost to that node --> maybe add something more fancy later on
+			auto edgeValue = map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y);
 
-		//std::fill(std::begin(nodeMap), std::end(nodeMap), nullptr);
+			// Calculate the cost for the new route: g value of the previous node + cost for edge / movement cost to the current node
+			auto tentativeG = searchSpace.GetG(nodeIndex) + edgeValue;
 
-		for (size_t i = 0; i < nodeMapLength; i++)
-			nodeMap[i].reset();
+			// Opens the succeeding node or updates it if the new route is better than the existing one
+			searchSpace.Relax(succeedingIndex, tentativeG, detail::PathStepDistance(succeedingPosition, endPosition), nodeIndex, detail::PathDistance(succeedingPosition, endPosition));
+		}
 	}
 
-	template <class TTileMap>
-	void AStarPathfinder<TTileMap>::ExpandNode(detail::AStarNode::Ptr currentNode, Position endPosition)
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	void AStarPathfinder<TTileMap, defaultSearchMode>::ExpandJumpPoint(size_t nodeIndex, Position endPosition)
 	{
-		for (const auto & succeedingNode : this->GetNeighbours(currentNode->position))
+		expandedNodeCount++;
+
+		const Position position = GetNodePosition(nodeIndex);
+		const size_t parentIndex = searchSpace.GetParent(nodeIndex);
+
+		// Without a parent or next to tiles with a different cost, all directions are searched
+		if (parentIndex == detail::INVALID_NODE_INDEX || HasUniformNeighbourhood(position) == false)
 		{
-			// If the succeeding node is already on the closed list, continue
-			if (succeedingNode->closed)
-				continue;
+			for (int directionY = -1; directionY <= 1; directionY++)
+			{
+				for (int directionX = -1; directionX <= 1; directionX++)
+				{
+					if (directionX != 0 || directionY != 0)
+						AddJumpPoint(nodeIndex, position, directionX, directionY, endPosition);
+				}
+			}
+			return;
+		}
 
-			// The movement cost to that node --> maybe add something more fancy later on
-			auto edgeValue = map.GetTileMovementSpeed(succeedingNode->position.x, succeedingNode->position.y);
+		// Otherwise, only the natural and forced neighbours in the direction of travel are searched
+		const Position parentPosition = GetNodePosition(parentIndex);
+		const int directionX = (position.x > parentPosition.x) - (position.x < parentPosition.x);
+		const int directionY = (position.y > parentPosition.y) - (position.y < parentPosition.y);
 
-			// Calculate the cost for the new route: g value of the previous node + cost for edge / movement cost to the current node
-			auto tentativeG = currentNode->g + edgeValue;
+		if (directionX != 0 && directionY != 0)
+		{
+			const bool walkableX = IsWalkable(position.x + directionX, position.y);
+			const bool walkableY = IsWalkable(position.x, position.y + directionY);
+			if (walkableY)
+				AddJumpPoint(nodeIndex, position, 0, directionY, endPosition);
+			if (walkableX)
+				AddJumpPoint(nodeIndex, position, directionX, 0, endPosition);
+			if (walkableX && walkableY)
+				AddJumpPoint(nodeIndex, position, directionX, directionY, endPosition);
+		}
+		else if (directionX != 0)
+		{
+			const bool walkableUp = IsWalkable(position.x, position.y - 1);
+			const bool walkableDown = IsWalkable(position.x, position.y + 1);
+			if (IsWalkable(position.x + directionX, position.y))
+			{
+				AddJumpPoint(nodeIndex, position, directionX, 0, endPosition);
+				if (walkableUp)
+					AddJumpPoint(nodeIndex, position, directionX, -1, endPosition);
+				if (walkableDown)
+					AddJumpPoint(nodeIndex, position, directionX, 1, endPosition);
+			}
+			if (walkableUp)
+				AddJumpPoint(nodeIndex, position, 0, -1, endPosition);
+			if (walkableDown)
+				AddJumpPoint(nodeIndex, position, 0, 1, endPosition);
+		}
+		else
+		{
+			const bool walkableLeft = IsWalkable(position.x - 1, position.y);
+			const bool walkableRight = IsWalkable(position.x + 1, position.y);
+			if (IsWalkable(position.x, position.y + directionY))
+			{
+				AddJumpPoint(nodeIndex, position, 0, directionY, endPosition);
+				if (walkableLeft)
+					AddJumpPoint(nodeIndex, position, -1, directionY, endPosition);
+				if (walkableRight)
+					AddJumpPoint(nodeIndex, position, 1, directionY, endPosition);
+			}
+			if (walkableLeft)
+				AddJumpPoint(nodeIndex, position, -1, 0, endPosition);
+			if (walkableRight)
+				AddJumpPoint(nodeIndex, position, 1, 0, endPosition);
+		}
+	}
 
-			// If the succeding node is already on the open list but the new route isn't better that the existing one, do nothing
-			if (succeedingNode->open && tentativeG >= succeedingNode->g)
-				continue;
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	void AStarPathfinder<TTileMap, defaultSearchMode>::AddJumpPoint(size_t nodeIndex, Position position, int directionX, int directionY, Position endPosition)
+	{
+		unsigned int stepCount;
+		const size_t jumpPointIndex = Jump(position, directionX, directionY, endPosition, stepCount);
+		if (jumpPointIndex == detail::INVALID_NODE_INDEX || searchSpace.IsClosed(jumpPointIndex))
+			return;
+
+		// All tiles on the way have the same movement cost as the first one
+		const Position jumpPosition = GetNodePosition(jumpPointIndex);
+		const float stepCost = map.GetTileMovementSpeed(position.x + directionX, position.y + directionY);
+		searchSpace.Relax(jumpPointIndex, searchSpace.GetG(nodeIndex) + stepCount * stepCost, detail::PathStepDistance(jumpPosition, endPosition), nodeIndex, detail::PathDistance(jumpPosition, endPosition));
+	}
+
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	size_t AStarPathfinder<TTileMap, defaultSearchMode>::Jump(Position position, int directionX, int directionY, Position endPosition, unsigned int & stepCount) const
+	{
+		if (directionX == 0 || directionY == 0)
+			return JumpStraight(position, directionX, directionY, endPosition, stepCount);
+
+		stepCount = 0;
+		while (true)
+		{
+			if (CanMove(position, directionX, directionY) == false)
+				return detail::INVALID_NODE_INDEX;
+
+			position = Position(position.x + directionX, position.y + directionY);
+			stepCount++;
+
+			// The goal and tiles next to tiles with a different cost are always jump points
+			if (position == endPosition || HasUniformNeighbourhood(position) == false)
+				return GetNodeIndex(position);
+
+			// When moving diagonally, this is a jump point if one of the straight jumps finds a jump point
+			unsigned int straightStepCount;
+			if (JumpStraight(position, directionX, 0, endPosition, straightStepCount) != detail::INVALID_NODE_INDEX
+				|| JumpStraight(position, 0, directionY, endPosition, straightStepCount) != detail::INVALID_NODE_INDEX)
+				return GetNodeIndex(position);
+		}
+	}
+
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	size_t AStarPathfinder<TTileMap, defaultSearchMode>::JumpStraight(Position position, int directionX, int directionY, Position endPosition, unsigned int & stepCount) const
+	{
+		const unsigned int directionIndex = directionX > 0 ? 0u : (directionX < 0 ? 1u : (directionY > 0 ? 2u : 3u));
+		const unsigned char knownFlag = static_cast<unsigned char>(StraightJumpKnown << directionIndex);
+
+		// Step until reaching a jump point, a tile that can not be left in the direction or a tile whose result is known
+		// The result of the tiles from which a step has been made is not known yet
+		Position current = position;
+		unsigned int scannedTileCount = 0;
+		bool found = false;
+		stepCount = 0;
+		while (true)
+		{
+			const size_t currentIndex = GetNodeIndex(current);
+			if ((GetTileFlags(currentIndex) & knownFlag) != 0)
+			{
+				const auto distance = straightJumpDistanceList[4 * currentIndex + directionIndex];
+				found = distance != 0;
+				stepCount = scannedTileCount + distance;
+				break;
+			}
+
+			if (CanMove(current, directionX, directionY) == false)
+			{
+				scannedTileCount++;
+				break;
+			}
 
-			// If not -> Set the previous node field and store the g value as the new best value
-			succeedingNode->g = tentativeG;
-			succeedingNode->previousNode = currentNode;
-			succeedingNode->h = succeedingNode->DistanceTo(endPosition);
+			current = Position(current.x + directionX, current.y + directionY);
+			scannedTileCount++;
 
-			// If the succeeding node isn't on the openList yet, add it to the open list
-			if (!succeedingNode->open)
+			// The goal and tiles next to tiles with a different cost are always jump points
+			// Otherwise, it is a jump point if it has forced neighbours, i.e. a tile to the side can not be reached diagonally from the previous tile
+			const bool forced = directionX != 0
+				? (IsWalkable(current.x, current.y - 1) && IsWalkable(current.x - directionX, current.y - 1) == false)
+					|| (IsWalkable(current.x, current.y + 1) && IsWalkable(current.x - directionX, current.y + 1) == false)
+				: (IsWalkable(current.x - 1, current.y) && IsWalkable(current.x - 1, current.y - directionY) == false)
+					|| (IsWalkable(current.x + 1, current.y) && IsWalkable(current.x + 1, current.y - directionY) == false);
+
+			if (current == endPosition || HasUniformNeighbourhood(current) == false || forced)
 			{
-				succeedingNode->open = true;
-				openList.push(succeedingNode);
+				found = true;
+				stepCount = scannedTileCount;
+				break;
 			}
 		}
+
+		// Cache the result for the scanned tiles
+		Position scannedPosition = position;
+		for (unsigned int i = 0; i < scannedTileCount; i++)
+		{
+			const size_t scannedIndex = GetNodeIndex(scannedPosition);
+			GetTileFlags(scannedIndex) |= knownFlag;
+			straightJumpDistanceList[4 * scannedIndex + directionIndex] = static_cast<std::uint16_t>(found ? stepCount - i : 0u);
+			scannedPosition = Position(scannedPosition.x + directionX, scannedPosition.y + directionY);
+		}
+
+		if (found == false)
+			return detail::INVALID_NODE_INDEX;
+
+		return GetNodeIndex(Position(position.x + directionX * static_cast<int>(stepCount), position.y + directionY * static_cast<int>(stepCount)));
+	}
+
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	inline bool AStarPathfinder<TTileMap, defaultSearchMode>::IsWalkable(long long x, long long y) const
+	{
+		if (x < 0 || y < 0 || static_cast<size_t>(x) >= width || static_cast<size_t>(y) >= height)
+			return false;
+
+		auto & flags = GetTileFlags(static_cast<size_t>(y) * width + static_cast<size_t>(x));
+		if ((flags & WalkableKnown) == 0)
+			flags |= WalkableKnown | (map.IsTileWalkable(static_cast<int>(x), static_cast<int>(y)) ? Walkable : 0);
+
+		return (flags & Walkable) != 0;
+	}
+
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	inline bool AStarPathfinder<TTileMap, defaultSearchMode>::CanMove(Position position, int directionX, int directionY) const
+	{
+		// Diagonal moves must not cut corners
+		return IsWalkable(position.x + directionX, position.y + directionY)
+			&& (directionX == 0 || directionY == 0 || (IsWalkable(position.x + directionX, position.y) && IsWalkable(position.x, position.y + directionY)));
 	}
 
-	template<class TTileMap>
-	inline bool AStarPathfinder<TTileMap>::DoesNodeExist(Position pos) const
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	bool AStarPathfinder<TTileMap, defaultSearchMode>::HasUniformNeighbourhood(Position position) const
 	{
-		// Access using the formula: y * width + x
-		return nodeMap[pos.y * map.GetSize().x + pos.x] != nullptr;
+		auto & flags = GetTileFlags(GetNodeIndex(position));
+		if ((flags & UniformNeighbourhoodKnown) != 0)
+			return (flags & UniformNeighbourhood) != 0;
+
+		bool uniform = true;
+		const float movementSpeed = map.GetTileMovementSpeed(position.x, position.y);
+		for (int offsetY = -1; offsetY <= 1 && uniform; offsetY++)
+		{
+			for (int offsetX = -1; offsetX <= 1 && uniform; offsetX++)
+			{
+				if (IsWalkable(position.x + offsetX, position.y + offsetY) && map.GetTileMovementSpeed(position.x + offsetX, position.y + offsetY) != movementSpeed)
+					uniform = false;
+			}
+		}
+
+		flags |= UniformNeighbourhoodKnown | (uniform ? UniformNeighbourhood : 0);
+		return uniform;
 	}
 
-	template<class TTileMap>
-	inline void AStarPathfinder<TTileMap>::SetNode(detail::AStarNode::Ptr node)
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	inline unsigned char & AStarPathfinder<TTileMap, defaultSearchMode>::GetTileFlags(size_t nodeIndex) const
 	{
-		// Access using the formula: y * width + x
-		nodeMap[node->position.y * map.GetSize().x + node->position.x] = node;
+		if (tileFlagGenerationList[nodeIndex] != tileFlagGeneration)
+		{
+			tileFlagGenerationList[nodeIndex] = tileFlagGeneration;
+			tileFlagList[nodeIndex] = 0;
+		}
+
+		return tileFlagList[nodeIndex];
 	}
 
-	template<class TTileMap>
-	inline detail::AStarNode::Ptr AStarPathfinder<TTileMap>::GetNode(Position pos) const
+	template <class TTileMap, PathSearchMode defaultSearchMode>
+	inline typename AStarPathfinder<TTileMap, defaultSearchMode>::Position AStarPathfinder<TTileMap, defaultSearchMode>::GetNodePosition(size_t nodeIndex) const
 	{
-		// Access using the formula: y * width + x
-		return nodeMap[pos.y * map.GetSize().x + pos.x];
+		Position position;
+		position.x = static_cast<decltype(position.x)>(nodeIndex % width);
+		position.y = static_cast<decltype(position.y)>(nodeIndex / width);
+		return position;
 	}
 
 #pragma endregion
 
 } // namespace mbe
-
@@ -36,6 +36,9 @@ namespace mbe
 		static void TryLoad(TAsserHolder& assetHolder, const std::string& filePath, const std::string& fileName);
 
 		// Overload for mbe::TextureWrapperHolder
+		// Textures declared using the @= (or *@= to create a pixel mask) operator are packed into a mbe::TextureAtlas
+		// The packed layout is cached in a file next to the register file (fileName + ".atlas") so that it is only packed again when the images change
+		// Tile sets must not be packed since the tiled render components use the entire texture
 		template<>
 		static void Load(TextureWrapperHolder<>& assetHolder, const std::string& filePath, const std::string& fileName);
 
@@ -139,6 +142,16 @@ namespace mbe
 		const auto& lineTokens = pair.first;
 		const auto& folder = pair.second;
 
+		// The textures that are packed into the texture atlas are loaded once all images have been added
+		struct AtlasDeclaration
+		{
+			std::string assetId;
+			std::string filePath;
+			bool createPixelMask;
+		};
+		std::vector<AtlasDeclaration> atlasDeclarationList;
+		TextureAtlas textureAtlas;
+
 		std::string currentSubFolder = "";
 		for (const auto& tokensPair : lineTokens)
 		{
@@ -179,12 +192,24 @@ namespace mbe
 					assetHolder.Load(assetId, filePath + folder + currentSubFolder + fileString, false);
 				else if (op == "*=")
 					assetHolder.Load(assetId, filePath + folder + currentSubFolder + fileString, true);
+				else if (op == "@=" || op == "*@=")
+				{
+					atlasDeclarationList.push_back({ assetId, filePath + folder + currentSubFolder + fileString, op == "*@=" });
+					textureAtlas.AddImage(atlasDeclarationList.back().filePath);
+				}
 				else
 					throw ParseError(MBE_NAME_OF(AssetLoader), "Invalid operator", lineNumber);
 			}
 			else
 				throw ParseError(MBE_NAME_OF(AssetLoader), "Invalid declaration", lineNumber);
 		}
+
+		if (atlasDeclarationList.empty())
+			return;
+
+		textureAtlas.Pack(filePath + fileName + ".atlas");
+		for (const auto& atlasDeclaration : atlasDeclarationList)
+			assetHolder.Load(atlasDeclaration.assetId, atlasDeclaration.filePath, textureAtlas, atlasDeclaration.createPixelMask);
 	}
 
 	template<>
@@ -87,6 +87,12 @@ namespace mbe
 		template<class TComponent>
 		static TypeID GetTypeID();
 
+	protected:
+		/// @brief Called after the parent entity has been attached to or detached from another entity
+		/// @details Components that cache values depending on the entity hierarchy (e.g. the mbe::TransformComponent) can override this.
+		/// The default implementation does nothing.
+		virtual void OnParentEntityChanged();
+
 	protected:
 		EventManager& eventManager;
 		Entity& parentEntity;
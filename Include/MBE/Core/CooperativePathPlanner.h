@@ -0,0 +1,523 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::CooperativePathPlanner
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <MBE/Core/ReservationTable.h>
+#include <MBE/Core/CooperativePathfinder.h>
+#include <MBE/Core/FlowFieldCache.h>
+#include <MBE/Core/TileConnectivity.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Core/EntityRemovedEvent.h>
+#include <MBE/Map/PathFoundEvent.h>
+#include <MBE/Map/GoalInaccessibleEvent.h>
+#include <MBE/Map/GoalReachedEvent.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The maximum number of times an agent plans again during an update to make way for agents that are stuck
+		/// @details After that, the agent plans again in the next update instead, unless it would run into a stuck agent at the next time step.
+		constexpr unsigned int MAX_COOPERATIVE_GIVE_WAY_COUNT = 4u;
+
+		/// @brief The maximum number of times the paths are planned during an update
+		/// @details The paths are planned again if the event callbacks request new paths, so that entities that keep requesting paths
+		/// to goals they can not reach do not block the update. The remaining requests are planned in the next update.
+		constexpr unsigned int MAX_COOPERATIVE_PLANNING_PASS_COUNT = 4u;
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Plans the paths of many entities so that they do not run into each other
+	/// @details Unlike the paths found by the mbe::PathRequestService, which only avoid static obstacles, the paths of all agents
+	/// are planned together using a mbe::CooperativePathfinder and a shared mbe::ReservationTable. Agents wait or step aside
+	/// instead of colliding and having to find a new path, which mainly helps in corridors and doorways.
+	/// @n The agents move in lockstep: every agent moves by at most one tile per time step. The game advances the time by calling AdvanceTime()
+	/// once the agents have moved to the next tile of their path and then calls Update(). GetPosition() returns where an agent should be.
+	/// @n Update() raises the following events, which an mbe::AITask can react to like to the results of the mbe::PathRequestService:
+	/// @n - A mbe::event::PathFoundEvent whenever the path of an agent has been planned. The path starts at the current tile of the agent
+	/// and covers the next window size time steps. Waiting is represented by the same tile appearing several times.
+	/// @n - A mbe::event::GoalReachedEvent when an agent has arrived at its goal. It is then removed from the planner,
+	/// so it no longer blocks the other agents.
+	/// @n - A mbe::event::GoalInaccessibleEvent if the goal can not be reached. The agent is removed as well.
+	/// @n The paths are planned again every replan interval time steps. The agent that plans first gets the best path,
+	/// so the order of the agents is rotated every time to avoid that the same agents always have to give way.
+	/// If an agent is surrounded and has to stop, the agents that planned to move onto its tile plan again during the same update
+	/// or, if they have already given way too often, in the next one.
+	/// @n An entity can only have one request at a time. Requesting a new goal or removing the entity cancels the previous request.
+	/// Paths that are requested while the events are raised (e.g. to go back once the goal has been reached) are planned during the same update,
+	/// since the agents that have already planned might move onto the start tile at the next time step.
+	/// @tparam TTileMap The type of tile map the pathfinding is performed on. It has the same requirements as for the mbe::FlowField
+	/// and its position type must be sf::Vector2i (like mbe::TileMapBase::Position).
+	template <class TTileMap>
+	class CooperativePathPlanner : private sf::NonCopyable
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+		typedef ReservationTable::Time Time;
+
+		static_assert(std::is_same<Position, event::PathFoundEvent::Path::value_type>::value, "CooperativePathPlanner: The position type must be sf::Vector2i");
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap The tile map on which the pathfinding is performed. Its size must not change.
+		/// @param eventManager The event manager through which the results are delivered
+		/// @param windowSize The number of time steps that are planned ahead. The paths are planned again after half of the window.
+		CooperativePathPlanner(const TTileMap & tileMap, EventManager & eventManager, unsigned int windowSize = detail::DEFAULT_COOPERATIVE_WINDOW_SIZE);
+
+		/// @brief Destructor
+		/// @details Unsubscribes from the mbe::event::EntityRemovedEvent
+		~CooperativePathPlanner();
+
+	public:
+		/// @brief Requests a path for an entity
+		/// @details The path is planned by the next call to Update() or, if it is requested while Update() raises the events, by the current one.
+		/// The start tile is reserved straight away. If the entity has already requested a path, the previous request is cancelled.
+		/// @param entityId The entity for which the events are raised
+		/// @param start The tile the entity is on at the current time step
+		/// @param goal The goal position
+		void Request(Entity::ID entityId, Position start, Position goal);
+
+		/// @brief Cancels the request of an entity
+		/// @details Its reservations are removed, so the other agents may move through it. Nothing happens if the entity has no request.
+		void Cancel(Entity::ID entityId);
+
+		/// @brief Plans the paths that need to be planned at the current time step and raises the events
+		/// @details This must be called after requesting paths and after every call to AdvanceTime().
+		void Update();
+
+		/// @brief Moves on to the next time step
+		/// @details Every agent is now expected to be on the next tile of its path.
+		void AdvanceTime();
+
+		/// @brief Returns whether an entity has a request
+		inline bool HasRequest(Entity::ID entityId) const { return agentIdDictionary.find(entityId) != agentIdDictionary.cend(); }
+
+		/// @brief Returns the tile an entity is on at the current time step according to its path
+		/// @details The entity must have a request.
+		Position GetPosition(Entity::ID entityId) const;
+
+		/// @brief Plans the paths of all agents again after the walkability or movement speed of the tiles in the area has changed
+		/// @details The paths are planned by the next call to Update(). The connectivity labels (see SetConnectivity()) must be updated separately.
+		/// @param position The top left tile of the area
+		/// @param size The number of tiles in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Sets the connectivity labels that are used to reject unreachable goals without creating a flow field
+		/// @param connectivity The labels of the tile map or nullptr to not use them. They must outlive the planner.
+		inline void SetConnectivity(const TileConnectivity<TTileMap> * connectivity) { this->connectivity = connectivity; }
+
+		/// @brief Sets the number of time steps after which the paths are planned again
+		/// @details It must be greater than 0 and must not be greater than the window size of the pathfinder,
+		/// since the agents could not go on after reaching the end of their path otherwise.
+		inline void SetReplanInterval(unsigned int replanInterval);
+
+		inline unsigned int GetReplanInterval() const { return replanInterval; }
+
+		/// @brief Returns the current time step
+		inline Time GetTime() const { return currentTime; }
+
+		/// @brief Returns the number of entities that have a request
+		inline size_t GetAgentCount() const { return agentIdDictionary.size(); }
+
+		/// @brief Returns the number of paths that have been planned
+		/// @details This counts the first path of every request as well as every time a path has been planned again.
+		inline size_t GetPlannedPathCount() const { return plannedPathCount; }
+
+		/// @brief Returns the pathfinder, e.g. to change the window size or the wait cost
+		/// @details The replan interval should be adjusted when changing the window size.
+		inline CooperativePathfinder<TTileMap> & GetPathfinder() { return pathfinder; }
+
+		/// @brief Returns the flow fields that are used as the heuristic, e.g. to increase the capacity if there are many goals
+		inline FlowFieldCache<TTileMap> & GetFlowFieldCache() { return flowFieldCache; }
+
+		inline const ReservationTable & GetReservationTable() const { return reservationTable; }
+
+	private:
+		typedef ReservationTable::AgentID AgentID;
+
+		struct Agent
+		{
+			Entity::ID entityId;
+			Position goal;
+			// The tiles from the path start time onwards
+			std::vector<Position> path;
+			Time pathStartTime;
+			// Identifies the request if the entity makes a new one
+			unsigned long long requestNumber;
+			bool replan;
+			// The number of times the agent has planned again during this update to make way for agents that are stuck
+			unsigned int giveWayCount;
+			bool active;
+		};
+
+		enum class ResultType
+		{
+			PathFound,
+			GoalReached,
+			GoalInaccessible
+		};
+
+		struct Result
+		{
+			ResultType type;
+			Entity::ID entityId;
+			unsigned long long requestNumber;
+			event::PathFoundEvent::Path path;
+		};
+
+	private:
+		// Returns the tile the agent is on at the current time step
+		// After the end of its path, the agent stays on the last tile
+		inline Position GetAgentPosition(const Agent & agent) const;
+
+		// Reserves the current tile of the agent for the current and the next time step, so that the agents that plan before it can not move onto it
+		// This fails if another agent has already planned to move onto the tile at the next time step. The agent then has to move on
+		// when it plans or, if it can not, makes the other agent give way (see ReplanBlockingAgents())
+		void ReserveCurrentTile(AgentID agentId);
+
+		// Reserves the last tile of a path that ends early for the rest of the window
+		// The agents that plan to move onto it plan again. The path of the agent ends early if it is surrounded by agents that have planned before it
+		void ReplanBlockingAgents(AgentID agentId);
+
+		// Removes the agents that have arrived and plans the paths of the agents that need to plan again
+		void PlanPaths();
+
+		void RemoveAgent(AgentID agentId);
+
+		void DeliverResults();
+
+		inline size_t GetTileIndex(Position position) const { return static_cast<size_t>(position.y) * tileMap.GetSize().x + static_cast<size_t>(position.x); }
+
+	private:
+		const TTileMap & tileMap;
+		EventManager & eventManager;
+		EventManager::SubscriptionID entityRemovedSubscription;
+		const TileConnectivity<TTileMap> * connectivity;
+
+		ReservationTable reservationTable;
+		CooperativePathfinder<TTileMap> pathfinder;
+		FlowFieldCache<TTileMap> flowFieldCache;
+
+		// The agent ids are the indices into the agent list
+		std::vector<Agent> agentList;
+		std::vector<AgentID> freeAgentIdList;
+		std::unordered_map<Entity::ID, AgentID> agentIdDictionary;
+
+		Time currentTime;
+		unsigned int replanInterval;
+		// Rotates the order in which the agents plan
+		size_t priorityOffset;
+		unsigned long long nextRequestNumber;
+		size_t plannedPathCount;
+		// Whether a path has been requested since the paths were last planned
+		bool newRequest;
+
+		// Reused between updates
+		std::vector<AgentID> planList;
+		std::vector<Result> resultList;
+		std::vector<Result> deliveredResultList;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	CooperativePathPlanner<TTileMap>::CooperativePathPlanner(const TTileMap & tileMap, EventManager & eventManager, unsigned int windowSize) :
+		tileMap(tileMap),
+		eventManager(eventManager),
+		connectivity(nullptr),
+		pathfinder(tileMap, reservationTable, windowSize),
+		flowFieldCache(tileMap),
+		currentTime(0ull),
+		replanInterval(std::max(windowSize / 2u, 1u)),
+		priorityOffset(0),
+		nextRequestNumber(0ull),
+		plannedPathCount(0),
+		newRequest(false)
+	{
+		// Removed entities no longer block the others
+		std::function<void(const event::EntityRemovedEvent&)> onEntityRemovedFunction = [this](const event::EntityRemovedEvent& event)
+		{
+			Cancel(event.GetEntityID());
+		};
+
+		entityRemovedSubscription = eventManager.Subscribe(onEntityRemovedFunction);
+	}
+
+	template <class TTileMap>
+	CooperativePathPlanner<TTileMap>::~CooperativePathPlanner()
+	{
+		eventManager.UnSubscribe<event::EntityRemovedEvent>(entityRemovedSubscription);
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::Request(Entity::ID entityId, Position start, Position goal)
+	{
+		Cancel(entityId);
+
+		// Get a free agent id
+		AgentID agentId = agentList.size();
+		if (freeAgentIdList.empty())
+		{
+			agentList.emplace_back();
+		}
+		else
+		{
+			agentId = freeAgentIdList.back();
+			freeAgentIdList.pop_back();
+		}
+
+		agentList[agentId] = { entityId, goal, { start }, currentTime, nextRequestNumber++, true, 0u, true };
+		agentIdDictionary[entityId] = agentId;
+
+		// The agents that planned to move through the start tile did not know that the entity would be there
+		const size_t startIndex = GetTileIndex(start);
+		for (Time time = currentTime; time <= currentTime + pathfinder.GetWindowSize(); time++)
+		{
+			const AgentID otherAgentId = reservationTable.GetAgent(startIndex, time);
+			if (otherAgentId != ReservationTable::NO_AGENT)
+				agentList[otherAgentId].replan = true;
+		}
+
+		// The agents that plan before the entity's first path must not move onto it
+		ReserveCurrentTile(agentId);
+		newRequest = true;
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::Cancel(Entity::ID entityId)
+	{
+		const auto it = agentIdDictionary.find(entityId);
+		if (it != agentIdDictionary.end())
+			RemoveAgent(it->second);
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::Update()
+	{
+		// The event callbacks may request new paths, which are planned straight away
+		for (unsigned int pass = 0u; pass < detail::MAX_COOPERATIVE_PLANNING_PASS_COUNT && (pass == 0u || newRequest); pass++)
+		{
+			newRequest = false;
+			PlanPaths();
+			DeliverResults();
+		}
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::PlanPaths()
+	{
+		// Arrived agents no longer need a path
+		for (AgentID agentId = 0; agentId < agentList.size(); agentId++)
+		{
+			const Agent & agent = agentList[agentId];
+			if (agent.active && GetAgentPosition(agent) == agent.goal)
+			{
+				resultList.push_back({ ResultType::GoalReached, agent.entityId, agent.requestNumber, {} });
+				RemoveAgent(agentId);
+			}
+		}
+
+		// Collect the agents that plan in the order of their priority
+		planList.clear();
+		for (size_t i = 0; i < agentList.size(); i++)
+		{
+			const AgentID agentId = (i + priorityOffset) % agentList.size();
+			agentList[agentId].giveWayCount = 0u;
+			if (agentList[agentId].active && agentList[agentId].replan)
+				planList.push_back(agentId);
+		}
+
+		// Every agent that plans can stay where it is, so that the agents that plan first can not move onto it
+		for (const auto agentId : planList)
+			ReserveCurrentTile(agentId);
+
+		// Agents that have to give way are added to the plan list while it is processed
+		for (size_t i = 0; i < planList.size(); i++)
+		{
+			const AgentID agentId = planList[i];
+			Agent & agent = agentList[agentId];
+			const Position position = GetAgentPosition(agent);
+			agent.replan = false;
+			reservationTable.Release(agentId);
+
+			// The flow field does not need to be created if the goal is known to be unreachable
+			if ((connectivity != nullptr && connectivity->IsReachable(position, agent.goal) == false)
+				|| pathfinder.FindPath(agentId, position, currentTime, flowFieldCache.GetFlowField(agent.goal), agent.path) == false)
+			{
+				resultList.push_back({ ResultType::GoalInaccessible, agent.entityId, agent.requestNumber, {} });
+				RemoveAgent(agentId);
+				continue;
+			}
+
+			agent.pathStartTime = currentTime;
+			plannedPathCount++;
+			resultList.push_back({ ResultType::PathFound, agent.entityId, agent.requestNumber, agent.path });
+			ReplanBlockingAgents(agentId);
+		}
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::AdvanceTime()
+	{
+		currentTime++;
+		reservationTable.ReleaseBefore(currentTime);
+
+		const bool replanAll = currentTime % replanInterval == 0u;
+		if (replanAll)
+			priorityOffset++;
+
+		for (auto & agent : agentList)
+		{
+			// The agent has reached the end of a path that did not lead to the goal (e.g. because it was blocked in)
+			if (agent.active && (replanAll || currentTime + 1u >= agent.pathStartTime + agent.path.size()))
+				agent.replan = true;
+		}
+	}
+
+	template <class TTileMap>
+	typename CooperativePathPlanner<TTileMap>::Position CooperativePathPlanner<TTileMap>::GetPosition(Entity::ID entityId) const
+	{
+		const auto it = agentIdDictionary.find(entityId);
+		assert(it != agentIdDictionary.cend() && "CooperativePathPlanner: The entity has no request");
+		return GetAgentPosition(agentList[it->second]);
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		flowFieldCache.InvalidateTiles(position, size);
+
+		for (auto & agent : agentList)
+			agent.replan = agent.active;
+	}
+
+	template <class TTileMap>
+	inline void CooperativePathPlanner<TTileMap>::SetReplanInterval(unsigned int replanInterval)
+	{
+		assert(replanInterval > 0u && replanInterval <= pathfinder.GetWindowSize() && "CooperativePathPlanner: The replan interval must lie within the window");
+		this->replanInterval = replanInterval;
+	}
+
+	template <class TTileMap>
+	inline typename CooperativePathPlanner<TTileMap>::Position CooperativePathPlanner<TTileMap>::GetAgentPosition(const Agent & agent) const
+	{
+		const size_t pathIndex = static_cast<size_t>(std::min<Time>(currentTime - agent.pathStartTime, agent.path.size() - 1u));
+		return agent.path[pathIndex];
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::ReserveCurrentTile(AgentID agentId)
+	{
+		const size_t tileIndex = GetTileIndex(GetAgentPosition(agentList[agentId]));
+		reservationTable.Release(agentId);
+		reservationTable.Reserve(tileIndex, currentTime, agentId);
+		reservationTable.Reserve(tileIndex, currentTime + 1u, agentId);
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::ReplanBlockingAgents(AgentID agentId)
+	{
+		const Agent & agent = agentList[agentId];
+		const size_t lastTileIndex = GetTileIndex(agent.path.back());
+
+		// The pathfinder has reserved the last tile until another agent needs it
+		Time time = currentTime + agent.path.size();
+		while (time <= currentTime + pathfinder.GetWindowSize())
+		{
+			if (reservationTable.Reserve(lastTileIndex, time, agentId))
+			{
+				time++;
+				continue;
+			}
+
+			// The other agent has planned before this one. Agents that have not planned yet only reserve their current tile.
+			const AgentID otherAgentId = reservationTable.GetAgent(lastTileIndex, time);
+			Agent & otherAgent = agentList[otherAgentId];
+
+			// The number of times an agent gives way is limited, so that stuck agents can not make each other plan forever
+			// Planning in the next update is early enough, unless the other agent moves onto the tile at the next time step
+			if (otherAgent.giveWayCount >= detail::MAX_COOPERATIVE_GIVE_WAY_COUNT && time > currentTime + 1u)
+			{
+				otherAgent.replan = true;
+				time++;
+				continue;
+			}
+
+			otherAgent.replan = true;
+			otherAgent.giveWayCount++;
+			planList.push_back(otherAgentId);
+
+			// The path that has been planned during this update is replaced
+			resultList.erase(std::remove_if(resultList.begin(), resultList.end(), [&otherAgent](const Result & result)
+				{
+					return result.type == ResultType::PathFound && result.requestNumber == otherAgent.requestNumber;
+				}), resultList.end());
+
+			// The other agent can stay where it is until it has planned
+			// Its reservation of the last tile has been released, so the tile is reserved in the next iteration
+			ReserveCurrentTile(otherAgentId);
+		}
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::RemoveAgent(AgentID agentId)
+	{
+		Agent & agent = agentList[agentId];
+		reservationTable.Release(agentId);
+		agentIdDictionary.erase(agent.entityId);
+		agent.path.clear();
+		agent.active = false;
+		agent.replan = false;
+		freeAgentIdList.push_back(agentId);
+	}
+
+	template <class TTileMap>
+	void CooperativePathPlanner<TTileMap>::DeliverResults()
+	{
+		deliveredResultList.swap(resultList);
+
+		for (auto & result : deliveredResultList)
+		{
+			// The event callbacks may cancel or replace the requests whose results are delivered later
+			const auto it = agentIdDictionary.find(result.entityId);
+			if (result.type == ResultType::PathFound)
+			{
+				if (it == agentIdDictionary.end() || agentList[it->second].requestNumber != result.requestNumber)
+					continue;
+
+				event::PathFoundEvent pathFoundEvent(result.entityId, std::move(result.path));
+				eventManager.RaiseEvent(pathFoundEvent);
+			}
+			// The agent has been removed, so any agent of the entity belongs to a newer request
+			else if (it == agentIdDictionary.end())
+			{
+				if (result.type == ResultType::GoalReached)
+				{
+					event::GoalReachedEvent goalReachedEvent(result.entityId);
+					eventManager.RaiseEvent(goalReachedEvent);
+				}
+				else
+				{
+					event::GoalInaccessibleEvent goalInaccessibleEvent(result.entityId);
+					eventManager.RaiseEvent(goalInaccessibleEvent);
+				}
+			}
+		}
+		deliveredResultList.clear();
+	}
+
+#pragma endregion
+
+} // namespace mbe
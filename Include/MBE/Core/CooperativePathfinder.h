@@ -0,0 +1,308 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::CooperativePathfinder
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+#include <MBE/Core/ReservationTable.h>
+#include <MBE/Core/FlowField.h>
+#include <MBE/Map/ReachableTileList.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The default number of time steps an agent plans ahead
+		constexpr unsigned int DEFAULT_COOPERATIVE_WINDOW_SIZE = 16u;
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Finds paths that avoid the paths of other agents using windowed hierarchical cooperative a star (WHCA*)
+	/// @details The search runs in space and time. An agent moves to a reachable tile or waits on its tile in every time step
+	/// and may only do so if the move does not conflict with the reservations of the other agents in the mbe::ReservationTable.
+	/// The found path is reserved, so that the agents that plan after it avoid it.
+	/// @n Only the next window size time steps are planned. The agent should plan again before it reaches the end of its path
+	/// (see mbe::CooperativePathPlanner). The heuristic is the true distance to the goal ignoring the other agents, which is read from a
+	/// mbe::FlowField. This guides the search around static obstacles, so that mostly conflicts with other agents are searched.
+	/// @n Moving to a tile costs its movement speed like in the mbe::AStarPathfinder. Waiting costs the wait cost.
+	/// @tparam TTileMap The type of tile map. It has the same requirements as for the mbe::FlowField.
+	template <class TTileMap>
+	class CooperativePathfinder
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+		typedef ReservationTable::AgentID AgentID;
+
+		typedef ReservationTable::Time Time;
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap The tile map on which the pathfinding is performed
+		/// @param reservationTable The reservations of all agents. The found paths are added to it.
+		/// @param windowSize The number of time steps that are planned. It must be greater than 0.
+		CooperativePathfinder(const TTileMap & tileMap, ReservationTable & reservationTable, unsigned int windowSize = detail::DEFAULT_COOPERATIVE_WINDOW_SIZE);
+
+		/// @brief Default destructor
+		~CooperativePathfinder() = default;
+
+	public:
+		/// @brief Finds the path of an agent for the next time steps and reserves it
+		/// @details If the goal is reached within the window and nobody else needs the goal until the end of the window,
+		/// the path ends at the goal and the goal is reserved for the rest of the window. Otherwise, the path covers the whole window.
+		/// @n If the agent is surrounded by other agents, so that no path covers the window, the path that gets furthest
+		/// and ends on a tile that nobody else needs until the end of the window is used instead.
+		/// Otherwise, its last tile is only reserved until another agent needs it. The agent then has to plan again
+		/// before it reaches the end of its path, which is earlier.
+		/// @param agentId The agent. Its previous reservations should be released first.
+		/// @param start The tile the agent is on at the start time
+		/// @param startTime The current time step
+		/// @param flowField The flow field of the goal. It is used as the heuristic.
+		/// @param path The list the path is written to. The i-th position is the tile of the agent at startTime + i.
+		/// It is cleared if the goal can not be reached from the start.
+		/// @returns True if the goal can be reached from the start, false otherwise
+		bool FindPath(AgentID agentId, Position start, Time startTime, const FlowField<TTileMap> & flowField, std::vector<Position> & path);
+
+		/// @brief Sets the number of time steps that are planned
+		/// @details Larger windows resolve more conflicts in advance, but each search expands more nodes.
+		inline void SetWindowSize(unsigned int windowSize) { assert(windowSize > 0u && "CooperativePathfinder: The window size must be greater than 0"); this->windowSize = windowSize; }
+
+		inline unsigned int GetWindowSize() const { return windowSize; }
+
+		/// @brief Sets the cost of waiting on a tile for a time step
+		/// @details It should not be greater than the lowest movement speed, otherwise agents prefer detours over waiting.
+		inline void SetWaitCost(float waitCost) { this->waitCost = waitCost; }
+
+		inline float GetWaitCost() const { return waitCost; }
+
+		/// @brief Returns the number of nodes that have been expanded by the last search
+		inline size_t GetExpandedNodeCount() const { return expandedNodeCount; }
+
+	private:
+		// A tile at a time step
+		struct Node
+		{
+			size_t tileIndex;
+			unsigned int depth;
+			float g;
+			float h;
+			size_t parent;
+			bool closed;
+		};
+
+		struct OpenEntry
+		{
+			float f;
+			float g;
+			size_t nodeIndex;
+
+			// Lower costs first and the nodes that got further if the costs are equal
+			inline bool operator<(const OpenEntry & other) const { return f != other.f ? f > other.f : g < other.g; }
+		};
+
+	private:
+		void ExpandNode(size_t nodeIndex, AgentID agentId, Time startTime, const FlowField<TTileMap> & flowField);
+
+		// Opens the node or updates it if the new route is better
+		void Relax(size_t tileIndex, unsigned int depth, float g, float h, size_t parent);
+
+		// Returns whether no other agent needs the tile from the first time step until the end of the window
+		bool IsTileFree(size_t tileIndex, Time firstTime, Time lastTime, AgentID agentId) const;
+
+		inline unsigned long long GetNodeKey(size_t tileIndex, unsigned int depth) const { return static_cast<unsigned long long>(tileIndex) * (windowSize + 1ull) + depth; }
+
+		inline size_t GetTileIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline Position GetTilePosition(size_t tileIndex) const;
+
+	private:
+		const TTileMap & map;
+		ReservationTable & reservationTable;
+		unsigned int windowSize;
+		float waitCost;
+		size_t width;
+
+		// The search state is kept between searches so that its memory is reused
+		std::vector<Node> nodeList;
+		std::unordered_map<unsigned long long, size_t> nodeDictionary;
+		std::vector<OpenEntry> openList;
+		size_t expandedNodeCount;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	CooperativePathfinder<TTileMap>::CooperativePathfinder(const TTileMap & tileMap, ReservationTable & reservationTable, unsigned int windowSize) :
+		map(tileMap),
+		reservationTable(reservationTable),
+		waitCost(1.f),
+		width(0),
+		expandedNodeCount(0)
+	{
+		SetWindowSize(windowSize);
+	}
+
+	template <class TTileMap>
+	bool CooperativePathfinder<TTileMap>::FindPath(AgentID agentId, Position start, Time startTime, const FlowField<TTileMap> & flowField, std::vector<Position> & path)
+	{
+		path.clear();
+		nodeList.clear();
+		nodeDictionary.clear();
+		openList.clear();
+		expandedNodeCount = 0;
+		width = static_cast<size_t>(map.GetSize().x);
+
+		if (flowField.IsReachable(start) == false)
+			return false;
+
+		const size_t goalIndex = GetTileIndex(flowField.GetGoal());
+		Relax(GetTileIndex(start), 0u, 0.f, flowField.GetCost(start), std::numeric_limits<size_t>::max());
+
+		// The node that gets furthest is used if the window can not be filled
+		size_t bestNodeIndex = 0;
+		bool bestNodeFree = IsTileFree(GetTileIndex(start), startTime + 1u, startTime + windowSize, agentId);
+		while (openList.empty() == false)
+		{
+			std::pop_heap(openList.begin(), openList.end());
+			const OpenEntry entry = openList.back();
+			openList.pop_back();
+
+			// Skip the entries of nodes that have been reached on a better route since they were added
+			Node & node = nodeList[entry.nodeIndex];
+			if (node.closed || entry.g != node.g)
+				continue;
+			node.closed = true;
+			expandedNodeCount++;
+
+			// Prefer tiles on which the agent can stay until the end of the window, since it stops there
+			const Node & bestNode = nodeList[bestNodeIndex];
+			const bool isBetter = node.depth > bestNode.depth || (node.depth == bestNode.depth && node.h < bestNode.h);
+			if ((isBetter || bestNodeFree == false) && IsTileFree(node.tileIndex, startTime + node.depth + 1u, startTime + windowSize, agentId))
+			{
+				bestNodeIndex = entry.nodeIndex;
+				bestNodeFree = true;
+			}
+			else if (isBetter && bestNodeFree == false)
+			{
+				bestNodeIndex = entry.nodeIndex;
+			}
+
+			// The agent can stay at the goal
+			if (node.tileIndex == goalIndex && IsTileFree(goalIndex, startTime + node.depth + 1u, startTime + windowSize, agentId))
+			{
+				bestNodeIndex = entry.nodeIndex;
+				break;
+			}
+
+			// The nodes at the end of the window are popped in the order of their estimated cost, so the first one is the best
+			if (node.depth == windowSize)
+			{
+				bestNodeIndex = entry.nodeIndex;
+				break;
+			}
+
+			ExpandNode(entry.nodeIndex, agentId, startTime, flowField);
+		}
+
+		// Create the path by going backwards from the last node
+		for (size_t nodeIndex = bestNodeIndex; nodeIndex != std::numeric_limits<size_t>::max(); nodeIndex = nodeList[nodeIndex].parent)
+			path.push_back(GetTilePosition(nodeList[nodeIndex].tileIndex));
+		std::reverse(path.begin(), path.end());
+
+		// The start tile may already be taken by another agent if the entity has been placed onto it (e.g. by requesting a path there)
+		// The search has checked the moves onto all the other tiles, so reserving them can not fail
+		reservationTable.Reserve(GetTileIndex(path.front()), startTime, agentId);
+		for (size_t i = 1; i < path.size(); i++)
+		{
+			if (reservationTable.Reserve(GetTileIndex(path[i]), startTime + i, agentId) == false)
+				assert(false && "CooperativePathfinder: The path runs into a tile that has been reserved by another agent");
+		}
+
+		// The agent stays on its last tile until it plans again
+		// If another agent needs the tile, the agent has to move on before then, so the later time steps are not reserved
+		const size_t lastTileIndex = GetTileIndex(path.back());
+		for (Time time = startTime + path.size(); time <= startTime + windowSize; time++)
+		{
+			if (reservationTable.Reserve(lastTileIndex, time, agentId) == false)
+				break;
+		}
+
+		return true;
+	}
+
+	template <class TTileMap>
+	void CooperativePathfinder<TTileMap>::ExpandNode(size_t nodeIndex, AgentID agentId, Time startTime, const FlowField<TTileMap> & flowField)
+	{
+		// The node list may grow while the node is expanded
+		const size_t tileIndex = nodeList[nodeIndex].tileIndex;
+		const unsigned int depth = nodeList[nodeIndex].depth;
+		const float g = nodeList[nodeIndex].g;
+		const Time time = startTime + depth;
+
+		// Waiting
+		if (reservationTable.IsMoveBlocked(tileIndex, tileIndex, time, agentId) == false)
+			Relax(tileIndex, depth + 1u, g + waitCost, nodeList[nodeIndex].h, nodeIndex);
+
+		for (const auto & succeedingPosition : detail::GetReachableTileList(map, GetTilePosition(tileIndex)))
+		{
+			const size_t succeedingIndex = GetTileIndex(succeedingPosition);
+			if (reservationTable.IsMoveBlocked(tileIndex, succeedingIndex, time, agentId))
+				continue;
+
+			// The goal can not be reached from the tile
+			const float h = flowField.GetCost(succeedingPosition);
+			if (h == std::numeric_limits<float>::infinity())
+				continue;
+
+			Relax(succeedingIndex, depth + 1u, g + map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y), h, nodeIndex);
+		}
+	}
+
+	template <class TTileMap>
+	void CooperativePathfinder<TTileMap>::Relax(size_t tileIndex, unsigned int depth, float g, float h, size_t parent)
+	{
+		const auto result = nodeDictionary.emplace(GetNodeKey(tileIndex, depth), nodeList.size());
+		if (result.second)
+		{
+			nodeList.push_back({ tileIndex, depth, g, h, parent, false });
+		}
+		else
+		{
+			Node & node = nodeList[result.first->second];
+			if (node.closed || node.g <= g)
+				return;
+
+			node.g = g;
+			node.parent = parent;
+		}
+
+		openList.push_back({ g + h, g, result.first->second });
+		std::push_heap(openList.begin(), openList.end());
+	}
+
+	template <class TTileMap>
+	bool CooperativePathfinder<TTileMap>::IsTileFree(size_t tileIndex, Time firstTime, Time lastTime, AgentID agentId) const
+	{
+		for (Time time = firstTime; time <= lastTime; time++)
+		{
+			if (reservationTable.IsReserved(tileIndex, time, agentId))
+				return false;
+		}
+		return true;
+	}
+
+	template <class TTileMap>
+	inline typename CooperativePathfinder<TTileMap>::Position CooperativePathfinder<TTileMap>::GetTilePosition(size_t tileIndex) const
+	{
+		return Position(static_cast<int>(tileIndex % width), static_cast<int>(tileIndex / width));
+	}
+
+#pragma endregion
+
+} // namespace mbe
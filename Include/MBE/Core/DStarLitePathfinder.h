@@ -0,0 +1,399 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::DStarLitePathfinder
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/IndexedHeap.h>
+#include <MBE/Core/PathSearchSpace.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/ReachableTileList.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+namespace mbe
+{
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Incremental pathfinding (D* Lite) for an agent that moves towards a fixed goal while tiles change
+	/// @details The search runs backwards from the goal and keeps the cost to the goal of every tile it has visited.
+	/// When tiles change, InvalidateTiles() must be called. The next query then only repairs the tiles whose cost
+	/// has become inconsistent instead of searching from scratch. Moving the start (the agent following its path)
+	/// does not invalidate the search either.
+	/// If an event manager is passed to the constructor, the changed tiles are taken from the mbe::event::TileMapChangedEvent instead.
+	/// @n A query for a different goal starts a new search. Each agent should therefore use its own pathfinder.
+	/// @n The found paths are as short as the paths found by the mbe::AStarPathfinder, as long as every tile has a movement speed of at least 1.
+	/// @n The size of the tile map is read in the constructor. The memory for the search state is allocated once.
+	/// @tparam TTileMap The type of tile map the pathfinding is performed on. It has the same requirements as for the mbe::AStarPathfinder.
+	/// In addition, a tile must be reachable from another tile if and only if the other tile is reachable from it.
+	template <class TTileMap>
+	class DStarLitePathfinder
+	{
+	public:
+		/// @brief The type of a map position
+		/// @details This will be the same as the position type the tile map is using
+		typedef typename TTileMap::Position Position;
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap A reference to the tileMap on which the pathfinding is performed
+		DStarLitePathfinder(const TTileMap & tileMap);
+
+		/// @brief Constructor
+		/// @details The pathfinder subscribes to the mbe::event::TileMapChangedEvent, so InvalidateTiles() does not have to be called.
+		/// @param tileMap A reference to the tileMap on which the pathfinding is performed
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent. It must outlive the pathfinder.
+		DStarLitePathfinder(const TTileMap & tileMap, EventManager & eventManager);
+
+		/// @brief Default destructor
+		~DStarLitePathfinder() = default;
+
+	public:
+		/// @brief Finds the best path between two points on the tileMap
+		/// @details If the goal is the same as in the last query, the previous search is repaired.
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @returns The path as a list of positions. If no path could be found, an empty list is returned
+		std::vector<Position> FindPath(Position startPos, Position endPos);
+
+		/// @brief Finds the best path between two points on the tileMap
+		/// @details If the goal is the same as in the last query, the previous search is repaired.
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @param path The list the path is written to. It is cleared if no path could be found.
+		/// @returns True if a path has been found, false otherwise
+		bool FindPath(Position startPos, Position endPos, std::vector<Position> & path);
+
+		/// @brief Records that the tiles in the area have changed
+		/// @details The search is repaired during the next query.
+		/// @param position The top left tile of the area
+		/// @param size The number of tiles in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Discards the search, so that the next query starts from scratch
+		void Reset();
+
+		/// @brief Returns the number of nodes that have been expanded by the last query
+		inline size_t GetExpandedNodeCount() const { return expandedNodeCount; }
+
+	private:
+		// The primary key is the estimated cost of a path through the node, the secondary key the cost to the goal
+		typedef std::pair<float, float> Key;
+
+		// An area of changed tiles
+		struct TileBounds
+		{
+			long long left;
+			long long top;
+			long long right;
+			long long bottom;
+		};
+
+		// Starts a new search towards the goal
+		void Initialise(Position startPos, Position endPos);
+
+		void ComputeShortestPath();
+
+		// Recomputes the rhs value of the node and updates its entry in the open list
+		void UpdateNode(size_t nodeIndex);
+
+		// Updates the nodes from which the node can be reached
+		void UpdatePredecessors(size_t nodeIndex);
+
+		inline Key CalculateKey(size_t nodeIndex) const;
+
+		inline float GetG(size_t nodeIndex) const { return IsVisited(nodeIndex) ? gList[nodeIndex] : INFINITE_COST; }
+
+		inline float GetRhs(size_t nodeIndex) const { return IsVisited(nodeIndex) ? rhsList[nodeIndex] : INFINITE_COST; }
+
+		inline bool IsVisited(size_t nodeIndex) const { return generationList[nodeIndex] == generation; }
+
+		// Marks the node as visited in the current search
+		inline void Visit(size_t nodeIndex);
+
+		inline size_t GetNodeIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline Position GetNodePosition(size_t nodeIndex) const { return Position(static_cast<int>(nodeIndex % width), static_cast<int>(nodeIndex / width)); }
+
+	private:
+		static constexpr float INFINITE_COST = std::numeric_limits<float>::infinity();
+
+		std::vector<float> gList;
+		std::vector<float> rhsList;
+		// Nodes of an older generation have not been visited in the current search
+		std::vector<unsigned int> generationList;
+		unsigned int generation;
+		IndexedHeap<Key> openList;
+
+		// The tiles that have changed since the last query
+		std::vector<TileBounds> changedTileBoundsList;
+
+		bool initialised;
+		Position startPosition;
+		Position goalPosition;
+		// Added to the keys when the start moves, so that the keys of the open nodes stay valid lower bounds
+		float keyModifier;
+
+		const size_t width;
+		const size_t height;
+		size_t expandedNodeCount;
+
+		const TTileMap & map;
+
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	DStarLitePathfinder<TTileMap>::DStarLitePathfinder(const TTileMap & tileMap) :
+		gList(tileMap.GetSize().x * tileMap.GetSize().y),
+		rhsList(tileMap.GetSize().x * tileMap.GetSize().y),
+		generationList(tileMap.GetSize().x * tileMap.GetSize().y, 0u),
+		generation(0u),
+		openList(tileMap.GetSize().x * tileMap.GetSize().y),
+		initialised(false),
+		keyModifier(0.f),
+		width(tileMap.GetSize().x),
+		height(tileMap.GetSize().y),
+		expandedNodeCount(0),
+		map(tileMap)
+	{
+	}
+
+	template <class TTileMap>
+	DStarLitePathfinder<TTileMap>::DStarLitePathfinder(const TTileMap & tileMap, EventManager & eventManager) :
+		DStarLitePathfinder(tileMap)
+	{
+		tileMapChangedSubscription.Subscribe(eventManager, *this);
+	}
+
+	template <class TTileMap>
+	std::vector<typename DStarLitePathfinder<TTileMap>::Position> DStarLitePathfinder<TTileMap>::FindPath(Position startPos, Position endPos)
+	{
+		std::vector<Position> path;
+		FindPath(startPos, endPos, path);
+		return path;
+	}
+
+	template <class TTileMap>
+	bool DStarLitePathfinder<TTileMap>::FindPath(Position startPos, Position endPos, std::vector<Position> & path)
+	{
+		// Check whether the tiles are in bound
+		assert(startPos.x >= 0 && static_cast<size_t>(startPos.x) < width && startPos.y >= 0 && static_cast<size_t>(startPos.y) < height && "DStarLitePathfinder: The start tile lies outside the map");
+		assert(endPos.x >= 0 && static_cast<size_t>(endPos.x) < width && endPos.y >= 0 && static_cast<size_t>(endPos.y) < height && "DStarLitePathfinder: The end tile lies outside the map");
+
+		expandedNodeCount = 0;
+		path.clear();
+
+		if (initialised == false || endPos != goalPosition)
+		{
+			Initialise(startPos, endPos);
+		}
+		else
+		{
+			// The keys of the open nodes were computed for the old start
+			keyModifier += detail::PathStepDistance(startPosition, startPos);
+			startPosition = startPos;
+
+			// Every node that has an edge to or past a changed tile lies in the changed area or next to it
+			for (const auto & bounds : changedTileBoundsList)
+			{
+				for (long long y = bounds.top; y <= bounds.bottom; y++)
+				{
+					for (long long x = bounds.left; x <= bounds.right; x++)
+						UpdateNode(static_cast<size_t>(y) * width + static_cast<size_t>(x));
+				}
+			}
+		}
+		changedTileBoundsList.clear();
+
+		ComputeShortestPath();
+
+		// The search stops before the start is expanded, so only its rhs value is up to date
+		size_t currentIndex = GetNodeIndex(startPos);
+		if (GetRhs(currentIndex) == INFINITE_COST)
+			return false;
+
+		// Follow the cheapest successors to the goal
+		const size_t goalIndex = GetNodeIndex(endPos);
+		path.push_back(startPos);
+		while (currentIndex != goalIndex)
+		{
+			size_t nextIndex = detail::INVALID_NODE_INDEX;
+			float nextCost = INFINITE_COST;
+			for (const auto & succeedingPosition : detail::GetReachableTileList(map, GetNodePosition(currentIndex)))
+			{
+				const size_t succeedingIndex = GetNodeIndex(succeedingPosition);
+				const float cost = map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y) + GetG(succeedingIndex);
+				if (cost < nextCost)
+				{
+					nextCost = cost;
+					nextIndex = succeedingIndex;
+				}
+			}
+
+			// The start is consistent, so this only happens if the tile map has changed without calling InvalidateTiles()
+			if (nextIndex == detail::INVALID_NODE_INDEX || path.size() > gList.size())
+			{
+				assert(false && "DStarLitePathfinder: The tile map has changed without calling InvalidateTiles()");
+				path.clear();
+				return false;
+			}
+
+			currentIndex = nextIndex;
+			path.push_back(GetNodePosition(currentIndex));
+		}
+
+		return true;
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		if (initialised == false || size.x == 0u || size.y == 0u)
+			return;
+
+		// The tiles next to the changed area may reach different tiles now, so the area is grown by one tile
+		TileBounds bounds;
+		bounds.left = std::max(static_cast<long long>(position.x) - 1, 0ll);
+		bounds.top = std::max(static_cast<long long>(position.y) - 1, 0ll);
+		bounds.right = std::min(static_cast<long long>(position.x) + size.x, static_cast<long long>(width) - 1);
+		bounds.bottom = std::min(static_cast<long long>(position.y) + size.y, static_cast<long long>(height) - 1);
+		if (bounds.left > bounds.right || bounds.top > bounds.bottom)
+			return;
+
+		changedTileBoundsList.push_back(bounds);
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::Reset()
+	{
+		initialised = false;
+		changedTileBoundsList.clear();
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::Initialise(Position startPos, Position endPos)
+	{
+		openList.Clear();
+
+		// When the generation wraps around, nodes of the generation that is now reused would appear to be visited
+		if (++generation == 0u)
+		{
+			std::fill(generationList.begin(), generationList.end(), 0u);
+			generation = 1u;
+		}
+
+		initialised = true;
+		startPosition = startPos;
+		goalPosition = endPos;
+		keyModifier = 0.f;
+
+		const size_t goalIndex = GetNodeIndex(endPos);
+		Visit(goalIndex);
+		rhsList[goalIndex] = 0.f;
+		openList.Push(goalIndex, CalculateKey(goalIndex));
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::ComputeShortestPath()
+	{
+		const size_t startIndex = GetNodeIndex(startPosition);
+
+		while (openList.IsEmpty() == false && (openList.TopKey() < CalculateKey(startIndex) || GetRhs(startIndex) > GetG(startIndex)))
+		{
+			const Key oldKey = openList.TopKey();
+			const size_t nodeIndex = openList.Top();
+			const Key newKey = CalculateKey(nodeIndex);
+			expandedNodeCount++;
+
+			// The key is outdated since the start has moved
+			if (oldKey < newKey)
+			{
+				openList.Update(nodeIndex, newKey);
+				continue;
+			}
+
+			openList.Pop();
+			if (gList[nodeIndex] > rhsList[nodeIndex])
+			{
+				// The cost has decreased
+				gList[nodeIndex] = rhsList[nodeIndex];
+				UpdatePredecessors(nodeIndex);
+			}
+			else
+			{
+				// The cost has increased, so the node and its predecessors have to be recomputed
+				gList[nodeIndex] = INFINITE_COST;
+				UpdateNode(nodeIndex);
+				UpdatePredecessors(nodeIndex);
+			}
+		}
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::UpdateNode(size_t nodeIndex)
+	{
+		Visit(nodeIndex);
+
+		if (nodeIndex != GetNodeIndex(goalPosition))
+		{
+			float rhs = INFINITE_COST;
+			for (const auto & succeedingPosition : detail::GetReachableTileList(map, GetNodePosition(nodeIndex)))
+			{
+				const float g = GetG(GetNodeIndex(succeedingPosition));
+				if (g != INFINITE_COST)
+					rhs = std::min(rhs, map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y) + g);
+			}
+			rhsList[nodeIndex] = rhs;
+		}
+
+		const bool consistent = gList[nodeIndex] == rhsList[nodeIndex];
+		if (openList.Contains(nodeIndex))
+		{
+			if (consistent)
+				openList.Remove(nodeIndex);
+			else
+				openList.Update(nodeIndex, CalculateKey(nodeIndex));
+		}
+		else if (consistent == false)
+		{
+			openList.Push(nodeIndex, CalculateKey(nodeIndex));
+		}
+	}
+
+	template <class TTileMap>
+	void DStarLitePathfinder<TTileMap>::UpdatePredecessors(size_t nodeIndex)
+	{
+		// Reachability is symmetric, so the predecessors are the reachable tiles
+		for (const auto & precedingPosition : detail::GetReachableTileList(map, GetNodePosition(nodeIndex)))
+			UpdateNode(GetNodeIndex(precedingPosition));
+	}
+
+	template <class TTileMap>
+	inline typename DStarLitePathfinder<TTileMap>::Key DStarLitePathfinder<TTileMap>::CalculateKey(size_t nodeIndex) const
+	{
+		const float cost = std::min(GetG(nodeIndex), GetRhs(nodeIndex));
+		return { cost + detail::PathStepDistance(startPosition, GetNodePosition(nodeIndex)) + keyModifier, cost };
+	}
+
+	template <class TTileMap>
+	inline void DStarLitePathfinder<TTileMap>::Visit(size_t nodeIndex)
+	{
+		if (IsVisited(nodeIndex))
+			return;
+
+		generationList[nodeIndex] = generation;
+		gList[nodeIndex] = INFINITE_COST;
+		rhsList[nodeIndex] = INFINITE_COST;
+	}
+
+#pragma endregion
+
+} // namespace mbe
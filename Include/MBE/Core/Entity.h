@@ -271,6 +271,9 @@ namespace mbe
 		// This only returns derived components
 		std::vector<detail::ComponentTypeID> GetComponentTypeIDList() const;
 
+		// Notifies all components that the parent entity has changed
+		void OnParentEntityChanged();
+
 
 	private:
 		EntityManager& entityManager;
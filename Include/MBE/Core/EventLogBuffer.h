@@ -0,0 +1,262 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::EventLogBuffer
+
+#include <vector>
+#include <unordered_set>
+#include <ostream>
+#include <istream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <typeinfo>
+#include <type_traits>
+#include <new>
+#include <SFML\System\NonCopyable.hpp>
+
+#include <MBE/Core/BaseEvent.h>
+#include <MBE/Core/EventWrapper.h>
+
+namespace mbe
+{
+	/// @brief Defines how an event is written to and read from a binary event log
+	/// @details By default, only trivially copyable events can be written to a binary log. Their memory is copied as is.
+	/// Other events (e.g. events that hold a std::string or an mbe::HandleID) must specialise this template.
+	/// A specialisation must define IsSerialisable = true as well as the static Write() and Read() functions.
+	/// @tparam TEvent The type of event that is written to the log
+	/// @note The binary log is written in the native byte order and is only meant to be read on the same platform.
+	template <class TEvent>
+	struct BinaryEventLogTraits
+	{
+		/// @brief Whether the event can be written to a binary log
+		static constexpr bool IsSerialisable = std::is_trivially_copyable<TEvent>::value;
+
+		/// @brief Writes the event to the binary stream
+		static void Write(std::ostream& stream, const TEvent& event)
+		{
+			stream.write(reinterpret_cast<const char*>(&event), sizeof(TEvent));
+		}
+
+		/// @brief Reads an event from the binary stream
+		static TEvent Read(std::istream& stream)
+		{
+			std::aligned_storage_t<sizeof(TEvent), alignof(TEvent)> storage;
+			stream.read(reinterpret_cast<char*>(&storage), sizeof(TEvent));
+			return *reinterpret_cast<const TEvent*>(&storage);
+		}
+	};
+
+	namespace detail
+	{
+		/// @brief The minimum number of characters that the time string must be in order to be used by the ctime_s() function
+		constexpr unsigned short int MIN_TIME_BUFFER_SIZE = 26;
+
+		/// @brief The identifier at the start of every binary event log file
+		constexpr char BINARY_EVENT_LOG_MAGIC[] = { 'M', 'B', 'E', 'L', 'O', 'G' };
+
+		/// @brief The version of the binary event log format
+		constexpr unsigned int BINARY_EVENT_LOG_VERSION = 1;
+
+		/// @brief The type of a record in the binary event log
+		enum class BinaryEventLogRecordType : unsigned char
+		{
+			// Maps the type id used in the log to the name of the event type
+			TypeDeclaration = 0,
+			// An event of a previously declared type
+			Event = 1
+		};
+
+		/// @brief A copy of a logged event that is formatted by the writer thread
+		/// @details Small events are stored in place. Larger ones are allocated on the heap.
+		struct EventLogRecord
+		{
+			typedef void(*WriteFunction)(const void* event, std::ostream& stream);
+			typedef void(*DestroyFunction)(void* event);
+
+			static constexpr size_t InlineStorageSize = 64;
+
+			std::chrono::system_clock::time_point time;
+			BaseEvent::TypeID typeId;
+			const char* eventName;
+			bool binary;
+			WriteFunction write;
+			DestroyFunction destroy;
+			void* eventPtr;
+			std::aligned_storage_t<InlineStorageSize> storage;
+		};
+
+		/// @brief A fixed size ring of event log records
+		struct EventLogRing
+		{
+			inline EventLogRecord& Front() { return recordList[head]; }
+			inline EventLogRecord& Back() { return recordList[(head + count - 1) % recordList.size()]; }
+			inline bool IsFull() const { return count == recordList.size(); }
+
+			std::vector<EventLogRecord> recordList;
+			size_t head = 0;
+			size_t count = 0;
+		};
+
+	} // namespace detail
+
+	/// @brief Buffers logged events and writes them to the log streams on a background thread
+	/// @details Events are copied into a fixed size ring buffer when they are pushed. The (potentially expensive) formatting
+	/// of the text and the writing to the streams is done by a writer thread. The streams are only flushed when the buffer
+	/// has been drained, so that the writer does not wait on the file system while events are still queued.
+	/// When the buffer is full, the mbe::EventLogBuffer::OverflowPolicy decides what happens to text records.
+	/// Binary records are never dropped, i.e. the binary log is lossless.
+	class EventLogBuffer : private sf::NonCopyable
+	{
+	public:
+		/// @brief Defines what happens when an event is pushed into a full buffer
+		enum class OverflowPolicy : unsigned char
+		{
+			/// @brief The pushed event is dropped
+			DropNewest,
+			/// @brief The oldest buffered event is dropped to make room for the pushed one
+			DropOldest,
+			/// @brief The pushing thread waits until the writer thread has made room
+			Block
+		};
+
+	public:
+		/// @brief Constructor
+		/// @details Starts the writer thread
+		/// @param textStream The stream to which text records are written
+		/// @param binaryStream The stream to which binary records are written. It must have been opened in binary mode.
+		/// @param capacity The maximum number of buffered events. Must be greater than 0.
+		/// @param overflowPolicy The policy applied to text records when the buffer is full
+		EventLogBuffer(std::ostream& textStream, std::ostream& binaryStream, size_t capacity = 4096, OverflowPolicy overflowPolicy = OverflowPolicy::DropNewest);
+
+		/// @brief Destructor
+		/// @details Writes all buffered events, flushes the streams and joins the writer thread
+		~EventLogBuffer();
+
+		/// @brief Copies an event into the buffer to be written to the text stream
+		/// @details The event is written using its operator<<
+		/// @tparam TEvent The type of event to log
+		/// @param event The event to log
+		template <class TEvent>
+		void PushText(const TEvent& event);
+
+		/// @brief Copies an event into the buffer to be written to the binary stream
+		/// @details The event is written using mbe::BinaryEventLogTraits. If the buffer is full, this call blocks.
+		/// @tparam TEvent The type of event to log. mbe::BinaryEventLogTraits<TEvent>::IsSerialisable must be true.
+		/// @param event The event to log
+		template <class TEvent>
+		void PushBinary(const TEvent& event);
+
+		/// @brief Returns the number of events that have been dropped due to the overflow policy
+		size_t GetDroppedCount() const;
+
+		/// @brief Sets the policy applied to text records when the buffer is full
+		void SetOverflowPolicy(OverflowPolicy overflowPolicy);
+
+	private:
+		template <class TEvent>
+		void Push(const TEvent& event, bool binary, detail::EventLogRecord::WriteFunction write);
+
+		// Applies the overflow policy and returns the record to construct the event in
+		// Returns nullptr if the event must be dropped. The lock must be held.
+		detail::EventLogRecord* AcquireRecord(std::unique_lock<std::mutex>& lock, bool binary);
+
+		void Run();
+		void WriteRecord(detail::EventLogRecord& record);
+
+	private:
+		std::ostream& textStream;
+		std::ostream& binaryStream;
+
+		detail::EventLogRing pendingRing;
+		// Only accessed by the writer thread
+		detail::EventLogRing writeRing;
+		std::unordered_set<detail::BaseEvent::TypeID> declaredTypeIdSet;
+		bool binaryHeaderWritten;
+
+		OverflowPolicy overflowPolicy;
+		size_t droppedCount;
+		size_t unreportedDroppedCount;
+		bool running;
+
+		mutable std::mutex mutex;
+		std::condition_variable recordsAvailable;
+		std::condition_variable spaceAvailable;
+		std::thread writerThread;
+	};
+
+#pragma region Template Implementations
+
+	template<class TEvent>
+	inline void EventLogBuffer::PushText(const TEvent& event)
+	{
+		Push(event, false, [](const void* eventPtr, std::ostream& stream)
+		{
+			stream << *static_cast<const TEvent*>(eventPtr);
+		});
+	}
+
+	template<class TEvent>
+	inline void EventLogBuffer::PushBinary(const TEvent& event)
+	{
+		static_assert(BinaryEventLogTraits<TEvent>::IsSerialisable, "The event type must be trivially copyable or mbe::BinaryEventLogTraits must be specialised for it");
+
+		Push(event, true, [](const void* eventPtr, std::ostream& stream)
+		{
+			BinaryEventLogTraits<TEvent>::Write(stream, *static_cast<const TEvent*>(eventPtr));
+		});
+	}
+
+	template<class TEvent>
+	inline void EventLogBuffer::Push(const TEvent& event, bool binary, detail::EventLogRecord::WriteFunction write)
+	{
+		const auto time = std::chrono::system_clock::now();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		auto* record = AcquireRecord(lock, binary);
+		if (record == nullptr)
+			return;
+
+		// Checked after acquiring the record since the writer thread may have taken the records while this thread was blocked
+		const bool wasEmpty = pendingRing.count == 1;
+
+		record->time = time;
+		record->typeId = detail::EventWrapper<TEvent>::GetTypeID();
+		record->eventName = typeid(TEvent).name();
+		record->binary = binary;
+		record->write = write;
+
+		// The record has already been counted, so it must be given back if copying the event throws
+		// Otherwise, the writer thread would call the functions of whatever event the record held before
+		try
+		{
+			// Store small events in place to avoid an allocation per logged event
+			if constexpr (sizeof(TEvent) <= detail::EventLogRecord::InlineStorageSize && alignof(TEvent) <= alignof(decltype(record->storage)))
+			{
+				record->eventPtr = new (&record->storage) TEvent(event);
+				record->destroy = [](void* eventPtr) { static_cast<TEvent*>(eventPtr)->~TEvent(); };
+			}
+			else
+			{
+				record->eventPtr = new TEvent(event);
+				record->destroy = [](void* eventPtr) { delete static_cast<TEvent*>(eventPtr); };
+			}
+		}
+		catch (...)
+		{
+			pendingRing.count--;
+			lock.unlock();
+			spaceAvailable.notify_one();
+			throw;
+		}
+
+		// The writer thread only waits when there is nothing to write
+		lock.unlock();
+		if (wasEmpty)
+			recordsAvailable.notify_one();
+	}
+
+#pragma endregion
+
+} // namespace mbe
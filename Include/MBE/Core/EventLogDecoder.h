@@ -0,0 +1,86 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::EventLogDecoder
+
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <typeinfo>
+
+#include <MBE/Core/EventLogBuffer.h>
+
+namespace mbe
+{
+	/// @brief Converts a binary event log into a readable text log
+	/// @details The binary log only stores the raw event data. In order to print the events,
+	/// the event types must be registered with the decoder. Events of unregistered types are skipped.
+	/// The decoder must be compiled on the same platform as the program that wrote the log since the event types are identified by their type name.
+	class EventLogDecoder
+	{
+	private:
+		typedef std::function<void(std::istream&, std::ostream&)> DecodeFunction;
+
+	public:
+		/// @brief Default constructor
+		EventLogDecoder() = default;
+
+		/// @brief Default destructor
+		~EventLogDecoder() = default;
+
+		/// @brief Registers an event type so that its events can be decoded
+		/// @details The event is read using mbe::BinaryEventLogTraits and printed using its operator<<
+		/// @tparam TEvent The type of event to register
+		template <class TEvent>
+		void RegisterEvent();
+
+		/// @brief Decodes a binary event log
+		/// @param input The binary stream from which the log is read
+		/// @param output The stream to which the readable log is written
+		/// @throws std::runtime_error if the input is not a valid binary event log
+		void Decode(std::istream& input, std::ostream& output) const;
+
+		/// @brief Decodes a binary event log file
+		/// @param filePath The path of the binary event log file
+		/// @param output The stream to which the readable log is written
+		/// @throws std::runtime_error if the file cannot be opened or is not a valid binary event log
+		void Decode(const std::string& filePath, std::ostream& output) const;
+
+	private:
+		// Indexed by the type name
+		std::unordered_map<std::string, DecodeFunction> decodeFunctionDictionary;
+	};
+
+#pragma region Template Implementations
+
+	template<class TEvent>
+	inline void EventLogDecoder::RegisterEvent()
+	{
+		static_assert(BinaryEventLogTraits<TEvent>::IsSerialisable, "The event type must be trivially copyable or mbe::BinaryEventLogTraits must be specialised for it");
+
+		decodeFunctionDictionary[typeid(TEvent).name()] = [](std::istream& input, std::ostream& output)
+		{
+			output << BinaryEventLogTraits<TEvent>::Read(input);
+		};
+	}
+
+#pragma endregion
+
+} // namespace mbe
+
+///////////////////////////////////////////////////////////////////////
+/// @class mbe::EventLogDecoder
+///
+/// <b>Example:</b>
+/// @code
+/// // Register all event types that have been logged to the binary file
+/// mbe::EventLogDecoder decoder;
+/// decoder.RegisterEvent<MyEvent>();
+/// decoder.RegisterEvent<MyOtherEvent>();
+///
+/// // Print the log
+/// decoder.Decode("Config/LogFile.mbelog", std::cout);
+/// @endcode
+///////////////////////////////////////////////////////////////////////
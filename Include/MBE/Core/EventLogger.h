@@ -11,21 +11,19 @@
 #include <functional>
 #include <chrono>
 #include <ctime>
+#include <cassert>
 
 #include <MBE/Core/EventManager.h>
+#include <MBE/Core/EventLogBuffer.h>
 #include <MBE/Core/EnumBitmask.h>
 
 namespace mbe
 {
-	namespace detail
-	{
-		/// @brief The minimum number of characters that the time string must be in order to be used by the ctime_s() function
-		constexpr unsigned short int MIN_TIME_BUFFER_SIZE = 26;
-	} // namespace detail
-
 	/// @brief Monitors an event manager and logs occuring events
 	/// @details Note that only one event manager is monitored. When subscribing to an event, the log function(s) will only
 	/// be subscribed to the event manager added in the constructor.
+	/// Events logged to a file are copied into an mbe::EventLogBuffer and written by a background thread,
+	/// so that logging does not stall the thread that raises the events.
 	class EventLogger
 	{
 	public:
@@ -37,29 +35,56 @@ namespace mbe
 			None = 0,
 			Console = 1 << 0,
 			File = 1 << 1,
-			Other = 1 << 2
+			Other = 1 << 2,
+			// Lossless compact log that can be read using the mbe::EventLogDecoder
+			BinaryFile = 1 << 3
 		};
 
+		/// @brief Defines what happens to file log entries when the log buffer is full
+		/// @see mbe::EventLogBuffer::OverflowPolicy
+		typedef EventLogBuffer::OverflowPolicy OverflowPolicy;
+
 	public:
 		/// @brief Constructor
 		/// @param eventManager A reference of the mbe::EventManager the logging will monitor
 		/// @param filePath The file path to which the loging file is saved to
-		EventLogger(EventManager & eventManager, std::string filePath = "Config/LogFile.txt");
+		/// @param binaryFilePath The file path to which the binary log is saved to. The file is only created when
+		/// an event is subscribed to the OutputStream::BinaryFile.
+		/// @param bufferCapacity The maximum number of events that are buffered before they are written to a file
+		/// @param overflowPolicy Defines what happens to events logged to the text file when the buffer is full.
+		/// Events logged to the binary file are never dropped.
+		EventLogger(EventManager & eventManager, std::string filePath = "Config/LogFile.txt", std::string binaryFilePath = "Config/LogFile.mbelog",
+			size_t bufferCapacity = 4096, OverflowPolicy overflowPolicy = OverflowPolicy::DropNewest);
 
 		/// @brief Destructor
-		/// @details When the mbe::EventLogger is destroyed the log file is saved and all log functions are unsubscribed
+		/// @details When the mbe::EventLogger is destroyed all log functions are unsubscribed
+		/// and the buffered events are written before the log files are saved.
 		~EventLogger();
 
 		/// @brief Subscribes a log function to an event type
 		/// @tparam TEvent The type of event to be logged
 		/// @param outputStream The outputStream(s) to which the logging is written. By default, it is set to the console
 		/// @note More than one outputStream can be added by combing multiple streams using the | operator
+		/// @attention Logging to the OutputStream::BinaryFile requires mbe::BinaryEventLogTraits<TEvent> to be defined
 		template <class TEvent>
 		void Subscribe(OutputStream outputStream = OutputStream::Console);
 
+		/// @brief Returns the number of events that have been dropped because the log buffer was full
+		inline size_t GetDroppedEventCount() const { return eventLogBuffer.GetDroppedCount(); }
+
+		/// @brief Sets what happens to events logged to the text file when the log buffer is full
+		inline void SetOverflowPolicy(OverflowPolicy overflowPolicy) { eventLogBuffer.SetOverflowPolicy(overflowPolicy); }
+
+	private:
+		void OpenBinaryLogFile();
+
 	private:
 		EventManager & eventManager;
 		std::ofstream logFile;
+		std::ofstream binaryLogFile;
+		std::string binaryFilePath;
+		// Must be declared after the files so that it is destroyed (and drained) before they are closed
+		EventLogBuffer eventLogBuffer;
 		std::vector<EventManager::SubscriptionID> subscriptions;
 	};
 
@@ -87,21 +112,29 @@ namespace mbe
 		}
 		if ((outputStream & OutputStream::File) != OutputStream::None)
 		{
+			// The event is only copied here. It is formatted and written by the writer thread of the log buffer.
 			subscription = eventManager.Subscribe(EventManager::TCallback<TEvent>([this](const TEvent & event)
 			{
-				// Get a string of the current time
-				time_t now = time(0);
-				char time[detail::MIN_TIME_BUFFER_SIZE];
-				ctime_s(time, sizeof(time), &now);
-
-				// Remove the std::endl;
-				std::string timeString = time;
-				timeString.erase(timeString.size() - 1);
-
-				logFile << '[' << timeString << "] " << event << std::endl;
+				eventLogBuffer.PushText(event);
 			}));
 			subscriptions.push_back(subscription);
 		}
+		if constexpr (BinaryEventLogTraits<TEvent>::IsSerialisable)
+		{
+			if ((outputStream & OutputStream::BinaryFile) != OutputStream::None)
+			{
+				OpenBinaryLogFile();
+				subscription = eventManager.Subscribe(EventManager::TCallback<TEvent>([this](const TEvent & event)
+				{
+					eventLogBuffer.PushBinary(event);
+				}));
+				subscriptions.push_back(subscription);
+			}
+		}
+		else
+		{
+			assert((outputStream & OutputStream::BinaryFile) == OutputStream::None && "EventLogger: mbe::BinaryEventLogTraits must be specialised to log this event to a binary file");
+		}
 	}
 
 #pragma endregion
@@ -130,5 +163,8 @@ namespace mbe
 /// eventLogger.Subscribe<MyEvent>(mbe::EventLogger::OutputStream::Console | mbe::EventLogger::OutputStream::File);
 /// // If MyEvent occures it is logged to everything but the console 
 /// eventLogger.Subscribe<MyEvent>(~mbe::EventLogger::OutputStrean::Console);
+///
+/// // Log MyEvent losslessly to the binary file (see mbe::EventLogDecoder for reading it back)
+/// eventLogger.Subscribe<MyEvent>(mbe::EventLogger::OutputStream::BinaryFile);
 /// @endcode
 ///////////////////////////////////////////////////////////////////////
\ No newline at end of file
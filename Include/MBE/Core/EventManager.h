@@ -11,6 +11,13 @@
 #include <cassert>
 #include <SFML\System\NonCopyable.hpp>
 
+#ifdef MBE_EVENT_STATISTICS
+#include <string>
+#include <chrono>
+#include <ostream>
+#include <typeinfo>
+#endif // MBE_EVENT_STATISTICS
+
 #include <MBE/Core/BaseEvent.h>
 #include <MBE/Core/EventWrapper.h>
 #include <MBE/Core/HandleBase.h>
@@ -24,6 +31,8 @@ namespace mbe
 	/// @attention Make sure that the mbe::EventManager is deleted after all the objects that keep references to it to avoid invalid refernces.
 	/// Such can cause undefined behaviour or exceptions. An example of this would be the unsubscribing of function objects
 	/// using a refernce of an event manager that no longer exists.
+	/// @note When the MBE_EVENT_STATISTICS compiler flag is defined, the event manager records dispatch statistics for every event type
+	/// (see GetEventStatistics() and WriteEventStatisticsReport()). Without the flag none of the statistics code is compiled.
 	class EventManager : private sf::NonCopyable
 	{
 	public:
@@ -67,12 +76,49 @@ namespace mbe
 		/// @see mbe::HandleBase::ID
 		typedef BaseCallbackWrapper::ID SubscriptionID;
 
+#ifdef MBE_EVENT_STATISTICS
+		/// @brief Defines the clock used to measure the dispatch times
+		typedef std::chrono::steady_clock StatisticsClock;
+
+		/// @brief The dispatch statistics of a single subscribed callback function
+		struct SubscriberStatistics
+		{
+			SubscriptionID subscriptionId;
+			unsigned long long callCount = 0;
+			std::chrono::nanoseconds totalTime{ 0 };
+			std::chrono::nanoseconds maxTime{ 0 };
+		};
+
+		/// @brief The dispatch statistics of a single event type
+		/// @details The dispatch time of an event includes the time spent in events that are raised from within its callbacks.
+		struct EventStatistics
+		{
+			/// @brief Returns the subscribers with the highest total dispatch time in decending order
+			/// @param count The maximum number of subscribers to return
+			std::vector<SubscriberStatistics> GetSlowestSubscribers(size_t count) const;
+
+			std::string eventName;
+			unsigned long long raiseCount = 0;
+			size_t subscriberCount = 0;
+			std::chrono::nanoseconds totalDispatchTime{ 0 };
+			std::chrono::nanoseconds maxDispatchTime{ 0 };
+			std::unordered_map<SubscriptionID, SubscriberStatistics> subscriberStatisticsDictionary;
+		};
+#endif // MBE_EVENT_STATISTICS
+
 	public:
 		/// @brief Default constructor
 		EventManager() = default;
 
+#ifdef MBE_EVENT_STATISTICS
+		/// @brief Destructor
+		/// @details Writes the event statistics report to the report file if one has been set
+		/// @see SetEventStatisticsReportFile()
+		~EventManager();
+#else
 		/// @brief Default destructor
 		~EventManager() = default;
+#endif // MBE_EVENT_STATISTICS
 
 		/// @brief Adds the passed in callback function to the callback dictionary of the event type
 		/// @details The callback function will be called for each raised event of the registered type.
@@ -120,9 +166,46 @@ namespace mbe
 		/// @param subscriptionId The subscription id that referres to the callback function to unsubscribe
 		void UnSubscribe(SubscriptionID subscriptionId);
 
+#ifdef MBE_EVENT_STATISTICS
+		/// @brief Returns the dispatch statistics recorded for an event type
+		/// @tparam TEvent The type of event whose statistics are returned
+		template <class TEvent>
+		const EventStatistics& GetEventStatistics();
+
+		/// @brief Returns the dispatch statistics of all event types indexed by their type id
+		/// @details Event types that have never been subscribed to or raised have an empty event name.
+		inline const std::vector<EventStatistics>& GetEventStatisticsList() const { return eventStatisticsList; }
+
+		/// @brief Resets the raise counts, dispatch times and subscriber statistics of all event types
+		/// @details The subscriber counts are kept since they reflect the current state of the event manager.
+		void ResetEventStatistics();
+
+		/// @brief Writes a report of the recorded event statistics to a stream
+		/// @details The event types are listed in decending order of their total dispatch time so that event storms
+		/// (e.g. many mbe::event::ComponentsChangedEvent during level load) appear at the top.
+		/// @param stream The stream to which the report is written
+		/// @param subscriberCount The number of slowest subscribers that are listed for each event type
+		void WriteEventStatisticsReport(std::ostream& stream, size_t subscriberCount = 3) const;
+
+		/// @brief Sets a file to which the event statistics report is written when the event manager is destroyed
+		/// @param filePath The path of the report file. If empty, no report is written.
+		inline void SetEventStatisticsReportFile(std::string filePath) { eventStatisticsReportFilePath = std::move(filePath); }
+#endif // MBE_EVENT_STATISTICS
+
+	private:
+#ifdef MBE_EVENT_STATISTICS
+		// Resizes the statistics list if necessary and sets the name of the event type
+		EventStatistics& GetEventStatistics(detail::BaseEvent::TypeID typeId, const char* eventName);
+#endif // MBE_EVENT_STATISTICS
 
 	private:
 		std::vector<std::unordered_map<SubscriptionID, BaseCallbackWrapper*>> callbackDictionaryDictionary;
+
+#ifdef MBE_EVENT_STATISTICS
+		// Indexed by the event type id (same as the callbackDictionaryDictionary)
+		std::vector<EventStatistics> eventStatisticsList;
+		std::string eventStatisticsReportFilePath;
+#endif // MBE_EVENT_STATISTICS
 	};
 
 #pragma region Template Implementations
@@ -152,6 +235,10 @@ namespace mbe
 		//callbackDictionaryList[typeId].insert(std::make_pair<BaseCallBackWrapper::ID, std::unique_ptr<BaseCallBackWrapper>>(callbackWrapperHandleId, std::move(baseCallbackPtr)));
 		callbackDictionaryDictionary[typeId].insert(std::make_pair(callbackWrapperHandleId, baseCallbackPtr));
 
+#ifdef MBE_EVENT_STATISTICS
+		GetEventStatistics(typeId, typeid(TEvent).name()).subscriberCount = callbackDictionaryDictionary[typeId].size();
+#endif // MBE_EVENT_STATISTICS
+
 		// return the handle id
 		return callbackWrapperHandleId;
 	}
@@ -177,10 +264,34 @@ namespace mbe
 		// use indirection to call the event
 		// The event can't be directly be passed to the BaseCallbackWrapper since TEvent does not inherit from EventWrapper / BaseEvent
 		detail::EventWrapper<TEvent> eventWrapper(event);
+#ifdef MBE_EVENT_STATISTICS
+		GetEventStatistics(typeId, typeid(TEvent).name()).raiseCount++;
+		const auto dispatchStart = StatisticsClock::now();
+
+		for (auto& callbackPair : callbackDictionaryDictionary[typeId])
+		{
+			const auto callbackStart = StatisticsClock::now();
+			(*callbackPair.second)(eventWrapper);
+			const auto callbackTime = std::chrono::duration_cast<std::chrono::nanoseconds>(StatisticsClock::now() - callbackStart);
+
+			// Index the list again since a callback may have subscribed to a new event type (which can resize the list)
+			auto& subscriberStatistics = eventStatisticsList[typeId].subscriberStatisticsDictionary[callbackPair.first];
+			subscriberStatistics.subscriptionId = callbackPair.first;
+			subscriberStatistics.callCount++;
+			subscriberStatistics.totalTime += callbackTime;
+			subscriberStatistics.maxTime = std::max(subscriberStatistics.maxTime, callbackTime);
+		}
+
+		const auto dispatchTime = std::chrono::duration_cast<std::chrono::nanoseconds>(StatisticsClock::now() - dispatchStart);
+		auto& eventStatistics = eventStatisticsList[typeId];
+		eventStatistics.totalDispatchTime += dispatchTime;
+		eventStatistics.maxDispatchTime = std::max(eventStatistics.maxDispatchTime, dispatchTime);
+#else
 		for (auto& callbackPair : callbackDictionaryDictionary[typeId])
 		{
 			(*callbackPair.second)(eventWrapper);
 		}
+#endif // MBE_EVENT_STATISTICS
 	}
 
 	template<class TEvent>
@@ -193,11 +304,23 @@ namespace mbe
 		// Erase by key
 		callbackDictionaryDictionary[typeId].erase(subscriptionId);
 
+#ifdef MBE_EVENT_STATISTICS
+		GetEventStatistics(typeId, typeid(TEvent).name()).subscriberCount = callbackDictionaryDictionary[typeId].size();
+#endif // MBE_EVENT_STATISTICS
+
 		// Delete the wrapper (this will not be necessary when using unique pointers)
 		//delete BaseCallbackWrapper::GetObjectFromID(subscriptionId);
 		delete subscriptionId.GetObjectPtr();
 	}
 
+#ifdef MBE_EVENT_STATISTICS
+	template<class TEvent>
+	inline const EventManager::EventStatistics& EventManager::GetEventStatistics()
+	{
+		return GetEventStatistics(detail::EventWrapper<TEvent>::GetTypeID(), typeid(TEvent).name());
+	}
+#endif // MBE_EVENT_STATISTICS
+
 #pragma endregion
 
 
@@ -246,5 +369,11 @@ namespace mbe
 ///
 /// // Unsubscribe the callback function using the subscribtion id
 /// eventManager.UnSubscribe<MyEvent>(subscriptionId);
+///
+/// // When compiled with MBE_EVENT_STATISTICS, the dispatch statistics can be inspected
+/// // or written to a file when the event manager is destroyed
+/// std::cout << eventManager.GetEventStatistics<MyEvent>().raiseCount;
+/// eventManager.WriteEventStatisticsReport(std::cout);
+/// eventManager.SetEventStatisticsReportFile("Config/EventStatistics.txt");
 /// @endcode
 ///////////////////////////////////////////////////////////////////////
\ No newline at end of file
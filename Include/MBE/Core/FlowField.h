@@ -0,0 +1,233 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::FlowField
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/PathSearchSpace.h>
+#include <MBE/Map/ReachableTileList.h>
+
+namespace mbe
+{
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief The direction towards a single goal for every tile of a tile map
+	/// @details The field is created by a Dijkstra search that starts at the goal, so any number of agents that share the goal
+	/// can find their way by looking up the direction of the tile they are on in O(1).
+	/// The cost of a tile is the cost of the best path from it to the goal and its direction points to the next tile on that path.
+	/// @n The directions are normalised and stored in separate arrays for the x and y components, so that the directions of many agents
+	/// can be looked up by SampleDirections() in a loop that the compiler can vectorise.
+	/// @n The goal and the tiles from which it can not be reached have a direction of (0, 0).
+	/// @tparam TTileMap The type of tile map. It has the same requirements as for the mbe::AStarPathfinder.
+	/// In addition, a tile must be reachable from another tile if and only if the other tile is reachable from it.
+	/// @note The field is not updated when the tile map changes. The mbe::FlowFieldCache recreates the fields that are affected by an edit.
+	template <class TTileMap>
+	class FlowField
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+	public:
+		/// @brief Constructor
+		/// @details The field is empty until Create() is called.
+		/// @param tileMap The tile map on which the field is created. Its size is read when calling Create().
+		FlowField(const TTileMap & tileMap);
+
+		/// @brief Default destructor
+		~FlowField() = default;
+
+	public:
+		/// @brief Creates the field for a goal
+		/// @details The memory of the previous field is reused if the size of the map has not changed.
+		/// @param goal The tile the directions point to
+		/// @param searchSpace The search state used to create the field. It is resized to the number of tiles if necessary.
+		void Create(Position goal, detail::PathSearchSpace & searchSpace);
+
+		/// @brief Creates the field for a goal
+		/// @details Allocates a temporary search state. When creating many fields, the other overload should be used.
+		void Create(Position goal);
+
+		/// @brief Returns the normalised direction of a tile
+		/// @details The position must lie on the map.
+		inline sf::Vector2f GetDirection(Position position) const { const size_t index = GetTileIndex(position); return { directionXList[index], directionYList[index] }; }
+
+		/// @brief Returns the cost of moving from a tile to the goal
+		/// @details The position must lie on the map.
+		/// @returns The cost or std::numeric_limits<float>::infinity() if the goal can not be reached
+		inline float GetCost(Position position) const { return costList[GetTileIndex(position)]; }
+
+		inline bool IsReachable(Position position) const { return GetCost(position) != std::numeric_limits<float>::infinity(); }
+
+		/// @brief Looks up the directions of many tiles at once
+		/// @details All positions must lie on the map.
+		/// @param tileXList The x coordinates of the tiles
+		/// @param tileYList The y coordinates of the tiles
+		/// @param count The number of tiles
+		/// @param directionXList The x components of the directions are written to this array
+		/// @param directionYList The y components of the directions are written to this array
+		void SampleDirections(const int * tileXList, const int * tileYList, size_t count, float * directionXList, float * directionYList) const;
+
+		/// @brief Returns whether changing the tiles in the area may change the field
+		/// @details This is the case if the goal can be reached from one of the tiles in the area or next to it.
+		/// Otherwise, the changed tiles are only connected to tiles from which the goal can not be reached either.
+		bool IsAffected(Position position, sf::Vector2u size) const;
+
+		inline Position GetGoal() const { return goal; }
+
+		/// @brief Returns the x components of the directions indexed by y * width + x
+		inline const std::vector<float>& GetDirectionXList() const { return directionXList; }
+
+		/// @brief Returns the y components of the directions indexed by y * width + x
+		inline const std::vector<float>& GetDirectionYList() const { return directionYList; }
+
+		/// @brief Returns the costs indexed by y * width + x
+		inline const std::vector<float>& GetCostList() const { return costList; }
+
+	private:
+		inline size_t GetTileIndex(Position position) const;
+
+	private:
+		const TTileMap & map;
+		size_t width;
+		size_t height;
+		Position goal;
+
+		std::vector<float> directionXList;
+		std::vector<float> directionYList;
+		std::vector<float> costList;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	FlowField<TTileMap>::FlowField(const TTileMap & tileMap) :
+		map(tileMap),
+		width(0),
+		height(0)
+	{
+	}
+
+	template <class TTileMap>
+	void FlowField<TTileMap>::Create(Position goal, detail::PathSearchSpace & searchSpace)
+	{
+		width = map.GetSize().x;
+		height = map.GetSize().y;
+		const size_t tileCount = width * height;
+		this->goal = goal;
+
+		assert(goal.x >= 0 && static_cast<size_t>(goal.x) < width && goal.y >= 0 && static_cast<size_t>(goal.y) < height && "FlowField: The goal lies outside the map");
+
+		if (searchSpace.GetNodeCount() != tileCount)
+			searchSpace.SetNodeCount(tileCount);
+		searchSpace.Reset();
+
+		// Dijkstra search from the goal
+		// Moving from a tile to its neighbour costs the movement speed of the neighbour, so the cost of a tile is
+		// the cost of the tile it is reached from plus the movement speed of that tile
+		searchSpace.Relax(GetTileIndex(goal), 0.f, 0.f, detail::INVALID_NODE_INDEX);
+		while (searchSpace.HasOpenNodes())
+		{
+			const size_t tileIndex = searchSpace.PopOpenNode();
+			const Position position(static_cast<int>(tileIndex % width), static_cast<int>(tileIndex / width));
+			const float cost = searchSpace.GetG(tileIndex) + map.GetTileMovementSpeed(position.x, position.y);
+
+			for (const auto & neighbourPosition : detail::GetReachableTileList(map, position))
+				searchSpace.Relax(GetTileIndex(neighbourPosition), cost, 0.f, tileIndex);
+		}
+
+		// Store the result in compact arrays
+		directionXList.resize(tileCount);
+		directionYList.resize(tileCount);
+		costList.resize(tileCount);
+
+		const float diagonalLength = 1.f / std::sqrt(2.f);
+		for (size_t tileIndex = 0; tileIndex < tileCount; tileIndex++)
+		{
+			if (searchSpace.IsVisited(tileIndex) == false)
+			{
+				directionXList[tileIndex] = 0.f;
+				directionYList[tileIndex] = 0.f;
+				costList[tileIndex] = std::numeric_limits<float>::infinity();
+				continue;
+			}
+
+			costList[tileIndex] = searchSpace.GetG(tileIndex);
+
+			// The parent is the next tile towards the goal
+			const size_t parentIndex = searchSpace.GetParent(tileIndex);
+			if (parentIndex == detail::INVALID_NODE_INDEX)
+			{
+				directionXList[tileIndex] = 0.f;
+				directionYList[tileIndex] = 0.f;
+				continue;
+			}
+
+			const float directionX = static_cast<float>(static_cast<long long>(parentIndex % width) - static_cast<long long>(tileIndex % width));
+			const float directionY = static_cast<float>(static_cast<long long>(parentIndex / width) - static_cast<long long>(tileIndex / width));
+			const float length = (directionX != 0.f && directionY != 0.f) ? diagonalLength : 1.f;
+			directionXList[tileIndex] = directionX * length;
+			directionYList[tileIndex] = directionY * length;
+		}
+	}
+
+	template <class TTileMap>
+	void FlowField<TTileMap>::Create(Position goal)
+	{
+		detail::PathSearchSpace searchSpace;
+		Create(goal, searchSpace);
+	}
+
+	template <class TTileMap>
+	void FlowField<TTileMap>::SampleDirections(const int * tileXList, const int * tileYList, size_t count, float * directionXList, float * directionYList) const
+	{
+		// No branches and separate arrays, so that the loop can be vectorised
+		const float * const fieldDirectionXList = this->directionXList.data();
+		const float * const fieldDirectionYList = this->directionYList.data();
+		const long long width = static_cast<long long>(this->width);
+		for (size_t i = 0; i < count; i++)
+		{
+			const long long tileIndex = static_cast<long long>(tileYList[i]) * width + tileXList[i];
+			directionXList[i] = fieldDirectionXList[tileIndex];
+			directionYList[i] = fieldDirectionYList[tileIndex];
+		}
+	}
+
+	template <class TTileMap>
+	bool FlowField<TTileMap>::IsAffected(Position position, sf::Vector2u size) const
+	{
+		if (size.x == 0u || size.y == 0u || costList.empty())
+			return false;
+
+		// The tiles next to the changed area may reach different tiles now, so the area is grown by one tile
+		const long long left = std::max(static_cast<long long>(position.x) - 1, 0ll);
+		const long long top = std::max(static_cast<long long>(position.y) - 1, 0ll);
+		const long long right = std::min(static_cast<long long>(position.x) + size.x, static_cast<long long>(width) - 1);
+		const long long bottom = std::min(static_cast<long long>(position.y) + size.y, static_cast<long long>(height) - 1);
+
+		for (long long y = top; y <= bottom; y++)
+		{
+			for (long long x = left; x <= right; x++)
+			{
+				if (costList[static_cast<size_t>(y) * width + static_cast<size_t>(x)] != std::numeric_limits<float>::infinity())
+					return true;
+			}
+		}
+		return false;
+	}
+
+	template <class TTileMap>
+	inline size_t FlowField<TTileMap>::GetTileIndex(Position position) const
+	{
+		assert(position.x >= 0 && static_cast<size_t>(position.x) < width && position.y >= 0 && static_cast<size_t>(position.y) < height && "FlowField: The position lies outside the map");
+		return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x);
+	}
+
+#pragma endregion
+
+} // namespace mbe
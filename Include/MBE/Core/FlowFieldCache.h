@@ -0,0 +1,189 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::FlowFieldCache
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/FlowField.h>
+#include <MBE/Core/PathSearchSpace.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The default number of flow fields kept by the mbe::FlowFieldCache
+		constexpr size_t DEFAULT_FLOW_FIELD_CACHE_CAPACITY = 8;
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Keeps the flow fields of the most recently used goals
+	/// @details When the cache is full, the field of the least recently used goal is reused for the new goal.
+	/// @n When tiles change, InvalidateTiles() must be called. The fields that are affected are recreated the next time they are requested.
+	/// If an event manager is passed to the constructor, the cache subscribes to the mbe::event::TileMapChangedEvent and does this itself.
+	/// @tparam TTileMap The type of tile map. It has the same requirements as for the mbe::FlowField.
+	template <class TTileMap>
+	class FlowFieldCache
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap The tile map on which the fields are created
+		/// @param capacity The maximum number of fields that are kept
+		FlowFieldCache(const TTileMap & tileMap, size_t capacity = detail::DEFAULT_FLOW_FIELD_CACHE_CAPACITY);
+
+		/// @brief Constructor
+		/// @details The fields are invalidated whenever the event manager raises a mbe::event::TileMapChangedEvent.
+		/// @param tileMap The tile map on which the fields are created
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent. It must outlive the cache.
+		/// @param capacity The maximum number of fields that are kept
+		FlowFieldCache(const TTileMap & tileMap, EventManager & eventManager, size_t capacity = detail::DEFAULT_FLOW_FIELD_CACHE_CAPACITY);
+
+		/// @brief Default destructor
+		~FlowFieldCache() = default;
+
+	public:
+		/// @brief Returns the flow field of a goal
+		/// @details The field is created if it is not cached or has been invalidated.
+		/// @returns A reference to the field. It stays valid until the field is evicted to make space for another goal
+		/// and is updated when the field is recreated.
+		const FlowField<TTileMap>& GetFlowField(Position goal);
+
+		/// @brief Marks the fields that may be changed by changing the tiles in the area
+		/// @param position The top left tile of the area
+		/// @param size The number of tiles in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Removes all fields
+		/// @details The memory of the fields is released.
+		void Clear();
+
+		/// @brief Sets the maximum number of fields that are kept
+		/// @details If there are more fields, the least recently used ones are removed.
+		void SetCapacity(size_t capacity);
+
+		inline size_t GetCapacity() const { return capacity; }
+
+		/// @brief Returns the number of fields that are currently kept
+		inline size_t GetSize() const { return entryList.size(); }
+
+		/// @brief Returns the number of fields that have been created
+		/// @details This includes fields that have been recreated after being invalidated.
+		inline size_t GetCreatedFieldCount() const { return createdFieldCount; }
+
+	private:
+		struct Entry
+		{
+			std::unique_ptr<FlowField<TTileMap>> flowField;
+			unsigned long long lastUse;
+			bool invalidated;
+		};
+
+	private:
+		const TTileMap & map;
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
+
+		size_t capacity;
+		// There are only a few entries, so they are searched linearly
+		std::vector<Entry> entryList;
+		// Shared by the fields since they are created one at a time
+		detail::PathSearchSpace searchSpace;
+		unsigned long long useCount;
+		size_t createdFieldCount;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	FlowFieldCache<TTileMap>::FlowFieldCache(const TTileMap & tileMap, size_t capacity) :
+		map(tileMap),
+		capacity(capacity),
+		useCount(0ull),
+		createdFieldCount(0)
+	{
+		assert(capacity > 0 && "FlowFieldCache: The capacity must be at least one");
+	}
+
+	template <class TTileMap>
+	FlowFieldCache<TTileMap>::FlowFieldCache(const TTileMap & tileMap, EventManager & eventManager, size_t capacity) :
+		FlowFieldCache(tileMap, capacity)
+	{
+		tileMapChangedSubscription.Subscribe(eventManager, *this);
+	}
+
+	template <class TTileMap>
+	const FlowField<TTileMap>& FlowFieldCache<TTileMap>::GetFlowField(Position goal)
+	{
+		auto it = std::find_if(entryList.begin(), entryList.end(), [&goal](const Entry & entry) { return entry.flowField->GetGoal() == goal; });
+
+		if (it == entryList.end())
+		{
+			if (entryList.size() < capacity)
+			{
+				entryList.push_back({ std::make_unique<FlowField<TTileMap>>(map), 0ull, true });
+				it = entryList.end() - 1;
+			}
+			else
+			{
+				// Reuse the field of the least recently used goal
+				it = std::min_element(entryList.begin(), entryList.end(), [](const Entry & a, const Entry & b) { return a.lastUse < b.lastUse; });
+				it->invalidated = true;
+			}
+		}
+
+		if (it->invalidated)
+		{
+			it->flowField->Create(goal, searchSpace);
+			it->invalidated = false;
+			createdFieldCount++;
+		}
+
+		it->lastUse = ++useCount;
+		return *it->flowField;
+	}
+
+	template <class TTileMap>
+	void FlowFieldCache<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		for (auto & entry : entryList)
+		{
+			if (entry.invalidated == false && entry.flowField->IsAffected(position, size))
+				entry.invalidated = true;
+		}
+	}
+
+	template <class TTileMap>
+	void FlowFieldCache<TTileMap>::Clear()
+	{
+		entryList.clear();
+		entryList.shrink_to_fit();
+		searchSpace.SetNodeCount(0);
+	}
+
+	template <class TTileMap>
+	void FlowFieldCache<TTileMap>::SetCapacity(size_t capacity)
+	{
+		assert(capacity > 0 && "FlowFieldCache: The capacity must be at least one");
+		this->capacity = capacity;
+
+		if (entryList.size() <= capacity)
+			return;
+
+		// Keep the most recently used entries
+		std::sort(entryList.begin(), entryList.end(), [](const Entry & a, const Entry & b) { return a.lastUse > b.lastUse; });
+		entryList.erase(entryList.begin() + capacity, entryList.end());
+	}
+
+#pragma endregion
+
+} // namespace mbe
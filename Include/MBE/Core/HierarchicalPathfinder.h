@@ -0,0 +1,1201 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::HierarchicalPathfinder
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/PathSearchSpace.h>
+#include <MBE/Core/TileConnectivity.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/ReachableTileList.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The default width and height of the clusters of the mbe::HierarchicalPathfinder in tiles
+		constexpr unsigned int DEFAULT_PATH_CLUSTER_SIZE = 16u;
+
+		/// @brief Entrances between two clusters that are at least this long get a transition at both ends instead of one in the middle
+		constexpr unsigned int MIN_DOUBLE_TRANSITION_ENTRANCE_LENGTH = 6u;
+
+		/// @brief The maximum number of buckets of the searches within a cluster
+		/// @details The searches put the tiles into buckets whose width is the lowest cost of a move. If the highest cost of a move is more than
+		/// this many times larger, a binary heap is used instead.
+		constexpr unsigned int MAX_AREA_SEARCH_BUCKET_COUNT = 64u;
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Hierarchical a star pathfinding (HPA*) on a tile map
+	/// @tparam TTileMap The type of tile map the pathfinding is performed on. It has the same requirements as for the mbe::AStarPathfinder.
+	/// @details The map is divided into square clusters. Where a cluster borders on its right, bottom or diagonal neighbours, the pairs of
+	/// tiles from which the other cluster can be reached form entrances. Each entrance is represented by one or two transitions
+	/// whose tiles become nodes of an abstract graph. The nodes of a cluster are connected by the cost of the best path
+	/// that stays inside the cluster, the two tiles of a transition by the cost of moving between them.
+	/// @n A query connects the start and the end tile to the nodes of their clusters, finds a path on the abstract graph and then
+	/// refines each abstract edge with an a star search that is restricted to a single cluster. The resulting paths are close to
+	/// but not always as short as the paths found by the mbe::AStarPathfinder.
+	/// @n The edges within a cluster are only built once an abstract search reaches it, so the first queries through a part of the map are slower.
+	/// @n The hierarchical pathfinder is not generally faster than the mbe::AStarPathfinder. On a 1024x1024 map with 10% of the tiles blocked
+	/// at random (see Benchmarks/HierarchicalPathfinderBenchmark.cpp), a corner to corner query takes 14 ms instead of 43 ms
+	/// and long queries take about 4.5 ms once their clusters have been built. The a star search takes about 12 ms on average for these,
+	/// but half of these queries take less than 1.5 ms, since it finds almost straight paths quickly.
+	/// The paths are about 2% longer (7% on small maps with small clusters and different movement speeds).
+	/// Use it when the worst case of long queries matters or when the abstract path is refined lazily (see FindWaypoints()).
+	/// @n When tiles change, InvalidateTiles() must be called. Only the affected clusters and their direct neighbours are rebuilt,
+	/// which happens the next time a path is requested or when calling Update().
+	/// A pathfinder that is constructed with an event manager calls InvalidateTiles() itself when a mbe::event::TileMapChangedEvent is raised.
+	/// @n The size of the tile map is read in the constructor. A pathfinder is not thread safe.
+	template <class TTileMap>
+	class HierarchicalPathfinder
+	{
+	public:
+		/// @brief The type of a map position
+		/// @details This will be the same as the position type the tile map is using
+		typedef typename TTileMap::Position Position;
+
+	public:
+		/// @brief Constructor
+		/// @details Builds the nodes of the abstract graph of the whole map
+		/// @param tileMap A reference to the tileMap on which the pathfinding is performed
+		/// @param clusterSize The width and height of the clusters in tiles
+		HierarchicalPathfinder(const TTileMap & tileMap, unsigned int clusterSize = detail::DEFAULT_PATH_CLUSTER_SIZE);
+
+		/// @brief Constructor
+		/// @details Builds the nodes of the abstract graph of the whole map and subscribes to the mbe::event::TileMapChangedEvent,
+		/// so that the clusters of the changed tiles are rebuilt the next time a path is requested
+		/// @param tileMap A reference to the tileMap on which the pathfinding is performed
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent. It must outlive the pathfinder.
+		/// @param clusterSize The width and height of the clusters in tiles
+		HierarchicalPathfinder(const TTileMap & tileMap, EventManager & eventManager, unsigned int clusterSize = detail::DEFAULT_PATH_CLUSTER_SIZE);
+
+		/// @brief Default destructor
+		~HierarchicalPathfinder() = default;
+
+	public:
+		/// @brief Finds a path between two points on the tileMap
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @returns The path as a list of positions. If no path could be found, an empty list is returned
+		std::vector<Position> FindPath(Position startPos, Position endPos);
+
+		/// @brief Finds a path between two points on the tileMap
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @param path The list the path is written to. It is cleared if no path could be found.
+		/// @returns True if a path has been found, false otherwise
+		bool FindPath(Position startPos, Position endPos, std::vector<Position> & path);
+
+		/// @brief Finds the abstract path between two points on the tileMap without refining it
+		/// @details The waypoints are the start position, the transition tiles the path passes through and the end position.
+		/// Two consecutive waypoints either lie in the same cluster or are neighbours. This allows refining the path lazily,
+		/// e.g. by using an mbe::AStarPathfinder for the next waypoint only.
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @param waypointList The list the waypoints are written to. It is cleared if no path could be found.
+		/// @returns True if a path has been found, false otherwise
+		bool FindWaypoints(Position startPos, Position endPos, std::vector<Position> & waypointList);
+
+		/// @brief Marks the clusters that are affected by a change of tiles as dirty
+		/// @details This must be called whenever the reachable tiles or the movement speed of tiles change.
+		/// The dirty clusters are rebuilt by the next call to FindPath(), FindWaypoints() or Update().
+		/// @param position The top left tile of the changed area
+		/// @param size The width and height of the changed area in tiles
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Rebuilds the abstract graph of the dirty clusters
+		void Update();
+
+		/// @brief Sets the connectivity labels that are used to reject unreachable goals without searching
+		/// @details Without the labels, a search for an unreachable goal expands every abstract node that can be reached from the start.
+		/// The labels must be kept up to date by calling mbe::TileConnectivity::InvalidateTiles() when the tile map changes.
+		/// @param connectivity The labels of the tile map or nullptr to search without them. They must outlive the pathfinder.
+		inline void SetConnectivity(const TileConnectivity<TTileMap> * connectivity) { this->connectivity = connectivity; }
+
+		/// @brief Returns the number of nodes of the abstract graph
+		size_t GetAbstractNodeCount() const;
+
+		inline unsigned int GetClusterSize() const { return clusterSize; }
+
+	private:
+		struct Edge
+		{
+			size_t nodeId;
+			float cost;
+			// The tile of the node, so that the heuristic does not have to look up the node
+			Position position;
+		};
+
+		struct AbstractNode
+		{
+			size_t tileIndex;
+			// Edges to the nodes of the same cluster
+			std::vector<Edge> intraEdgeList;
+			// Edges to the nodes of the neighbouring clusters
+			std::vector<Edge> interEdgeList;
+		};
+
+		// A pair of neighbouring tiles on both sides of the border between two clusters
+		struct Transition
+		{
+			// The tile in the left or top cluster
+			size_t fromTileIndex;
+			// The tile in the right or bottom cluster
+			size_t toTileIndex;
+			// Whether the to tile can be reached from the from tile
+			bool forward;
+			// Whether the from tile can be reached from the to tile
+			bool backward;
+		};
+
+		// The neighbours of a cluster to which it stores the transitions
+		// The transitions to the other four neighbours are stored by these neighbours
+		enum Side : unsigned short int
+		{
+			Right,
+			Bottom,
+			BottomRight,
+			BottomLeft,
+			SideCount
+		};
+
+		struct Cluster
+		{
+			// Sorted by the tile index
+			std::vector<AbstractNode> nodeList;
+			// The transitions to the neighbours on each side
+			std::vector<Transition> transitionList[SideCount];
+			bool dirty = true;
+			// The intra edges are only built once an abstract search reaches the cluster
+			bool intraEdgesBuilt = false;
+		};
+
+		struct TileBounds
+		{
+			unsigned int left;
+			unsigned int top;
+			unsigned int width;
+			unsigned int height;
+		};
+
+		// A move between two tiles of an area
+		struct AreaEdge
+		{
+			unsigned int localIndex;
+			float cost;
+		};
+
+		// The moves between the tiles of an area that do not leave it
+		// Building it once per cluster avoids querying the tile map for every search from the nodes of the cluster
+		struct AreaGraph
+		{
+			// The moves from the tile with the local index i are edgeList[edgeBeginList[i]] to edgeList[edgeBeginList[i + 1]]
+			std::vector<unsigned int> edgeBeginList;
+			std::vector<AreaEdge> edgeList;
+			float minCost;
+			float maxCost;
+		};
+
+	private:
+		// Finds the abstract path as a list of node ids (the start and end position are not included)
+		bool FindAbstractPath(size_t startTileIndex, size_t endTileIndex);
+
+		// Returns true if the transitions have changed
+		bool BuildTransitions(size_t clusterIndex, Side side);
+		void BuildNodes(size_t clusterIndex);
+		void BuildIntraEdges(size_t clusterIndex);
+		void BuildInterEdges(size_t clusterIndex);
+
+		// A star search that does not leave the area (which must not be larger than two by two clusters)
+		// If the end tile index is detail::INVALID_NODE_INDEX, the whole area is searched (Dijkstra)
+		bool SearchArea(const TileBounds & bounds, size_t startTileIndex, size_t endTileIndex);
+
+		// Creates the graph of the moves within the area
+		void BuildAreaGraph(const TileBounds & bounds, AreaGraph & graph) const;
+
+		// Creates the graph in which every move goes from the reached to the reaching tile (with the cost of the original move)
+		static void ReverseAreaGraph(const AreaGraph & graph, AreaGraph & reverseGraph);
+
+		// Dijkstra search over the whole area graph
+		// The cost of each tile is written to the area cost list (infinity if it can not be reached)
+		void SearchAreaGraph(const AreaGraph & graph, size_t startLocalIndex);
+
+		// Appends the path found by the last area search without its first tile
+		void AppendAreaPath(const TileBounds & bounds, size_t endTileIndex, std::vector<Position> & path);
+
+		bool IsReachable(size_t fromTileIndex, size_t toTileIndex) const;
+
+		// Returns whether the tile can be reached from another tile
+		// Paths through the transitions never start on a tile that can not be entered (e.g. an unwalkable tile), since such paths are connected
+		// through the neighbours of the start tile. Without reachable tile masks, any tile may be reached (e.g. through a teleporter), so true is returned.
+		bool CanBeEntered(size_t tileIndex) const;
+
+		// Returns the neighbour of the start tile through which the node tile of a neighbouring cluster is reached at the lowest cost
+		// The last area search is the one from the returned neighbour
+		size_t FindStartNeighbour(size_t startTileIndex, size_t nodeTileIndex);
+
+		// Returns detail::INVALID_NODE_INDEX if the tile is not a node of the cluster
+		size_t FindNodeSlot(size_t clusterIndex, size_t tileIndex) const;
+
+		TileBounds GetClusterBounds(size_t clusterIndex) const;
+
+		// Returns false if the clusters are not the same or adjacent
+		bool GetNeighbourhoodBounds(size_t clusterIndex, size_t otherClusterIndex, TileBounds & bounds) const;
+
+		// Returns detail::INVALID_NODE_INDEX if there is no such cluster
+		size_t GetAdjacentClusterIndex(size_t clusterIndex, int offsetX, int offsetY) const;
+
+		static sf::Vector2i GetSideOffset(Side side);
+
+		inline size_t GetClusterIndex(size_t tileIndex) const { return (tileIndex / width / clusterSize) * clusterCountX + (tileIndex % width) / clusterSize; }
+
+		// The index of a tile within the search space of an area search
+		inline size_t GetLocalIndex(const TileBounds & bounds, size_t tileIndex) const { return (tileIndex / width - bounds.top) * bounds.width + (tileIndex % width - bounds.left); }
+
+		inline size_t GetTileIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline Position GetTilePosition(size_t tileIndex) const;
+
+		inline size_t GetNodeId(size_t clusterIndex, size_t slot) const { return clusterIndex * maxNodeCountPerCluster + slot; }
+
+		inline const AbstractNode & GetNode(size_t nodeId) const { return clusterList[nodeId / maxNodeCountPerCluster].nodeList[nodeId % maxNodeCountPerCluster]; }
+
+	private:
+		const unsigned int clusterSize;
+		const size_t width;
+		const size_t height;
+		const size_t clusterCountX;
+		const size_t clusterCountY;
+		// Each side of a cluster has at most clusterSize transition tiles (plus the diagonal transitions at the corners)
+		const size_t maxNodeCountPerCluster;
+
+		std::vector<Cluster> clusterList;
+		bool dirty;
+
+		// Abstract node ids plus the start and end node
+		detail::PathSearchSpace abstractSearchSpace;
+		// The graphs of the cluster that is currently searched (kept so that their memory is reused)
+		AreaGraph areaGraph;
+		AreaGraph reverseAreaGraph;
+		// The state of the last area search by the local index of the tiles of up to two by two clusters
+		// The cost is infinity if a tile has not been reached. The parents are only written by SearchArea().
+		std::vector<float> areaCostList;
+		std::vector<size_t> areaParentList;
+		std::vector<unsigned char> areaClosedList;
+		// The open list contains a tile again whenever its cost is lowered (only the cheapest entry is expanded)
+		// This is faster than updating the entries for the small areas that are searched
+		std::vector<std::pair<float, unsigned int>> areaOpenList;
+		std::vector<std::vector<std::pair<float, unsigned int>>> areaBucketList;
+		// The open list of SearchArea() sorted by the estimated cost and then by the straight line distance to the end tile
+		std::vector<std::tuple<float, float, unsigned int>> areaSearchOpenList;
+		// The cost from each node of the end cluster to the end tile
+		std::vector<float> endCostList;
+		// The result of the last abstract search
+		std::vector<size_t> abstractPath;
+
+		const TTileMap & map;
+		const TileConnectivity<TTileMap> * connectivity;
+
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
+	};
+
+
+#pragma region Template Implementation
+
+	template <class TTileMap>
+	HierarchicalPathfinder<TTileMap>::HierarchicalPathfinder(const TTileMap & tileMap, unsigned int clusterSize) :
+		clusterSize(std::max(clusterSize, 1u)),
+		width(tileMap.GetSize().x),
+		height(tileMap.GetSize().y),
+		clusterCountX((tileMap.GetSize().x + this->clusterSize - 1) / this->clusterSize),
+		clusterCountY((tileMap.GetSize().y + this->clusterSize - 1) / this->clusterSize),
+		maxNodeCountPerCluster(4 * static_cast<size_t>(this->clusterSize) + 4),
+		clusterList(clusterCountX * clusterCountY),
+		dirty(true),
+		abstractSearchSpace(clusterCountX * clusterCountY * maxNodeCountPerCluster + 2),
+		map(tileMap),
+		connectivity(nullptr)
+	{
+		Update();
+	}
+
+	template <class TTileMap>
+	HierarchicalPathfinder<TTileMap>::HierarchicalPathfinder(const TTileMap & tileMap, EventManager & eventManager, unsigned int clusterSize) :
+		HierarchicalPathfinder(tileMap, clusterSize)
+	{
+		tileMapChangedSubscription.Subscribe(eventManager, *this);
+	}
+
+	template <class TTileMap>
+	std::vector<typename HierarchicalPathfinder<TTileMap>::Position> HierarchicalPathfinder<TTileMap>::FindPath(Position startPos, Position endPos)
+	{
+		std::vector<Position> path;
+		FindPath(startPos, endPos, path);
+		return path;
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::FindPath(Position startPos, Position endPos, std::vector<Position> & path)
+	{
+		assert(startPos.x >= 0 && static_cast<size_t>(startPos.x) < width && startPos.y >= 0 && static_cast<size_t>(startPos.y) < height && "HierarchicalPathfinder: The start tile lies outside the map");
+		assert(endPos.x >= 0 && static_cast<size_t>(endPos.x) < width && endPos.y >= 0 && static_cast<size_t>(endPos.y) < height && "HierarchicalPathfinder: The end tile lies outside the map");
+
+		path.clear();
+
+		if (connectivity != nullptr && connectivity->IsReachable(startPos, endPos) == false)
+			return false;
+
+		Update();
+
+		const size_t startTileIndex = GetTileIndex(startPos);
+		const size_t endTileIndex = GetTileIndex(endPos);
+		const size_t startClusterIndex = GetClusterIndex(startTileIndex);
+		const size_t endClusterIndex = GetClusterIndex(endTileIndex);
+
+		// Short paths within the same or adjacent clusters do not need the abstract graph (unless they have to leave these clusters)
+		// This also avoids detours through the transitions
+		TileBounds neighbourhoodBounds;
+		if (GetNeighbourhoodBounds(startClusterIndex, endClusterIndex, neighbourhoodBounds) && SearchArea(neighbourhoodBounds, startTileIndex, endTileIndex))
+		{
+			path.push_back(startPos);
+			AppendAreaPath(neighbourhoodBounds, endTileIndex, path);
+			return true;
+		}
+
+		if (FindAbstractPath(startTileIndex, endTileIndex) == false)
+			return false;
+
+		// Refine the abstract path
+		path.push_back(startPos);
+		size_t currentTileIndex = startTileIndex;
+		for (const auto nodeId : abstractPath)
+		{
+			const size_t tileIndex = GetNode(nodeId).tileIndex;
+			const size_t clusterIndex = GetClusterIndex(tileIndex);
+
+			// The start tile may be connected to a neighbouring cluster through one of its neighbours
+			if (currentTileIndex == startTileIndex && clusterIndex != startClusterIndex && IsReachable(startTileIndex, tileIndex) == false)
+			{
+				currentTileIndex = FindStartNeighbour(startTileIndex, tileIndex);
+				path.push_back(GetTilePosition(currentTileIndex));
+			}
+
+			// Consecutive nodes in different clusters are connected by a transition (i.e. they are neighbours)
+			if (clusterIndex != GetClusterIndex(currentTileIndex))
+				path.push_back(GetTilePosition(tileIndex));
+			else if (tileIndex != currentTileIndex)
+			{
+				SearchArea(GetClusterBounds(clusterIndex), currentTileIndex, tileIndex);
+				AppendAreaPath(GetClusterBounds(clusterIndex), tileIndex, path);
+			}
+
+			currentTileIndex = tileIndex;
+		}
+
+		if (currentTileIndex != endTileIndex)
+		{
+			SearchArea(GetClusterBounds(endClusterIndex), currentTileIndex, endTileIndex);
+			AppendAreaPath(GetClusterBounds(endClusterIndex), endTileIndex, path);
+		}
+
+		return true;
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::FindWaypoints(Position startPos, Position endPos, std::vector<Position> & waypointList)
+	{
+		assert(startPos.x >= 0 && static_cast<size_t>(startPos.x) < width && startPos.y >= 0 && static_cast<size_t>(startPos.y) < height && "HierarchicalPathfinder: The start tile lies outside the map");
+		assert(endPos.x >= 0 && static_cast<size_t>(endPos.x) < width && endPos.y >= 0 && static_cast<size_t>(endPos.y) < height && "HierarchicalPathfinder: The end tile lies outside the map");
+
+		waypointList.clear();
+
+		if (connectivity != nullptr && connectivity->IsReachable(startPos, endPos) == false)
+			return false;
+
+		Update();
+
+		const size_t startTileIndex = GetTileIndex(startPos);
+		const size_t endTileIndex = GetTileIndex(endPos);
+
+		TileBounds neighbourhoodBounds;
+		if (GetNeighbourhoodBounds(GetClusterIndex(startTileIndex), GetClusterIndex(endTileIndex), neighbourhoodBounds) && SearchArea(neighbourhoodBounds, startTileIndex, endTileIndex))
+		{
+			waypointList.push_back(startPos);
+			waypointList.push_back(endPos);
+			return true;
+		}
+
+		if (FindAbstractPath(startTileIndex, endTileIndex) == false)
+			return false;
+
+		waypointList.push_back(startPos);
+		for (const auto nodeId : abstractPath)
+		{
+			const size_t tileIndex = GetNode(nodeId).tileIndex;
+
+			// The start tile may be connected to a neighbouring cluster through one of its neighbours
+			if (waypointList.size() == 1 && GetClusterIndex(tileIndex) != GetClusterIndex(startTileIndex) && IsReachable(startTileIndex, tileIndex) == false)
+				waypointList.push_back(GetTilePosition(FindStartNeighbour(startTileIndex, tileIndex)));
+
+			if (tileIndex != startTileIndex && tileIndex != endTileIndex)
+				waypointList.push_back(GetTilePosition(tileIndex));
+		}
+		waypointList.push_back(endPos);
+
+		return true;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		if (size.x == 0u || size.y == 0u)
+			return;
+
+		// The tiles next to the changed area may reach different tiles now, so the area is grown by one tile
+		const long long left = std::max(static_cast<long long>(position.x) - 1, 0ll);
+		const long long top = std::max(static_cast<long long>(position.y) - 1, 0ll);
+		const long long right = std::min(static_cast<long long>(position.x) + size.x, static_cast<long long>(width) - 1);
+		const long long bottom = std::min(static_cast<long long>(position.y) + size.y, static_cast<long long>(height) - 1);
+		if (left > right || top > bottom)
+			return;
+
+		for (size_t y = static_cast<size_t>(top) / clusterSize; y <= static_cast<size_t>(bottom) / clusterSize; y++)
+		{
+			for (size_t x = static_cast<size_t>(left) / clusterSize; x <= static_cast<size_t>(right) / clusterSize; x++)
+				clusterList[y * clusterCountX + x].dirty = true;
+		}
+
+		dirty = true;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::Update()
+	{
+		if (dirty == false)
+			return;
+
+		// The transitions to all eight neighbours of a dirty cluster are rebuilt
+		// If they change, the nodes of the neighbour change as well
+		std::vector<bool> nodesChangedList(clusterList.size(), false);
+		for (size_t clusterIndex = 0; clusterIndex < clusterList.size(); clusterIndex++)
+		{
+			if (clusterList[clusterIndex].dirty == false)
+				continue;
+
+			nodesChangedList[clusterIndex] = true;
+			for (const auto side : { Right, Bottom, BottomRight, BottomLeft })
+			{
+				const auto offset = GetSideOffset(side);
+				const size_t neighbourIndex = GetAdjacentClusterIndex(clusterIndex, offset.x, offset.y);
+				if (BuildTransitions(clusterIndex, side))
+					nodesChangedList[neighbourIndex] = true;
+
+				// The neighbour on the opposite side stores the transitions to this cluster
+				const size_t ownerIndex = GetAdjacentClusterIndex(clusterIndex, -offset.x, -offset.y);
+				if (ownerIndex != detail::INVALID_NODE_INDEX && BuildTransitions(ownerIndex, side))
+					nodesChangedList[ownerIndex] = true;
+			}
+
+			clusterList[clusterIndex].dirty = false;
+		}
+
+		for (size_t clusterIndex = 0; clusterIndex < clusterList.size(); clusterIndex++)
+		{
+			if (nodesChangedList[clusterIndex])
+			{
+				BuildNodes(clusterIndex);
+				clusterList[clusterIndex].intraEdgesBuilt = false;
+			}
+		}
+
+		// The inter edges refer to the nodes of the neighbouring clusters
+		for (size_t clusterIndex = 0; clusterIndex < clusterList.size(); clusterIndex++)
+		{
+			bool neighbourhoodChanged = false;
+			for (int offsetY = -1; offsetY <= 1; offsetY++)
+			{
+				for (int offsetX = -1; offsetX <= 1; offsetX++)
+				{
+					const size_t neighbourIndex = GetAdjacentClusterIndex(clusterIndex, offsetX, offsetY);
+					neighbourhoodChanged = neighbourhoodChanged || (neighbourIndex != detail::INVALID_NODE_INDEX && nodesChangedList[neighbourIndex]);
+				}
+			}
+
+			if (neighbourhoodChanged)
+				BuildInterEdges(clusterIndex);
+		}
+
+		dirty = false;
+	}
+
+	template <class TTileMap>
+	size_t HierarchicalPathfinder<TTileMap>::GetAbstractNodeCount() const
+	{
+		size_t nodeCount = 0;
+		for (const auto & cluster : clusterList)
+			nodeCount += cluster.nodeList.size();
+
+		return nodeCount;
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::FindAbstractPath(size_t startTileIndex, size_t endTileIndex)
+	{
+		const size_t startNodeId = abstractSearchSpace.GetNodeCount() - 2;
+		const size_t endNodeId = abstractSearchSpace.GetNodeCount() - 1;
+		const size_t startClusterIndex = GetClusterIndex(startTileIndex);
+		const size_t endClusterIndex = GetClusterIndex(endTileIndex);
+		const auto & endCluster = clusterList[endClusterIndex];
+		const Position endPos = GetTilePosition(endTileIndex);
+
+		abstractPath.clear();
+		abstractSearchSpace.Reset();
+
+		// Connect the nodes of the end cluster to the end tile
+		// A single search from the end tile along the reversed moves finds the costs from all nodes
+		const auto endBounds = GetClusterBounds(endClusterIndex);
+		BuildAreaGraph(endBounds, areaGraph);
+		ReverseAreaGraph(areaGraph, reverseAreaGraph);
+		SearchAreaGraph(reverseAreaGraph, GetLocalIndex(endBounds, endTileIndex));
+		endCostList.resize(endCluster.nodeList.size());
+		for (size_t slot = 0; slot < endCluster.nodeList.size(); slot++)
+			endCostList[slot] = areaCostList[GetLocalIndex(endBounds, endCluster.nodeList[slot].tileIndex)];
+
+		// Connect the start tile to the nodes of the start cluster
+		const auto connectStart = [this, &endPos, startNodeId](size_t clusterIndex, size_t tileIndex, float cost)
+		{
+			const auto bounds = GetClusterBounds(clusterIndex);
+			const auto & nodeList = clusterList[clusterIndex].nodeList;
+			SearchArea(bounds, tileIndex, detail::INVALID_NODE_INDEX);
+			for (size_t slot = 0; slot < nodeList.size(); slot++)
+			{
+				const float nodeCost = areaCostList[GetLocalIndex(bounds, nodeList[slot].tileIndex)];
+				if (nodeCost != std::numeric_limits<float>::infinity())
+					abstractSearchSpace.Relax(GetNodeId(clusterIndex, slot), cost + nodeCost, detail::PathStepDistance(GetTilePosition(nodeList[slot].tileIndex), endPos), startNodeId,
+						detail::PathDistance(GetTilePosition(nodeList[slot].tileIndex), endPos));
+			}
+		};
+		connectStart(startClusterIndex, startTileIndex, 0.f);
+
+		// A start tile that can not be reached from its neighbours (e.g. an unwalkable tile) is not represented by the transitions,
+		// so the nodes of the neighbouring clusters are connected through its neighbours
+		for (const auto & neighbourPosition : detail::GetReachableTileList(map, GetTilePosition(startTileIndex)))
+		{
+			const size_t neighbourTileIndex = GetTileIndex(neighbourPosition);
+			if (GetClusterIndex(neighbourTileIndex) != startClusterIndex && IsReachable(neighbourTileIndex, startTileIndex) == false)
+				connectStart(GetClusterIndex(neighbourTileIndex), neighbourTileIndex, map.GetTileMovementSpeed(neighbourPosition.x, neighbourPosition.y));
+		}
+
+		while (abstractSearchSpace.HasOpenNodes())
+		{
+			const size_t nodeId = abstractSearchSpace.PopOpenNode();
+			if (nodeId == endNodeId)
+			{
+				for (size_t id = abstractSearchSpace.GetParent(endNodeId); id != startNodeId; id = abstractSearchSpace.GetParent(id))
+					abstractPath.push_back(id);
+
+				std::reverse(abstractPath.begin(), abstractPath.end());
+				return true;
+			}
+
+			const size_t clusterIndex = nodeId / maxNodeCountPerCluster;
+			if (clusterList[clusterIndex].intraEdgesBuilt == false)
+				BuildIntraEdges(clusterIndex);
+
+			const float g = abstractSearchSpace.GetG(nodeId);
+			const auto & node = GetNode(nodeId);
+
+			for (const auto * edgeList : { &node.intraEdgeList, &node.interEdgeList })
+			{
+				for (const auto & edge : *edgeList)
+				{
+					// Most edges lead to nodes that have already been reached at a lower cost, for which the heuristic is not needed
+					if (abstractSearchSpace.IsClosed(edge.nodeId) || (abstractSearchSpace.IsVisited(edge.nodeId) && abstractSearchSpace.GetG(edge.nodeId) <= g + edge.cost))
+						continue;
+
+					abstractSearchSpace.Relax(edge.nodeId, g + edge.cost, detail::PathStepDistance(edge.position, endPos), nodeId, detail::PathDistance(edge.position, endPos));
+				}
+			}
+
+			if (clusterIndex == endClusterIndex && endCostList[nodeId % maxNodeCountPerCluster] != std::numeric_limits<float>::infinity())
+				abstractSearchSpace.Relax(endNodeId, g + endCostList[nodeId % maxNodeCountPerCluster], 0.f, nodeId);
+		}
+
+		return false;
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::BuildTransitions(size_t clusterIndex, Side side)
+	{
+		std::vector<Transition> transitionList;
+		const auto bounds = GetClusterBounds(clusterIndex);
+		const auto offset = GetSideOffset(side);
+		const size_t neighbourIndex = GetAdjacentClusterIndex(clusterIndex, offset.x, offset.y);
+
+		const auto makeTransition = [this](size_t fromTileIndex, size_t toTileIndex)
+		{
+			Transition transition;
+			transition.fromTileIndex = fromTileIndex;
+			transition.toTileIndex = toTileIndex;
+			transition.forward = IsReachable(fromTileIndex, toTileIndex) && CanBeEntered(fromTileIndex);
+			transition.backward = IsReachable(toTileIndex, fromTileIndex) && CanBeEntered(toTileIndex);
+			return transition;
+		};
+
+		if (neighbourIndex == detail::INVALID_NODE_INDEX)
+		{
+			// No transitions
+		}
+		else if (side == BottomRight || side == BottomLeft)
+		{
+			// A single diagonal move between the corners
+			const auto neighbourBounds = GetClusterBounds(neighbourIndex);
+			const size_t bottom = bounds.top + bounds.height - 1;
+			const auto transition = side == BottomRight
+				? makeTransition(bottom * width + bounds.left + bounds.width - 1, (bottom + 1) * width + neighbourBounds.left)
+				: makeTransition(bottom * width + bounds.left, (bottom + 1) * width + neighbourBounds.left + neighbourBounds.width - 1);
+
+			if (transition.forward || transition.backward)
+				transitionList.push_back(transition);
+		}
+		else
+		{
+			// Walk along the border and collect the runs of border tiles that are connected to the neighbour in at least one direction (the entrances)
+			// Besides the tile straight across, the two tiles diagonally across are checked as long as they belong to the neighbour
+			const unsigned int borderLength = side == Right ? bounds.height : bounds.width;
+			const auto getBorderTileIndex = [&](unsigned int i) -> size_t
+			{
+				return side == Right
+					? (bounds.top + i) * width + bounds.left + bounds.width - 1
+					: (bounds.top + bounds.height - 1) * width + bounds.left + i;
+			};
+			const auto getAcrossTileIndex = [&](unsigned int i) -> size_t
+			{
+				return side == Right ? getBorderTileIndex(i) + 1 : getBorderTileIndex(i) + width;
+			};
+
+			std::vector<unsigned int> entrance;
+			std::vector<Transition> entranceTransitionList;
+			std::vector<Transition> tileTransitionList;
+			bool entranceTwoWay = false;
+			for (unsigned int i = 0; i <= borderLength; i++)
+			{
+				tileTransitionList.clear();
+				bool twoWay = false;
+				if (i < borderLength)
+				{
+					for (unsigned int j = (i > 0 ? i - 1 : 0); j <= i + 1 && j < borderLength; j++)
+					{
+						const auto transition = makeTransition(getBorderTileIndex(i), getAcrossTileIndex(j));
+						if (transition.forward || transition.backward)
+						{
+							tileTransitionList.push_back(transition);
+							twoWay = twoWay || (transition.forward && transition.backward);
+						}
+					}
+
+					// A tile that is only connected in one direction (e.g. an unwalkable tile from which its neighbours can be reached) starts a separate entrance
+					// Otherwise, it could be chosen for an entrance instead of the tiles that are connected in both directions
+					if (tileTransitionList.empty() == false && (entrance.empty() || twoWay == entranceTwoWay))
+					{
+						entrance.push_back(i);
+						entranceTwoWay = twoWay;
+						entranceTransitionList.insert(entranceTransitionList.end(), tileTransitionList.begin(), tileTransitionList.end());
+						continue;
+					}
+				}
+
+				// The entrance has ended
+				// Long entrances get transitions at both ends, short ones in the middle
+				const auto addTransitions = [&](unsigned int borderIndex)
+				{
+					for (const auto & transition : entranceTransitionList)
+					{
+						if (transition.fromTileIndex == getBorderTileIndex(borderIndex))
+							transitionList.push_back(transition);
+					}
+				};
+
+				if (entrance.size() >= detail::MIN_DOUBLE_TRANSITION_ENTRANCE_LENGTH)
+				{
+					addTransitions(entrance.front());
+					addTransitions(entrance.back());
+				}
+				else if (entrance.empty() == false)
+				{
+					addTransitions(entrance[entrance.size() / 2]);
+				}
+
+				entrance.clear();
+				entranceTransitionList.clear();
+
+				// The tile that has ended the entrance starts the next one
+				if (tileTransitionList.empty() == false)
+				{
+					entrance.push_back(i);
+					entranceTwoWay = twoWay;
+					entranceTransitionList.insert(entranceTransitionList.end(), tileTransitionList.begin(), tileTransitionList.end());
+				}
+			}
+		}
+
+		auto & oldTransitionList = clusterList[clusterIndex].transitionList[side];
+		const bool changed = std::equal(transitionList.cbegin(), transitionList.cend(), oldTransitionList.cbegin(), oldTransitionList.cend(), [](const Transition & a, const Transition & b)
+			{
+				return a.fromTileIndex == b.fromTileIndex && a.toTileIndex == b.toTileIndex && a.forward == b.forward && a.backward == b.backward;
+			}) == false;
+
+		oldTransitionList = std::move(transitionList);
+		return changed;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::BuildNodes(size_t clusterIndex)
+	{
+		auto & nodeList = clusterList[clusterIndex].nodeList;
+
+		// The tiles of this cluster that are part of a transition
+		std::vector<size_t> tileIndexList;
+		for (const auto side : { Right, Bottom, BottomRight, BottomLeft })
+		{
+			for (const auto & transition : clusterList[clusterIndex].transitionList[side])
+				tileIndexList.push_back(transition.fromTileIndex);
+
+			const auto offset = GetSideOffset(side);
+			const size_t ownerIndex = GetAdjacentClusterIndex(clusterIndex, -offset.x, -offset.y);
+			if (ownerIndex == detail::INVALID_NODE_INDEX)
+				continue;
+
+			for (const auto & transition : clusterList[ownerIndex].transitionList[side])
+				tileIndexList.push_back(transition.toTileIndex);
+		}
+
+		// A tile may be part of several transitions
+		std::sort(tileIndexList.begin(), tileIndexList.end());
+		tileIndexList.erase(std::unique(tileIndexList.begin(), tileIndexList.end()), tileIndexList.end());
+		assert(tileIndexList.size() <= maxNodeCountPerCluster);
+
+		nodeList.clear();
+		for (const auto tileIndex : tileIndexList)
+			nodeList.push_back({ tileIndex, {}, {} });
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::BuildIntraEdges(size_t clusterIndex)
+	{
+		auto & nodeList = clusterList[clusterIndex].nodeList;
+		const auto bounds = GetClusterBounds(clusterIndex);
+		BuildAreaGraph(bounds, areaGraph);
+
+		for (auto & node : nodeList)
+		{
+			node.intraEdgeList.clear();
+			SearchAreaGraph(areaGraph, GetLocalIndex(bounds, node.tileIndex));
+
+			for (size_t slot = 0; slot < nodeList.size(); slot++)
+			{
+				const float cost = areaCostList[GetLocalIndex(bounds, nodeList[slot].tileIndex)];
+				if (nodeList[slot].tileIndex != node.tileIndex && cost != std::numeric_limits<float>::infinity())
+					node.intraEdgeList.push_back({ GetNodeId(clusterIndex, slot), cost, GetTilePosition(nodeList[slot].tileIndex) });
+			}
+		}
+
+		clusterList[clusterIndex].intraEdgesBuilt = true;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::BuildInterEdges(size_t clusterIndex)
+	{
+		auto & cluster = clusterList[clusterIndex];
+
+		for (auto & node : cluster.nodeList)
+			node.interEdgeList.clear();
+
+		// Adds the edge from the tile of this cluster to the tile of the other cluster
+		const auto addEdge = [this, &cluster, clusterIndex](size_t tileIndex, size_t otherTileIndex)
+		{
+			const size_t otherClusterIndex = GetClusterIndex(otherTileIndex);
+			const size_t slot = FindNodeSlot(clusterIndex, tileIndex);
+			const size_t otherSlot = FindNodeSlot(otherClusterIndex, otherTileIndex);
+			assert(slot != detail::INVALID_NODE_INDEX && otherSlot != detail::INVALID_NODE_INDEX);
+
+			const Position otherPosition = GetTilePosition(otherTileIndex);
+			cluster.nodeList[slot].interEdgeList.push_back({ GetNodeId(otherClusterIndex, otherSlot), map.GetTileMovementSpeed(otherPosition.x, otherPosition.y), otherPosition });
+		};
+
+		for (const auto side : { Right, Bottom, BottomRight, BottomLeft })
+		{
+			for (const auto & transition : cluster.transitionList[side])
+			{
+				if (transition.forward)
+					addEdge(transition.fromTileIndex, transition.toTileIndex);
+			}
+
+			const auto offset = GetSideOffset(side);
+			const size_t ownerIndex = GetAdjacentClusterIndex(clusterIndex, -offset.x, -offset.y);
+			if (ownerIndex == detail::INVALID_NODE_INDEX)
+				continue;
+
+			for (const auto & transition : clusterList[ownerIndex].transitionList[side])
+			{
+				if (transition.backward)
+					addEdge(transition.toTileIndex, transition.fromTileIndex);
+			}
+		}
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::SearchArea(const TileBounds & bounds, size_t startTileIndex, size_t endTileIndex)
+	{
+		const bool searchAll = endTileIndex == detail::INVALID_NODE_INDEX;
+		const Position endPos = searchAll ? Position() : GetTilePosition(endTileIndex);
+		const size_t endLocalIndex = searchAll ? detail::INVALID_NODE_INDEX : GetLocalIndex(bounds, endTileIndex);
+		const size_t startLocalIndex = GetLocalIndex(bounds, startTileIndex);
+
+		const size_t tileCount = static_cast<size_t>(bounds.width) * bounds.height;
+		areaCostList.assign(tileCount, std::numeric_limits<float>::infinity());
+		areaParentList.resize(tileCount);
+		areaClosedList.assign(tileCount, 0);
+		areaSearchOpenList.clear();
+
+		areaCostList[startLocalIndex] = 0.f;
+		areaParentList[startLocalIndex] = detail::INVALID_NODE_INDEX;
+		areaSearchOpenList.emplace_back(0.f, 0.f, static_cast<unsigned int>(startLocalIndex));
+		while (areaSearchOpenList.empty() == false)
+		{
+			std::pop_heap(areaSearchOpenList.begin(), areaSearchOpenList.end(), std::greater<>());
+			const size_t localIndex = std::get<2>(areaSearchOpenList.back());
+			areaSearchOpenList.pop_back();
+
+			// The first entry of a tile has the lowest cost, since its heuristic does not change
+			if (areaClosedList[localIndex] != 0)
+				continue;
+			areaClosedList[localIndex] = 1;
+
+			if (localIndex == endLocalIndex)
+				return true;
+
+			const Position position(static_cast<decltype(Position::x)>(bounds.left + localIndex % bounds.width), static_cast<decltype(Position::y)>(bounds.top + localIndex / bounds.width));
+			const float g = areaCostList[localIndex];
+			for (const auto & succeedingPosition : detail::GetReachableTileList(map, position))
+			{
+				// The search does not leave the area
+				if (succeedingPosition.x < static_cast<long long>(bounds.left) || succeedingPosition.x >= static_cast<long long>(bounds.left + bounds.width)
+					|| succeedingPosition.y < static_cast<long long>(bounds.top) || succeedingPosition.y >= static_cast<long long>(bounds.top + bounds.height))
+					continue;
+
+				const size_t succeedingIndex = static_cast<size_t>(succeedingPosition.y - bounds.top) * bounds.width + static_cast<size_t>(succeedingPosition.x - bounds.left);
+				const float succeedingG = g + map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y);
+				if (areaClosedList[succeedingIndex] != 0 || succeedingG >= areaCostList[succeedingIndex])
+					continue;
+
+				areaCostList[succeedingIndex] = succeedingG;
+				areaParentList[succeedingIndex] = localIndex;
+
+				const float h = searchAll ? 0.f : detail::PathStepDistance(succeedingPosition, endPos);
+				const float distance = searchAll ? 0.f : detail::PathDistance(succeedingPosition, endPos);
+				areaSearchOpenList.emplace_back(succeedingG + h, distance, static_cast<unsigned int>(succeedingIndex));
+				std::push_heap(areaSearchOpenList.begin(), areaSearchOpenList.end(), std::greater<>());
+			}
+		}
+
+		return searchAll;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::BuildAreaGraph(const TileBounds & bounds, AreaGraph & graph) const
+	{
+		const unsigned int tileCount = bounds.width * bounds.height;
+		graph.edgeBeginList.resize(tileCount + 1);
+		graph.edgeList.clear();
+		graph.minCost = std::numeric_limits<float>::infinity();
+		graph.maxCost = 0.f;
+
+		for (unsigned int localIndex = 0u; localIndex < tileCount; localIndex++)
+		{
+			graph.edgeBeginList[localIndex] = static_cast<unsigned int>(graph.edgeList.size());
+
+			const Position position(static_cast<decltype(Position::x)>(bounds.left + localIndex % bounds.width), static_cast<decltype(Position::y)>(bounds.top + localIndex / bounds.width));
+			for (const auto & succeedingPosition : detail::GetReachableTileList(map, position))
+			{
+				if (succeedingPosition.x < static_cast<long long>(bounds.left) || succeedingPosition.x >= static_cast<long long>(bounds.left + bounds.width)
+					|| succeedingPosition.y < static_cast<long long>(bounds.top) || succeedingPosition.y >= static_cast<long long>(bounds.top + bounds.height))
+					continue;
+
+				const unsigned int succeedingIndex = static_cast<unsigned int>(succeedingPosition.y - bounds.top) * bounds.width + static_cast<unsigned int>(succeedingPosition.x - bounds.left);
+				const float cost = map.GetTileMovementSpeed(succeedingPosition.x, succeedingPosition.y);
+				graph.edgeList.push_back({ succeedingIndex, cost });
+				graph.minCost = std::min(graph.minCost, cost);
+				graph.maxCost = std::max(graph.maxCost, cost);
+			}
+		}
+		graph.edgeBeginList[tileCount] = static_cast<unsigned int>(graph.edgeList.size());
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::ReverseAreaGraph(const AreaGraph & graph, AreaGraph & reverseGraph)
+	{
+		const size_t tileCount = graph.edgeBeginList.size() - 1;
+		reverseGraph.minCost = graph.minCost;
+		reverseGraph.maxCost = graph.maxCost;
+
+		// Count the moves to each tile
+		reverseGraph.edgeBeginList.assign(tileCount + 1, 0u);
+		for (const auto & edge : graph.edgeList)
+			reverseGraph.edgeBeginList[edge.localIndex + 1]++;
+		for (size_t i = 1; i <= tileCount; i++)
+			reverseGraph.edgeBeginList[i] += reverseGraph.edgeBeginList[i - 1];
+
+		// The edge begin list is used as the insert position of each tile and shifted back afterwards
+		reverseGraph.edgeList.resize(graph.edgeList.size());
+		for (unsigned int localIndex = 0u; localIndex < tileCount; localIndex++)
+		{
+			for (unsigned int i = graph.edgeBeginList[localIndex]; i < graph.edgeBeginList[localIndex + 1]; i++)
+			{
+				const auto & edge = graph.edgeList[i];
+				reverseGraph.edgeList[reverseGraph.edgeBeginList[edge.localIndex]++] = { localIndex, edge.cost };
+			}
+		}
+		for (size_t i = tileCount; i > 0; i--)
+			reverseGraph.edgeBeginList[i] = reverseGraph.edgeBeginList[i - 1];
+		reverseGraph.edgeBeginList[0] = 0u;
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::SearchAreaGraph(const AreaGraph & graph, size_t startLocalIndex)
+	{
+		areaCostList.assign(graph.edgeBeginList.size() - 1, std::numeric_limits<float>::infinity());
+		areaCostList[startLocalIndex] = 0.f;
+
+		// A tile is put into the bucket floor(cost / minCost). Since every move costs at least minCost, no tile of a bucket can
+		// lower the cost of another tile of the same bucket, so the tiles of a bucket can be expanded in any order (Dinitz's algorithm).
+		// The costs of the tiles in the open buckets differ by at most maxCost, so the buckets are reused in a ring.
+		// The open buckets may contain a tile several times (only its cheapest entry is expanded).
+		const float bucketWidth = graph.minCost;
+		const float bucketCount = graph.edgeList.empty() ? 1.f : std::floor(graph.maxCost / bucketWidth) + 2.f;
+		if (bucketWidth > 0.f && bucketCount <= detail::MAX_AREA_SEARCH_BUCKET_COUNT)
+		{
+			areaBucketList.resize(std::max(areaBucketList.size(), static_cast<size_t>(bucketCount)));
+			for (auto & bucket : areaBucketList)
+				bucket.clear();
+
+			areaBucketList[0].push_back({ 0.f, static_cast<unsigned int>(startLocalIndex) });
+			size_t openCount = 1;
+			for (size_t bucketIndex = 0; openCount > 0; bucketIndex++)
+			{
+				auto & bucket = areaBucketList[bucketIndex % static_cast<size_t>(bucketCount)];
+
+				// Rounding may put a tile into the current bucket, so it can grow while it is expanded
+				for (size_t i = 0; i < bucket.size(); i++)
+				{
+					const auto entry = bucket[i];
+					openCount--;
+					if (entry.first > areaCostList[entry.second])
+						continue;
+
+					for (unsigned int j = graph.edgeBeginList[entry.second]; j < graph.edgeBeginList[entry.second + 1]; j++)
+					{
+						const auto & edge = graph.edgeList[j];
+						const float succeedingCost = entry.first + edge.cost;
+						if (succeedingCost < areaCostList[edge.localIndex])
+						{
+							areaCostList[edge.localIndex] = succeedingCost;
+							const size_t succeedingBucketIndex = std::max(static_cast<size_t>(succeedingCost / bucketWidth), bucketIndex);
+							areaBucketList[succeedingBucketIndex % static_cast<size_t>(bucketCount)].push_back({ succeedingCost, edge.localIndex });
+							openCount++;
+						}
+					}
+				}
+				bucket.clear();
+			}
+			return;
+		}
+
+		// The costs of the moves differ too much (or are 0), so a binary heap is used
+		areaOpenList.clear();
+		areaOpenList.push_back({ 0.f, static_cast<unsigned int>(startLocalIndex) });
+		while (areaOpenList.empty() == false)
+		{
+			std::pop_heap(areaOpenList.begin(), areaOpenList.end(), std::greater<>());
+			const auto entry = areaOpenList.back();
+			areaOpenList.pop_back();
+			if (entry.first > areaCostList[entry.second])
+				continue;
+
+			for (unsigned int i = graph.edgeBeginList[entry.second]; i < graph.edgeBeginList[entry.second + 1]; i++)
+			{
+				const auto & edge = graph.edgeList[i];
+				const float cost = entry.first + edge.cost;
+				if (cost < areaCostList[edge.localIndex])
+				{
+					areaCostList[edge.localIndex] = cost;
+					areaOpenList.push_back({ cost, edge.localIndex });
+					std::push_heap(areaOpenList.begin(), areaOpenList.end(), std::greater<>());
+				}
+			}
+		}
+	}
+
+	template <class TTileMap>
+	void HierarchicalPathfinder<TTileMap>::AppendAreaPath(const TileBounds & bounds, size_t endTileIndex, std::vector<Position> & path)
+	{
+		const size_t pathBegin = path.size();
+
+		// The start tile has no parent
+		for (size_t localIndex = GetLocalIndex(bounds, endTileIndex); areaParentList[localIndex] != detail::INVALID_NODE_INDEX; localIndex = areaParentList[localIndex])
+			path.push_back(GetTilePosition((bounds.top + localIndex / bounds.width) * width + bounds.left + localIndex % bounds.width));
+
+		std::reverse(path.begin() + pathBegin, path.end());
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::IsReachable(size_t fromTileIndex, size_t toTileIndex) const
+	{
+		const Position toPosition = GetTilePosition(toTileIndex);
+		const auto reachableTileList = detail::GetReachableTileList(map, GetTilePosition(fromTileIndex));
+		return std::find(reachableTileList.begin(), reachableTileList.end(), toPosition) != reachableTileList.end();
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::CanBeEntered(size_t tileIndex) const
+	{
+		if constexpr (detail::HasReachableTileMask<TTileMap>::value)
+		{
+			const Position position = GetTilePosition(tileIndex);
+			for (unsigned int i = 0u; i < ReachableTileList<Position>::MAX_TILE_COUNT; i++)
+			{
+				const long long x = static_cast<long long>(position.x) + detail::TILE_NEIGHBOUR_OFFSET_X[i];
+				const long long y = static_cast<long long>(position.y) + detail::TILE_NEIGHBOUR_OFFSET_Y[i];
+				if (x < 0 || y < 0 || x >= static_cast<long long>(width) || y >= static_cast<long long>(height))
+					continue;
+
+				// The bit of the move from the neighbour back to the tile
+				const TileNeighbourMask neighbourBit = detail::GetTileNeighbourBit(-detail::TILE_NEIGHBOUR_OFFSET_X[i], -detail::TILE_NEIGHBOUR_OFFSET_Y[i]);
+				if (map.GetReachableTileMask(static_cast<int>(x), static_cast<int>(y)) & neighbourBit)
+					return true;
+			}
+			return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+
+	template <class TTileMap>
+	size_t HierarchicalPathfinder<TTileMap>::FindStartNeighbour(size_t startTileIndex, size_t nodeTileIndex)
+	{
+		const size_t clusterIndex = GetClusterIndex(nodeTileIndex);
+		const auto bounds = GetClusterBounds(clusterIndex);
+
+		size_t bestTileIndex = detail::INVALID_NODE_INDEX;
+		float bestCost = std::numeric_limits<float>::infinity();
+		for (const auto & neighbourPosition : detail::GetReachableTileList(map, GetTilePosition(startTileIndex)))
+		{
+			const size_t neighbourTileIndex = GetTileIndex(neighbourPosition);
+			if (GetClusterIndex(neighbourTileIndex) != clusterIndex || SearchArea(bounds, neighbourTileIndex, nodeTileIndex) == false)
+				continue;
+
+			const float cost = map.GetTileMovementSpeed(neighbourPosition.x, neighbourPosition.y) + areaCostList[GetLocalIndex(bounds, nodeTileIndex)];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestTileIndex = neighbourTileIndex;
+			}
+		}
+
+		assert(bestTileIndex != detail::INVALID_NODE_INDEX);
+		SearchArea(bounds, bestTileIndex, nodeTileIndex);
+		return bestTileIndex;
+	}
+
+	template <class TTileMap>
+	size_t HierarchicalPathfinder<TTileMap>::FindNodeSlot(size_t clusterIndex, size_t tileIndex) const
+	{
+		const auto & nodeList = clusterList[clusterIndex].nodeList;
+		const auto it = std::lower_bound(nodeList.cbegin(), nodeList.cend(), tileIndex, [](const AbstractNode & node, size_t value) { return node.tileIndex < value; });
+		if (it == nodeList.cend() || it->tileIndex != tileIndex)
+			return detail::INVALID_NODE_INDEX;
+
+		return static_cast<size_t>(it - nodeList.cbegin());
+	}
+
+	template <class TTileMap>
+	typename HierarchicalPathfinder<TTileMap>::TileBounds HierarchicalPathfinder<TTileMap>::GetClusterBounds(size_t clusterIndex) const
+	{
+		TileBounds bounds;
+		bounds.left = static_cast<unsigned int>((clusterIndex % clusterCountX) * clusterSize);
+		bounds.top = static_cast<unsigned int>((clusterIndex / clusterCountX) * clusterSize);
+		// The clusters at the right and bottom border may be smaller
+		bounds.width = static_cast<unsigned int>(std::min<size_t>(clusterSize, width - bounds.left));
+		bounds.height = static_cast<unsigned int>(std::min<size_t>(clusterSize, height - bounds.top));
+		return bounds;
+	}
+
+	template <class TTileMap>
+	bool HierarchicalPathfinder<TTileMap>::GetNeighbourhoodBounds(size_t clusterIndex, size_t otherClusterIndex, TileBounds & bounds) const
+	{
+		const long long offsetX = static_cast<long long>(otherClusterIndex % clusterCountX) - static_cast<long long>(clusterIndex % clusterCountX);
+		const long long offsetY = static_cast<long long>(otherClusterIndex / clusterCountX) - static_cast<long long>(clusterIndex / clusterCountX);
+		if (offsetX < -1 || offsetX > 1 || offsetY < -1 || offsetY > 1)
+			return false;
+
+		const auto clusterBounds = GetClusterBounds(clusterIndex);
+		const auto otherClusterBounds = GetClusterBounds(otherClusterIndex);
+		bounds.left = std::min(clusterBounds.left, otherClusterBounds.left);
+		bounds.top = std::min(clusterBounds.top, otherClusterBounds.top);
+		bounds.width = std::max(clusterBounds.left + clusterBounds.width, otherClusterBounds.left + otherClusterBounds.width) - bounds.left;
+		bounds.height = std::max(clusterBounds.top + clusterBounds.height, otherClusterBounds.top + otherClusterBounds.height) - bounds.top;
+		return true;
+	}
+
+	template <class TTileMap>
+	size_t HierarchicalPathfinder<TTileMap>::GetAdjacentClusterIndex(size_t clusterIndex, int offsetX, int offsetY) const
+	{
+		const long long x = static_cast<long long>(clusterIndex % clusterCountX) + offsetX;
+		const long long y = static_cast<long long>(clusterIndex / clusterCountX) + offsetY;
+		if (x < 0 || y < 0 || x >= static_cast<long long>(clusterCountX) || y >= static_cast<long long>(clusterCountY))
+			return detail::INVALID_NODE_INDEX;
+
+		return static_cast<size_t>(y) * clusterCountX + static_cast<size_t>(x);
+	}
+
+	template <class TTileMap>
+	sf::Vector2i HierarchicalPathfinder<TTileMap>::GetSideOffset(Side side)
+	{
+		switch (side)
+		{
+		case Right:
+			return { 1, 0 };
+		case Bottom:
+			return { 0, 1 };
+		case BottomRight:
+			return { 1, 1 };
+		case BottomLeft:
+			return { -1, 1 };
+		default:
+			assert(false && "HierarchicalPathfinder: Invalid side");
+			return { 0, 0 };
+		}
+	}
+
+	template <class TTileMap>
+	inline typename HierarchicalPathfinder<TTileMap>::Position HierarchicalPathfinder<TTileMap>::GetTilePosition(size_t tileIndex) const
+	{
+		Position position;
+		position.x = static_cast<decltype(position.x)>(tileIndex % width);
+		position.y = static_cast<decltype(position.y)>(tileIndex / width);
+		return position;
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -0,0 +1,228 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::IndexedHeap
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <cassert>
+#include <functional>
+
+namespace mbe
+{
+	/// @brief A binary min heap of indices in the range [0, capacity) that allows changing the key of an index while it is in the heap
+	/// @details Every index can be in the heap at most once. The position of each index in the heap is stored,
+	/// so that Contains() is O(1) and Update() and Remove() are O(log n).
+	/// @n The memory is allocated when the capacity is set. Clear() only touches the indices that are still in the heap,
+	/// so reusing the heap for many searches does not allocate.
+	/// @tparam TKey The type of the key by which the indices are ordered
+	/// @tparam TCompare A function object that returns true if the first key is smaller than the second one.
+	/// The index with the smallest key is at the top of the heap.
+	template <typename TKey, class TCompare = std::less<TKey>>
+	class IndexedHeap
+	{
+	public:
+		/// @brief Constructor
+		/// @param capacity The number of indices that can be stored in the heap
+		explicit IndexedHeap(size_t capacity = 0);
+
+		/// @brief Default destructor
+		~IndexedHeap() = default;
+
+	public:
+		/// @brief Removes all indices and sets the capacity
+		void SetCapacity(size_t capacity);
+
+		/// @brief Adds an index to the heap
+		/// @details The index must be smaller than the capacity and must not be in the heap yet.
+		void Push(size_t index, const TKey& key);
+
+		/// @brief Changes the key of an index that is in the heap
+		/// @details The key may become smaller (decrease key) or larger.
+		void Update(size_t index, const TKey& key);
+
+		/// @brief Removes the index with the smallest key from the heap and returns it
+		/// @details The heap must not be empty.
+		size_t Pop();
+
+		/// @brief Removes an index from the heap
+		/// @details The index must be in the heap.
+		void Remove(size_t index);
+
+		/// @brief Removes all indices from the heap
+		/// @details Only the indices that are in the heap are touched, so the complexity does not depend on the capacity.
+		void Clear();
+
+		/// @brief Returns the index with the smallest key
+		/// @details The heap must not be empty.
+		inline size_t Top() const { assert(heap.empty() == false && "IndexedHeap: The heap is empty"); return heap.front().index; }
+
+		/// @brief Returns the smallest key
+		/// @details The heap must not be empty.
+		inline const TKey& TopKey() const { assert(heap.empty() == false && "IndexedHeap: The heap is empty"); return heap.front().key; }
+
+		/// @brief Returns the key of an index that is in the heap
+		inline const TKey& GetKey(size_t index) const { assert(Contains(index)); return heap[positionList[index]].key; }
+
+		inline bool Contains(size_t index) const { return positionList[index] != NOT_IN_HEAP; }
+
+		inline bool IsEmpty() const { return heap.empty(); }
+
+		inline size_t GetSize() const { return heap.size(); }
+
+		inline size_t GetCapacity() const { return positionList.size(); }
+
+	private:
+		struct Entry
+		{
+			size_t index;
+			TKey key;
+		};
+
+		void SiftUp(size_t position);
+		void SiftDown(size_t position);
+
+		// Moves the entry to the position and updates the position list
+		inline void Place(size_t position, Entry&& entry);
+
+	private:
+		static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+		std::vector<Entry> heap;
+		// The position of each index in the heap or NOT_IN_HEAP
+		std::vector<size_t> positionList;
+		TCompare compare;
+	};
+
+#pragma region Template Implementations
+
+	template<typename TKey, class TCompare>
+	inline IndexedHeap<TKey, TCompare>::IndexedHeap(size_t capacity)
+	{
+		SetCapacity(capacity);
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::SetCapacity(size_t capacity)
+	{
+		heap.clear();
+		heap.reserve(capacity);
+		positionList.assign(capacity, NOT_IN_HEAP);
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::Push(size_t index, const TKey& key)
+	{
+		assert(index < positionList.size() && "IndexedHeap: The index exceeds the capacity");
+		assert(Contains(index) == false && "IndexedHeap: The index is already in the heap");
+
+		heap.push_back({ index, key });
+		positionList[index] = heap.size() - 1;
+		SiftUp(heap.size() - 1);
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::Update(size_t index, const TKey& key)
+	{
+		assert(Contains(index) && "IndexedHeap: The index is not in the heap");
+
+		const size_t position = positionList[index];
+		const bool decreased = compare(key, heap[position].key);
+		heap[position].key = key;
+
+		if (decreased)
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+
+	template<typename TKey, class TCompare>
+	inline size_t IndexedHeap<TKey, TCompare>::Pop()
+	{
+		const size_t index = Top();
+		Remove(index);
+		return index;
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::Remove(size_t index)
+	{
+		assert(Contains(index) && "IndexedHeap: The index is not in the heap");
+
+		const size_t position = positionList[index];
+		positionList[index] = NOT_IN_HEAP;
+
+		// Fill the gap with the last entry and restore the heap property
+		Entry last = std::move(heap.back());
+		heap.pop_back();
+		if (position == heap.size())
+			return;
+
+		const bool decreased = compare(last.key, heap[position].key);
+		Place(position, std::move(last));
+
+		if (decreased)
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::Clear()
+	{
+		for (const auto& entry : heap)
+			positionList[entry.index] = NOT_IN_HEAP;
+
+		heap.clear();
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::SiftUp(size_t position)
+	{
+		Entry entry = std::move(heap[position]);
+		while (position > 0)
+		{
+			const size_t parent = (position - 1) / 2;
+			if (compare(entry.key, heap[parent].key) == false)
+				break;
+
+			Place(position, std::move(heap[parent]));
+			position = parent;
+		}
+		Place(position, std::move(entry));
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::SiftDown(size_t position)
+	{
+		Entry entry = std::move(heap[position]);
+		while (true)
+		{
+			size_t child = 2 * position + 1;
+			if (child >= heap.size())
+				break;
+
+			// Pick the smaller child
+			if (child + 1 < heap.size() && compare(heap[child + 1].key, heap[child].key))
+				child++;
+
+			if (compare(heap[child].key, entry.key) == false)
+				break;
+
+			Place(position, std::move(heap[child]));
+			position = child;
+		}
+		Place(position, std::move(entry));
+	}
+
+	template<typename TKey, class TCompare>
+	inline void IndexedHeap<TKey, TCompare>::Place(size_t position, Entry&& entry)
+	{
+		positionList[entry.index] = position;
+		heap[position] = std::move(entry);
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -0,0 +1,383 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::PathCache
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <ostream>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/AStarPathfinder.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The default width and height of the cells of the mbe::PathCache in tiles
+		constexpr unsigned int DEFAULT_PATH_CACHE_CELL_SIZE = 8u;
+
+		/// @brief The default number of paths kept by the mbe::PathCache
+		constexpr size_t DEFAULT_PATH_CACHE_CAPACITY = 1024;
+	} // namespace detail
+
+	/// @brief The number of hits, misses and removed paths of a mbe::PathCache
+	struct PathCacheStatistics
+	{
+		/// @brief The number of queries that have been answered from the cache
+		size_t hitCount = 0;
+		/// @brief The number of queries for which a search has been performed
+		size_t missCount = 0;
+		/// @brief The number of paths that have been removed because tiles on or next to them have changed
+		size_t invalidatedPathCount = 0;
+		/// @brief The number of paths that have been removed to make space for new ones
+		size_t evictedPathCount = 0;
+
+		/// @brief Returns the share of queries that have been answered from the cache or 0 if there have been no queries
+		inline float GetHitRate() const { return hitCount + missCount == 0 ? 0.f : static_cast<float>(hitCount) / static_cast<float>(hitCount + missCount); }
+	};
+
+	/// @brief Allows the statistics to be written to an out stream
+	inline std::ostream & operator<<(std::ostream & stream, const PathCacheStatistics & statistics)
+	{
+		stream << "Path cache:\tHits: " << statistics.hitCount << "\tMisses: " << statistics.missCount
+			<< "\tHit rate: " << statistics.GetHitRate() * 100.f << "%"
+			<< "\tInvalidated: " << statistics.invalidatedPathCount << "\tEvicted: " << statistics.evictedPathCount;
+		return stream;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Finds paths with a mbe::AStarPathfinder and keeps them for queries with a nearby start and the same goal
+	/// @details The map is divided into square cells. A path is stored under the cell of its start and its goal tile.
+	/// A query whose start lies in the same cell is answered from the cache if the start is on the stored path or next to it.
+	/// The returned path then continues along the stored path from the last tile of it that can be reached from the start.
+	/// Such a path may be slightly longer than the best path, but it is valid as long as the tiles have not changed.
+	/// @n For every stored path, the cells of the tiles it traverses are recorded. When tiles change, only the paths
+	/// that traverse the cells of the changed tiles (or of the tiles next to them) are removed. Queries for which no path
+	/// has been found are cached as well, but are removed by every change.
+	/// @n The cache subscribes to the mbe::event::TileMapChangedEvent, which is raised by the mbe::TileMapComponent.
+	/// Other changes to the walkability of tiles must be passed to InvalidateTiles() or raised as such an event.
+	/// @n When the cache is full, the least recently used path is removed.
+	/// @tparam TTileMap The type of tile map. It has the same requirements as for the mbe::AStarPathfinder.
+	template <class TTileMap>
+	class PathCache
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap The tile map on which the pathfinding is performed. Its size must not change.
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent
+		/// @param cellSize The width and height of the cells in tiles
+		/// @param capacity The maximum number of paths that are kept
+		PathCache(const TTileMap & tileMap, EventManager & eventManager, unsigned int cellSize = detail::DEFAULT_PATH_CACHE_CELL_SIZE, size_t capacity = detail::DEFAULT_PATH_CACHE_CAPACITY);
+
+		/// @brief Default destructor
+		~PathCache() = default;
+
+	public:
+		/// @brief Returns a cached path or finds a new one
+		/// @param startPos The start position
+		/// @param endPos The end position
+		/// @param path The list the path is written to. It is cleared if no path could be found.
+		/// @returns True if a path has been found, false otherwise
+		bool FindPath(Position startPos, Position endPos, std::vector<Position> & path);
+
+		/// @brief Returns a cached path or finds a new one
+		/// @returns The path as a list of positions. If no path could be found, an empty list is returned
+		std::vector<Position> FindPath(Position startPos, Position endPos);
+
+		/// @brief Removes the paths that may be affected by changing the tiles in the area
+		/// @param position The top left tile of the area
+		/// @param size The number of tiles in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Removes all paths
+		void Clear();
+
+		inline const PathCacheStatistics & GetStatistics() const { return statistics; }
+
+		inline void ResetStatistics() { statistics = PathCacheStatistics(); }
+
+		/// @brief Returns the number of paths that are currently kept
+		inline size_t GetSize() const { return entryDictionary.size(); }
+
+		inline size_t GetCapacity() const { return capacity; }
+
+		inline unsigned int GetCellSize() const { return cellSize; }
+
+	private:
+		struct Entry
+		{
+			bool found;
+			std::vector<Position> path;
+			// The sorted indices of the cells traversed by the path
+			std::vector<size_t> cellIndexList;
+			// The position of the key in the use list
+			std::list<unsigned long long>::iterator useIterator;
+		};
+
+		// Answers the query from the entry if the start is on the path or next to it
+		bool CopyCachedPath(const Entry & entry, Position startPos, std::vector<Position> & path) const;
+
+		void AddEntry(unsigned long long key, Position startPos, bool found, const std::vector<Position> & path);
+
+		void RemoveEntry(unsigned long long key);
+
+		inline unsigned long long GetKey(Position startPos, Position endPos) const;
+
+		inline size_t GetTileIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline size_t GetCellIndex(Position position) const;
+
+	private:
+		const TTileMap & map;
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
+
+		AStarPathfinder<TTileMap> pathfinder;
+
+		const size_t width;
+		const size_t height;
+		const unsigned int cellSize;
+		const size_t cellCountX;
+		const size_t capacity;
+
+		// Indexed by the start cell and the goal tile
+		std::unordered_map<unsigned long long, Entry> entryDictionary;
+		// The keys of the entries whose path traverses each cell
+		std::vector<std::vector<unsigned long long>> cellEntryKeyList;
+		// The keys of the entries for which no path has been found
+		std::vector<unsigned long long> notFoundEntryKeyList;
+		// The keys of all entries from the most to the least recently used one
+		std::list<unsigned long long> useList;
+
+		PathCacheStatistics statistics;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	PathCache<TTileMap>::PathCache(const TTileMap & tileMap, EventManager & eventManager, unsigned int cellSize, size_t capacity) :
+		map(tileMap),
+		pathfinder(tileMap),
+		width(tileMap.GetSize().x),
+		height(tileMap.GetSize().y),
+		cellSize(cellSize),
+		cellCountX((tileMap.GetSize().x + cellSize - 1) / cellSize),
+		capacity(capacity)
+	{
+		assert(cellSize > 0u && "PathCache: The cell size must be at least one");
+		assert(capacity > 0 && "PathCache: The capacity must be at least one");
+
+		cellEntryKeyList.resize(cellCountX * ((height + cellSize - 1) / cellSize));
+
+		tileMapChangedSubscription.Subscribe(eventManager, *this);
+	}
+
+	template <class TTileMap>
+	bool PathCache<TTileMap>::FindPath(Position startPos, Position endPos, std::vector<Position> & path)
+	{
+		const auto key = GetKey(startPos, endPos);
+
+		auto it = entryDictionary.find(key);
+		if (it != entryDictionary.end())
+		{
+			auto & entry = it->second;
+			if (entry.found == false && entry.path.front() == startPos)
+			{
+				statistics.hitCount++;
+				useList.splice(useList.begin(), useList, entry.useIterator);
+				path.clear();
+				return false;
+			}
+
+			if (entry.found && CopyCachedPath(entry, startPos, path))
+			{
+				statistics.hitCount++;
+				useList.splice(useList.begin(), useList, entry.useIterator);
+				return true;
+			}
+		}
+
+		statistics.missCount++;
+		const bool found = pathfinder.FindPath(startPos, endPos, path);
+
+		// The new result replaces the one of the other start in the same cell
+		if (it != entryDictionary.end())
+			RemoveEntry(key);
+		AddEntry(key, startPos, found, path);
+
+		return found;
+	}
+
+	template <class TTileMap>
+	std::vector<typename PathCache<TTileMap>::Position> PathCache<TTileMap>::FindPath(Position startPos, Position endPos)
+	{
+		std::vector<Position> path;
+		FindPath(startPos, endPos, path);
+		return path;
+	}
+
+	template <class TTileMap>
+	void PathCache<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		if (size.x == 0u || size.y == 0u)
+			return;
+
+		// The tiles next to the changed area may reach different tiles now, so the area is grown by one tile
+		const long long left = std::max(static_cast<long long>(position.x) - 1, 0ll);
+		const long long top = std::max(static_cast<long long>(position.y) - 1, 0ll);
+		const long long right = std::min(static_cast<long long>(position.x) + size.x, static_cast<long long>(width) - 1);
+		const long long bottom = std::min(static_cast<long long>(position.y) + size.y, static_cast<long long>(height) - 1);
+		if (left > right || top > bottom)
+			return;
+
+		// A changed tile may connect the start and the goal of any query without a path
+		while (notFoundEntryKeyList.empty() == false)
+		{
+			RemoveEntry(notFoundEntryKeyList.back());
+			statistics.invalidatedPathCount++;
+		}
+
+		for (long long cellY = top / cellSize; cellY <= bottom / cellSize; cellY++)
+		{
+			for (long long cellX = left / cellSize; cellX <= right / cellSize; cellX++)
+			{
+				auto & entryKeyList = cellEntryKeyList[static_cast<size_t>(cellY) * cellCountX + static_cast<size_t>(cellX)];
+				while (entryKeyList.empty() == false)
+				{
+					RemoveEntry(entryKeyList.back());
+					statistics.invalidatedPathCount++;
+				}
+			}
+		}
+	}
+
+	template <class TTileMap>
+	void PathCache<TTileMap>::Clear()
+	{
+		entryDictionary.clear();
+		notFoundEntryKeyList.clear();
+		useList.clear();
+		for (auto & entryKeyList : cellEntryKeyList)
+			entryKeyList.clear();
+	}
+
+	template <class TTileMap>
+	bool PathCache<TTileMap>::CopyCachedPath(const Entry & entry, Position startPos, std::vector<Position> & path) const
+	{
+		const auto & cachedPath = entry.path;
+
+		// Continue from the tile of the path that is closest to the goal and can be reached from the start
+		size_t continueIndex = cachedPath.size();
+		for (size_t i = cachedPath.size(); i-- > 0;)
+		{
+			if (cachedPath[i] == startPos)
+			{
+				continueIndex = i + 1;
+				break;
+			}
+		}
+
+		if (continueIndex == cachedPath.size() && cachedPath.back() != startPos)
+		{
+			const auto reachableTileList = detail::GetReachableTileList(map, startPos);
+			for (size_t i = cachedPath.size(); i-- > 0;)
+			{
+				if (std::find(reachableTileList.begin(), reachableTileList.end(), cachedPath[i]) != reachableTileList.end())
+				{
+					continueIndex = i;
+					break;
+				}
+			}
+
+			if (continueIndex == cachedPath.size())
+				return false;
+		}
+
+		path.clear();
+		path.push_back(startPos);
+		path.insert(path.end(), cachedPath.begin() + continueIndex, cachedPath.end());
+		return true;
+	}
+
+	template <class TTileMap>
+	void PathCache<TTileMap>::AddEntry(unsigned long long key, Position startPos, bool found, const std::vector<Position> & path)
+	{
+		if (entryDictionary.size() >= capacity)
+		{
+			RemoveEntry(useList.back());
+			statistics.evictedPathCount++;
+		}
+
+		Entry & entry = entryDictionary[key];
+		entry.found = found;
+		useList.push_front(key);
+		entry.useIterator = useList.begin();
+
+		if (found == false)
+		{
+			// Only the start is stored, since queries from other starts in the cell may succeed
+			entry.path.assign(1, startPos);
+			notFoundEntryKeyList.push_back(key);
+			return;
+		}
+
+		entry.path = path;
+		for (const auto & position : path)
+			entry.cellIndexList.push_back(GetCellIndex(position));
+
+		std::sort(entry.cellIndexList.begin(), entry.cellIndexList.end());
+		entry.cellIndexList.erase(std::unique(entry.cellIndexList.begin(), entry.cellIndexList.end()), entry.cellIndexList.end());
+
+		for (const auto cellIndex : entry.cellIndexList)
+			cellEntryKeyList[cellIndex].push_back(key);
+	}
+
+	template <class TTileMap>
+	void PathCache<TTileMap>::RemoveEntry(unsigned long long key)
+	{
+		auto it = entryDictionary.find(key);
+		assert(it != entryDictionary.end());
+
+		const auto removeKey = [key](std::vector<unsigned long long> & keyList)
+		{
+			keyList.erase(std::find(keyList.begin(), keyList.end(), key));
+		};
+
+		if (it->second.found == false)
+			removeKey(notFoundEntryKeyList);
+
+		for (const auto cellIndex : it->second.cellIndexList)
+			removeKey(cellEntryKeyList[cellIndex]);
+
+		useList.erase(it->second.useIterator);
+		entryDictionary.erase(it);
+	}
+
+	template <class TTileMap>
+	inline unsigned long long PathCache<TTileMap>::GetKey(Position startPos, Position endPos) const
+	{
+		assert(startPos.x >= 0 && static_cast<size_t>(startPos.x) < width && startPos.y >= 0 && static_cast<size_t>(startPos.y) < height && "PathCache: The start tile lies outside the map");
+		assert(endPos.x >= 0 && static_cast<size_t>(endPos.x) < width && endPos.y >= 0 && static_cast<size_t>(endPos.y) < height && "PathCache: The end tile lies outside the map");
+
+		return static_cast<unsigned long long>(GetCellIndex(startPos)) * width * height + GetTileIndex(endPos);
+	}
+
+	template <class TTileMap>
+	inline size_t PathCache<TTileMap>::GetCellIndex(Position position) const
+	{
+		return (static_cast<size_t>(position.y) / cellSize) * cellCountX + static_cast<size_t>(position.x) / cellSize;
+	}
+
+#pragma endregion
+
+} // namespace mbe
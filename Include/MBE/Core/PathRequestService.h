@@ -0,0 +1,563 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::PathRequestService
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <MBE/Core/AStarPathfinder.h>
+#include <MBE/Core/TileConnectivity.h>
+#include <MBE/Core/ThreadPool.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Core/EntityRemovedEvent.h>
+#include <MBE/Map/PathFoundEvent.h>
+#include <MBE/Map/GoalInaccessibleEvent.h>
+#include <MBE/Map/ReachableTileList.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The default time the mbe::PathRequestService may spend on searches per frame
+		constexpr int DEFAULT_PATH_REQUEST_TIME_BUDGET_MILLISECONDS = 2;
+
+		/// @brief Presents a tile map to a pathfinder as seen by an agent that covers more than one tile
+		/// @details The position of the agent is its top left tile. A tile is walkable if all tiles covered by the agent are walkable
+		/// and the movement speed is the largest one of the covered tiles. Diagonal moves are only possible if both adjacent straight moves are.
+		/// @n An agent of size 1x1 sees the tile map unchanged.
+		template <class TTileMap>
+		class AgentFootprintTileMap
+		{
+		public:
+			typedef typename TTileMap::Position Position;
+
+			// The mask of a 1x1 agent is the one of the tile map, which may not provide one
+			static constexpr bool HAS_REACHABLE_TILE_MASK = detail::HasReachableTileMask<TTileMap>::value;
+
+		public:
+			AgentFootprintTileMap(const TTileMap & tileMap, sf::Vector2u agentSize);
+			~AgentFootprintTileMap() = default;
+
+		public:
+			inline auto GetSize() const { return tileMap.GetSize(); }
+
+			bool IsTileWalkable(int x, int y) const;
+
+			float GetTileMovementSpeed(int x, int y) const;
+
+			std::vector<Position> GetReachableTiles(int x, int y) const;
+			inline std::vector<Position> GetReachableTiles(Position position) const { return GetReachableTiles(position.x, position.y); }
+
+			TileNeighbourMask GetReachableTileMask(int x, int y) const;
+
+			inline sf::Vector2u GetAgentSize() const { return agentSize; }
+
+		private:
+			inline bool IsSingleTile() const { return agentSize.x == 1u && agentSize.y == 1u; }
+
+		private:
+			const TTileMap & tileMap;
+			const sf::Vector2u agentSize;
+		};
+
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Finds the paths requested by entities on worker threads
+	/// @details Requests are queued and processed in the order of their priority. Each worker owns its pathfinders,
+	/// so the search state is only allocated once per worker and agent size.
+	/// @n Update() must be called once per frame on the thread that owns the mbe::EventManager. It delivers the results
+	/// of the previous frame and starts processing the queue. For every found path, a mbe::event::PathFoundEvent is raised.
+	/// If the goal can not be reached, a mbe::event::GoalInaccessibleEvent is raised instead.
+	/// @n The searches of a frame stop once their combined duration exceeds the time budget. The remaining requests are processed in the next frames.
+	/// @n An entity can only have one request at a time. Requesting a new path or removing the entity cancels the previous request
+	/// and its result is never delivered, even if the search has already started.
+	/// @n When a mbe::ThreadPool is set, the searches run on its threads while the frame continues. The tile map must not be changed
+	/// until Wait() or Update() has been called. Without a thread pool, the searches run on the calling thread during Update().
+	/// @tparam TTileMap The type of tile map the pathfinding is performed on. Its position type must be sf::Vector2i (like mbe::TileMapBase::Position).
+	/// @tparam searchMode The algorithm used by the mbe::AStarPathfinder
+	template <class TTileMap, PathSearchMode searchMode = PathSearchMode::AStar>
+	class PathRequestService : private sf::NonCopyable
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+		typedef AStarPathfinder<detail::AgentFootprintTileMap<TTileMap>, searchMode> Pathfinder;
+
+		static_assert(std::is_same<Position, event::PathFoundEvent::Path::value_type>::value, "PathRequestService: The position type must be sf::Vector2i");
+
+	public:
+		/// @brief Constructor
+		/// @param tileMap The tile map on which the pathfinding is performed. Its size must not change.
+		/// @param eventManager The event manager through which the results are delivered
+		/// @param threadPool If not null, the searches run on the threads of the thread pool
+		PathRequestService(const TTileMap & tileMap, EventManager & eventManager, ThreadPool * threadPool = nullptr);
+
+		/// @brief Destructor
+		/// @details Waits for the running searches to complete. Results that have not been delivered are discarded.
+		~PathRequestService();
+
+	public:
+		/// @brief Requests a path for an entity
+		/// @details If the entity has already requested a path, the previous request is cancelled.
+		/// @param entityId The entity for which the result is raised
+		/// @param start The start position
+		/// @param goal The goal position
+		/// @param priority Requests with a higher priority are processed first. Requests with the same priority are processed in the order they have been made.
+		/// @param agentSize The number of tiles covered by the agent in the x and y direction. The positions refer to its top left tile.
+		void Request(Entity::ID entityId, Position start, Position goal, int priority = 0, sf::Vector2u agentSize = sf::Vector2u(1u, 1u));
+
+		/// @brief Cancels the request of an entity
+		/// @details If the search has already completed, the result is discarded. Nothing happens if the entity has no request.
+		void Cancel(Entity::ID entityId);
+
+		/// @brief Delivers the results of the previous frame and starts processing the requests for this frame
+		/// @details Waits for the searches of the previous frame first (they normally completed long before).
+		/// @throws Rethrows the first exception that has been thrown by a search
+		void Update();
+
+		/// @brief Waits until the searches of this frame have completed
+		/// @details Call this before changing the tile map. The results are delivered by the next call to Update().
+		/// @throws Rethrows the first exception that has been thrown by a search
+		void Wait();
+
+		/// @brief Sets the time the searches may take per frame
+		/// @details The searches of different threads are added up. A search that has been started is always completed,
+		/// so at least one request is processed per frame. If zero, all requests are processed every frame.
+		inline void SetTimeBudget(sf::Time timeBudget) { std::lock_guard lock(mutex); this->timeBudget = timeBudget; }
+
+		inline sf::Time GetTimeBudget() const { std::lock_guard lock(mutex); return timeBudget; }
+
+		/// @brief Sets the thread pool on which the searches run
+		/// @details Waits for the searches of this frame. If null, the searches run on the thread that calls Update().
+		inline void SetThreadPool(ThreadPool * threadPool) { Wait(); this->threadPool = threadPool; }
+
+		/// @brief Sets the connectivity labels that are used to reject unreachable goals without searching
+		/// @details A request whose goal is in a different component than its start is answered by the next call to Update()
+		/// without using the time budget. This also holds for larger agents, since they can only move where a single tile agent can move.
+		/// The labels must be kept up to date by calling mbe::TileConnectivity::InvalidateTiles() when the tile map changes.
+		/// @param connectivity The labels of the tile map or nullptr to search for every request. They must outlive the service.
+		inline void SetConnectivity(const TileConnectivity<TTileMap> * connectivity) { std::lock_guard lock(mutex); this->connectivity = connectivity; }
+
+		/// @brief Returns the number of requests that have been made but whose result has not been delivered yet
+		inline size_t GetRequestCount() const { std::lock_guard lock(mutex); return requestDictionary.size(); }
+
+	private:
+		struct RequestData
+		{
+			Position start;
+			Position goal;
+			sf::Vector2u agentSize;
+			// Identifies the request if the entity makes a new one
+			unsigned long long requestNumber;
+		};
+
+		struct QueueEntry
+		{
+			int priority;
+			unsigned long long requestNumber;
+			Entity::ID entityId;
+
+			// Higher priorities first, then the older requests
+			inline bool operator<(const QueueEntry & other) const
+			{
+				return priority != other.priority ? priority < other.priority : requestNumber > other.requestNumber;
+			}
+		};
+
+		struct Result
+		{
+			Entity::ID entityId;
+			unsigned long long requestNumber;
+			bool found;
+			event::PathFoundEvent::Path path;
+		};
+
+		// A pathfinder and the map for a single agent size
+		struct Searcher
+		{
+			Searcher(const TTileMap & tileMap, sf::Vector2u agentSize) : footprintTileMap(tileMap, agentSize), pathfinder(footprintTileMap) {}
+
+			detail::AgentFootprintTileMap<TTileMap> footprintTileMap;
+			Pathfinder pathfinder;
+		};
+
+		// The pathfinders used by one thread at a time
+		struct Worker
+		{
+			std::vector<std::unique_ptr<Searcher>> searcherList;
+		};
+
+		// Processes requests until the queue is empty or the time budget is used up
+		void ProcessRequests(Worker & worker);
+
+		// Returns false if there is no request left that should be processed this frame
+		bool PopRequest(Entity::ID & entityId, RequestData & request);
+
+		Searcher & GetSearcher(Worker & worker, sf::Vector2u agentSize);
+
+		void DeliverResults();
+
+		// Must be called with the mutex locked
+		Worker & AcquireWorker();
+
+		// Must be called with the mutex locked
+		void RemoveRequest(Entity::ID entityId);
+
+	private:
+		const TTileMap & tileMap;
+		EventManager & eventManager;
+		ThreadPool * threadPool;
+		EventManager::SubscriptionID entityRemovedSubscription;
+		const TileConnectivity<TTileMap> * connectivity;
+
+		// Everything below is guarded by the mutex
+		mutable std::mutex mutex;
+		std::unordered_map<Entity::ID, RequestData> requestDictionary;
+		// Contains outdated entries for cancelled requests which are skipped when popped
+		std::priority_queue<QueueEntry> requestQueue;
+		std::vector<Result> resultList;
+		unsigned long long nextRequestNumber;
+		sf::Time timeBudget;
+		sf::Time frameSearchTime;
+
+		std::vector<std::unique_ptr<Worker>> workerList;
+		// The workers that are not used by a running task
+		std::vector<Worker*> idleWorkerList;
+		// Only accessed by the thread that calls Update()
+		std::vector<std::future<void>> taskFutureList;
+		// Only accessed by the thread that calls Update()
+		std::vector<Result> deliveredResultList;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	detail::AgentFootprintTileMap<TTileMap>::AgentFootprintTileMap(const TTileMap & tileMap, sf::Vector2u agentSize) :
+		tileMap(tileMap),
+		agentSize(agentSize)
+	{
+		assert(agentSize.x > 0u && agentSize.y > 0u && "AgentFootprintTileMap: The agent must cover at least one tile");
+	}
+
+	template <class TTileMap>
+	bool detail::AgentFootprintTileMap<TTileMap>::IsTileWalkable(int x, int y) const
+	{
+		if (IsSingleTile())
+			return tileMap.IsTileWalkable(x, y);
+
+		const auto size = tileMap.GetSize();
+		if (x < 0 || y < 0 || static_cast<long long>(x) + agentSize.x > static_cast<long long>(size.x) || static_cast<long long>(y) + agentSize.y > static_cast<long long>(size.y))
+			return false;
+
+		for (unsigned int offsetY = 0u; offsetY < agentSize.y; offsetY++)
+		{
+			for (unsigned int offsetX = 0u; offsetX < agentSize.x; offsetX++)
+			{
+				if (tileMap.IsTileWalkable(x + static_cast<int>(offsetX), y + static_cast<int>(offsetY)) == false)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	template <class TTileMap>
+	float detail::AgentFootprintTileMap<TTileMap>::GetTileMovementSpeed(int x, int y) const
+	{
+		if (IsSingleTile())
+			return tileMap.GetTileMovementSpeed(x, y);
+
+		float movementSpeed = 0.f;
+		for (unsigned int offsetY = 0u; offsetY < agentSize.y; offsetY++)
+		{
+			for (unsigned int offsetX = 0u; offsetX < agentSize.x; offsetX++)
+				movementSpeed = std::max(movementSpeed, tileMap.GetTileMovementSpeed(x + static_cast<int>(offsetX), y + static_cast<int>(offsetY)));
+		}
+		return movementSpeed;
+	}
+
+	template <class TTileMap>
+	std::vector<typename detail::AgentFootprintTileMap<TTileMap>::Position> detail::AgentFootprintTileMap<TTileMap>::GetReachableTiles(int x, int y) const
+	{
+		if (IsSingleTile())
+			return tileMap.GetReachableTiles(x, y);
+
+		const ReachableTileList<Position> reachableTileList(Position(x, y), GetReachableTileMask(x, y));
+		return std::vector<Position>(reachableTileList.begin(), reachableTileList.end());
+	}
+
+	template <class TTileMap>
+	TileNeighbourMask detail::AgentFootprintTileMap<TTileMap>::GetReachableTileMask(int x, int y) const
+	{
+		if (IsSingleTile())
+			return detail::GetReachableTileMask(tileMap, Position(x, y));
+
+		TileNeighbourMask neighbourMask = 0u;
+		for (unsigned int i = 0u; i < ReachableTileList<Position>::MAX_TILE_COUNT; i++)
+		{
+			const int offsetX = detail::TILE_NEIGHBOUR_OFFSET_X[i];
+			const int offsetY = detail::TILE_NEIGHBOUR_OFFSET_Y[i];
+
+			if (IsTileWalkable(x + offsetX, y + offsetY) == false)
+				continue;
+
+			// No corner cutting
+			if (offsetX != 0 && offsetY != 0 && (IsTileWalkable(x + offsetX, y) == false || IsTileWalkable(x, y + offsetY) == false))
+				continue;
+
+			neighbourMask |= static_cast<TileNeighbourMask>(1u << i);
+		}
+		return neighbourMask;
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	PathRequestService<TTileMap, searchMode>::PathRequestService(const TTileMap & tileMap, EventManager & eventManager, ThreadPool * threadPool) :
+		tileMap(tileMap),
+		eventManager(eventManager),
+		threadPool(threadPool),
+		connectivity(nullptr),
+		nextRequestNumber(0ull),
+		timeBudget(sf::milliseconds(detail::DEFAULT_PATH_REQUEST_TIME_BUDGET_MILLISECONDS)),
+		frameSearchTime(sf::Time::Zero)
+	{
+		// Removed entities can not use their path
+		std::function<void(const event::EntityRemovedEvent&)> onEntityRemovedFunction = [this](const event::EntityRemovedEvent& event)
+		{
+			Cancel(event.GetEntityID());
+		};
+
+		entityRemovedSubscription = eventManager.Subscribe(onEntityRemovedFunction);
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	PathRequestService<TTileMap, searchMode>::~PathRequestService()
+	{
+		eventManager.UnSubscribe<event::EntityRemovedEvent>(entityRemovedSubscription);
+
+		// The tasks must not outlive the service
+		for (auto & taskFuture : taskFutureList)
+			taskFuture.wait();
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::Request(Entity::ID entityId, Position start, Position goal, int priority, sf::Vector2u agentSize)
+	{
+		std::lock_guard lock(mutex);
+		RemoveRequest(entityId);
+
+		const auto requestNumber = nextRequestNumber++;
+		requestDictionary[entityId] = { start, goal, agentSize, requestNumber };
+
+		// The result is known without searching
+		if (connectivity != nullptr && connectivity->IsReachable(start, goal) == false)
+		{
+			resultList.push_back({ entityId, requestNumber, false, {} });
+			return;
+		}
+
+		requestQueue.push({ priority, requestNumber, entityId });
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::Cancel(Entity::ID entityId)
+	{
+		std::lock_guard lock(mutex);
+		RemoveRequest(entityId);
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::Update()
+	{
+		Wait();
+
+		{
+			std::lock_guard lock(mutex);
+			frameSearchTime = sf::Time::Zero;
+		}
+
+		if (threadPool == nullptr || threadPool->GetThreadCount() == 0)
+		{
+			// Process the requests on this thread, so that the results can be delivered right away
+			Worker * worker;
+			{
+				std::lock_guard lock(mutex);
+				worker = &AcquireWorker();
+			}
+
+			ProcessRequests(*worker);
+
+			std::lock_guard lock(mutex);
+			idleWorkerList.push_back(worker);
+		}
+
+		DeliverResults();
+
+		if (threadPool == nullptr || threadPool->GetThreadCount() == 0)
+			return;
+
+		// One task per thread unless there are fewer requests
+		std::lock_guard lock(mutex);
+		const size_t taskCount = std::min(threadPool->GetThreadCount(), requestQueue.size());
+		for (size_t i = 0; i < taskCount; i++)
+		{
+			Worker * worker = &AcquireWorker();
+			taskFutureList.push_back(threadPool->Enqueue([this, worker]()
+				{
+					ProcessRequests(*worker);
+
+					std::lock_guard lock(mutex);
+					idleWorkerList.push_back(worker);
+				}));
+		}
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::Wait()
+	{
+		auto taskFutureList = std::move(this->taskFutureList);
+		this->taskFutureList.clear();
+
+		// Wait for all tasks before rethrowing
+		for (auto & taskFuture : taskFutureList)
+			taskFuture.wait();
+
+		for (auto & taskFuture : taskFutureList)
+			taskFuture.get();
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::ProcessRequests(Worker & worker)
+	{
+		Entity::ID entityId;
+		RequestData request;
+		while (PopRequest(entityId, request))
+		{
+			sf::Clock clock;
+
+			Result result;
+			result.entityId = entityId;
+			result.requestNumber = request.requestNumber;
+			result.found = GetSearcher(worker, request.agentSize).pathfinder.FindPath(request.start, request.goal, result.path);
+
+			std::lock_guard lock(mutex);
+			frameSearchTime += clock.getElapsedTime();
+
+			// The request may have been cancelled during the search
+			auto it = requestDictionary.find(entityId);
+			if (it != requestDictionary.end() && it->second.requestNumber == request.requestNumber)
+				resultList.push_back(std::move(result));
+		}
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	bool PathRequestService<TTileMap, searchMode>::PopRequest(Entity::ID & entityId, RequestData & request)
+	{
+		std::lock_guard lock(mutex);
+		if (timeBudget != sf::Time::Zero && frameSearchTime >= timeBudget)
+			return false;
+
+		while (requestQueue.empty() == false)
+		{
+			const QueueEntry entry = requestQueue.top();
+			requestQueue.pop();
+
+			// Skip the entries of cancelled requests
+			auto it = requestDictionary.find(entry.entityId);
+			if (it == requestDictionary.end() || it->second.requestNumber != entry.requestNumber)
+				continue;
+
+			entityId = entry.entityId;
+			request = it->second;
+			return true;
+		}
+		return false;
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	typename PathRequestService<TTileMap, searchMode>::Searcher & PathRequestService<TTileMap, searchMode>::GetSearcher(Worker & worker, sf::Vector2u agentSize)
+	{
+		// There are usually only a few agent sizes
+		for (auto & searcher : worker.searcherList)
+		{
+			if (searcher->footprintTileMap.GetAgentSize() == agentSize)
+				return *searcher;
+		}
+
+		worker.searcherList.push_back(std::make_unique<Searcher>(tileMap, agentSize));
+		return *worker.searcherList.back();
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::DeliverResults()
+	{
+		{
+			std::lock_guard lock(mutex);
+			deliveredResultList.swap(resultList);
+		}
+
+		for (auto & result : deliveredResultList)
+		{
+			// The event callbacks may cancel or replace the requests whose results are delivered later
+			{
+				std::lock_guard lock(mutex);
+				auto it = requestDictionary.find(result.entityId);
+				if (it == requestDictionary.end() || it->second.requestNumber != result.requestNumber)
+					continue;
+
+				requestDictionary.erase(it);
+			}
+
+			if (result.found)
+			{
+				event::PathFoundEvent pathFoundEvent(result.entityId, std::move(result.path));
+				eventManager.RaiseEvent(pathFoundEvent);
+			}
+			else
+			{
+				event::GoalInaccessibleEvent goalInaccessibleEvent(result.entityId);
+				eventManager.RaiseEvent(goalInaccessibleEvent);
+			}
+		}
+		deliveredResultList.clear();
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	typename PathRequestService<TTileMap, searchMode>::Worker & PathRequestService<TTileMap, searchMode>::AcquireWorker()
+	{
+		if (idleWorkerList.empty())
+		{
+			workerList.push_back(std::make_unique<Worker>());
+			idleWorkerList.push_back(workerList.back().get());
+		}
+
+		Worker * worker = idleWorkerList.back();
+		idleWorkerList.pop_back();
+		return *worker;
+	}
+
+	template <class TTileMap, PathSearchMode searchMode>
+	void PathRequestService<TTileMap, searchMode>::RemoveRequest(Entity::ID entityId)
+	{
+		// The queue entry is skipped when it is popped
+		requestDictionary.erase(entityId);
+
+		resultList.erase(std::remove_if(resultList.begin(), resultList.end(), [&entityId](const Result & result) { return result.entityId == entityId; }), resultList.end());
+	}
+
+#pragma endregion
+
+} // namespace mbe
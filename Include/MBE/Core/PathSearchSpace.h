@@ -0,0 +1,117 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::detail::PathSearchSpace
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <cassert>
+
+#include <MBE/Core/IndexedHeap.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The parent index of a node that has no parent
+		constexpr size_t INVALID_NODE_INDEX = std::numeric_limits<size_t>::max();
+
+		/// @brief Pythagoras distance between two tile positions (used as the heuristic of the pathfinders)
+		template <typename TPosition>
+		inline float PathDistance(const TPosition& a, const TPosition& b)
+		{
+			const float dx = static_cast<float>(a.x) - static_cast<float>(b.x);
+			const float dy = static_cast<float>(a.y) - static_cast<float>(b.y);
+			return std::sqrt(dx * dx + dy * dy);
+		}
+
+		/// @brief The number of straight or diagonal moves between two tile positions
+		/// @details Unlike mbe::detail::PathDistance(), this never overestimates the cost of a path if every move costs at least 1.
+		template <typename TPosition>
+		inline float PathStepDistance(const TPosition& a, const TPosition& b)
+		{
+			const float dx = std::abs(static_cast<float>(a.x) - static_cast<float>(b.x));
+			const float dy = std::abs(static_cast<float>(a.y) - static_cast<float>(b.y));
+			return dx > dy ? dx : dy;
+		}
+
+		/// @brief The state of a best first search (A* or Dijkstra) over the nodes [0, nodeCount)
+		/// @details The g value, parent and open / closed state of each node are stored in flat arrays that are allocated once.
+		/// Instead of resetting these arrays before every search, each node stores the search (generation) in which it has last been visited.
+		/// Nodes of an older generation are treated as unvisited, so starting a new search is O(1).
+		/// The open list is a binary heap ordered by f = g + h that supports decreasing the key of an open node.
+		class PathSearchSpace
+		{
+		public:
+			/// @brief Constructor
+			/// @param nodeCount The number of nodes of the searched graph
+			explicit PathSearchSpace(size_t nodeCount = 0);
+
+			/// @brief Default destructor
+			~PathSearchSpace() = default;
+
+		public:
+			/// @brief Sets the number of nodes and resets the search
+			void SetNodeCount(size_t nodeCount);
+
+			/// @brief Starts a new search in which all nodes are unvisited
+			void Reset();
+
+			/// @brief Opens a node or updates it if the new route is better
+			/// @param nodeIndex The node that is reached
+			/// @param g The cost of the route to the node
+			/// @param h The heuristic estimate of the remaining cost
+			/// @param parentIndex The node from which the node is reached or INVALID_NODE_INDEX
+			/// @param tieBreak Orders the open nodes whose f and g values are equal. Smaller values come first (e.g. the straight line distance to the goal).
+			/// @returns False if the node is closed or has already been reached by a route that is at least as good, true otherwise
+			bool Relax(size_t nodeIndex, float g, float h, size_t parentIndex, float tieBreak = 0.f);
+
+			/// @brief Removes the open node with the smallest f value from the open list, closes it and returns it
+			/// @details The open list must not be empty.
+			size_t PopOpenNode();
+
+			inline bool HasOpenNodes() const { return openList.IsEmpty() == false; }
+
+			inline bool IsVisited(size_t nodeIndex) const { return generationList[nodeIndex] == generation; }
+
+			inline bool IsClosed(size_t nodeIndex) const { return IsVisited(nodeIndex) && closedList[nodeIndex] != 0; }
+
+			/// @brief Returns the cost of the best route to a node that has been visited in the current search
+			inline float GetG(size_t nodeIndex) const { assert(IsVisited(nodeIndex)); return gList[nodeIndex]; }
+
+			/// @brief Returns the parent of a node that has been visited in the current search
+			inline size_t GetParent(size_t nodeIndex) const { assert(IsVisited(nodeIndex)); return parentList[nodeIndex]; }
+
+			inline size_t GetNodeCount() const { return generationList.size(); }
+
+		private:
+			// Nodes with the same f value are ordered by their g value, so that the search goes on from the node that is closest to the goal
+			// Otherwise, a heuristic that is exact on open maps would expand every tile whose f value equals the cost of the path
+			// Many nodes also share their g value (e.g. all tiles of a wedge towards the goal with the step distance), so the tie break orders them
+			struct OpenKey
+			{
+				float f;
+				float g;
+				float tieBreak;
+			};
+
+			struct OpenKeyCompare
+			{
+				inline bool operator()(const OpenKey& a, const OpenKey& b) const { return a.f != b.f ? a.f < b.f : a.g != b.g ? a.g > b.g : a.tieBreak < b.tieBreak; }
+			};
+
+		private:
+			std::vector<float> gList;
+			std::vector<size_t> parentList;
+			std::vector<unsigned char> closedList;
+			std::vector<unsigned int> generationList;
+			unsigned int generation;
+
+			// The open nodes ordered by f = g + h
+			IndexedHeap<OpenKey, OpenKeyCompare> openList;
+		};
+
+	} // namespace detail
+
+} // namespace mbe
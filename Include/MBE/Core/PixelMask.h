@@ -20,6 +20,7 @@ namespace mbe
 
 	public:
 		PixelMask(const sf::Texture & texture);
+		PixelMask(const sf::Image & image);
 		// The sprite must have a texture - otherwise undefined behaviour
 		PixelMask(const sf::Sprite & sprite);
 		PixelMask(const sf::RectangleShape & rectangle);
@@ -32,6 +33,7 @@ namespace mbe
 
 	private:
 		void CreateMaskFromTexture(const sf::Texture &);
+		void CreateMaskFromImage(const sf::Image &);
 
 	private:
 		const sf::Vector2u pixelMaskSize; // Same as texture size
@@ -0,0 +1,90 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::ReservationTable
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+
+namespace mbe
+{
+	/// @brief Stores which agent occupies which tile at which time step
+	/// @details This is used for cooperative pathfinding (see mbe::CooperativePathfinder). Every agent reserves the tiles of its
+	/// path for the time steps at which it will be on them, so that agents that plan later can avoid them.
+	/// @n Only the reserved tiles are stored, so the size of the table does not depend on the size of the map or the number of time steps.
+	class ReservationTable
+	{
+	public:
+		/// @brief The index used to identify an agent (e.g. the index of a slot in a list)
+		typedef size_t AgentID;
+
+		/// @brief A time step
+		typedef unsigned long long Time;
+
+		/// @brief Returned by GetAgent() if a tile is not reserved
+		static constexpr AgentID NO_AGENT = std::numeric_limits<AgentID>::max();
+
+	private:
+		struct Key
+		{
+			size_t tileIndex;
+			Time time;
+
+			inline bool operator==(const Key & other) const { return tileIndex == other.tileIndex && time == other.time; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key & key) const;
+		};
+
+	public:
+		/// @brief Default constructor
+		ReservationTable() = default;
+
+		/// @brief Default destructor
+		~ReservationTable() = default;
+
+	public:
+		/// @brief Reserves a tile for an agent at a time step
+		/// @details A reservation of another agent is never overwritten.
+		/// @param tileIndex The index of the tile (y * width + x)
+		/// @param time The time step at which the agent is on the tile
+		/// @param agentId The agent that reserves the tile
+		/// @returns False if the tile has already been reserved by another agent, true otherwise
+		bool Reserve(size_t tileIndex, Time time, AgentID agentId);
+
+		/// @brief Returns the agent that has reserved a tile at a time step or NO_AGENT
+		AgentID GetAgent(size_t tileIndex, Time time) const;
+
+		/// @brief Returns whether a tile has been reserved by another agent at a time step
+		inline bool IsReserved(size_t tileIndex, Time time, AgentID agentId) const { const auto agent = GetAgent(tileIndex, time); return agent != NO_AGENT && agent != agentId; }
+
+		/// @brief Returns whether moving from one tile to another between a time step and the next one conflicts with another agent
+		/// @details This is the case if the destination is reserved at the next time step or if another agent moves in the opposite direction at the same time.
+		/// Waiting is a move where both tiles are the same.
+		bool IsMoveBlocked(size_t fromTileIndex, size_t toTileIndex, Time time, AgentID agentId) const;
+
+		/// @brief Removes all reservations of an agent
+		void Release(AgentID agentId);
+
+		/// @brief Removes the reservations of all agents before a time step
+		/// @details This should be called when the time advances, so that the table does not grow without bounds.
+		void ReleaseBefore(Time time);
+
+		/// @brief Removes all reservations
+		void Clear();
+
+		/// @brief Returns the number of reserved tiles of all time steps
+		inline size_t GetReservationCount() const { return reservationDictionary.size(); }
+
+	private:
+		std::unordered_map<Key, AgentID, KeyHash> reservationDictionary;
+
+		// The reservations of each agent in the order they have been made
+		std::vector<std::vector<Key>> agentReservationList;
+	};
+
+} // namespace mbe
@@ -0,0 +1,157 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::ThreadPool
+
+#include <vector>
+#include <thread>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <MBE/Core/SafeQueue.h>
+
+namespace mbe
+{
+	/// @brief A fixed number of worker threads that execute tasks in the order they have been enqueued
+	/// @details The threads are started in the constructor and joined in the destructor.
+	/// Tasks that have not been started when the thread pool is destroyed are discarded.
+	class ThreadPool : private sf::NonCopyable
+	{
+	public:
+		typedef std::function<void()> Task;
+
+	public:
+		/// @brief Constructor
+		/// @param threadCount The number of worker threads. If 0, one thread per hardware thread is started.
+		explicit ThreadPool(size_t threadCount = 0);
+
+		/// @brief Destructor
+		/// @details Waits for the running tasks to complete
+		~ThreadPool();
+
+	public:
+		/// @brief Adds a task to the queue
+		/// @returns A future that becomes ready when the task has been executed.
+		/// If the task throws, the exception is rethrown when calling get() on the future.
+		std::future<void> Enqueue(Task task);
+
+		/// @brief Calls the function for contiguous blocks of the range [begin, end) on the worker threads and the calling thread
+		/// @details The range is split into at most GetThreadCount() + 1 blocks of at least minBlockSize elements.
+		/// The calling thread processes blocks as well and returns once all blocks have been processed.
+		/// Since the calling thread never waits for a block that has not been started, this may also be called from within a task.
+		/// @param begin The first index of the range
+		/// @param end The index after the last index of the range
+		/// @param function A callable with the signature void(size_t blockBegin, size_t blockEnd). It is called concurrently for different blocks.
+		/// @param minBlockSize The minimum number of elements per block. Ranges that are smaller than two blocks are processed on the calling thread.
+		/// @throws Rethrows the first exception that has been thrown by the function (after all blocks have been processed)
+		template <typename TFunction>
+		void ParallelFor(size_t begin, size_t end, TFunction function, size_t minBlockSize = 1);
+
+		inline size_t GetThreadCount() const { return threadList.size(); }
+
+	private:
+		void Run();
+
+		// The state shared between the calling thread and the tasks of a single call to ParallelFor()
+		// Tasks that are only started after the call has returned must not access the function
+		struct ParallelForState
+		{
+			size_t blockCount = 0;
+			std::atomic<size_t> nextBlock{ 0 };
+			size_t completedBlockCount = 0;
+			std::exception_ptr exception;
+			std::mutex mutex;
+			std::condition_variable conditionVariable;
+		};
+
+		// Processes blocks until there are none left
+		template <typename TFunction>
+		static void ProcessBlocks(ParallelForState& state, TFunction& function, size_t begin, size_t end);
+
+	private:
+		// The tasks are wrapped in a std::packaged_task which is not copyable
+		SafeQueue<std::shared_ptr<std::packaged_task<void()>>> taskQueue;
+		std::vector<std::thread> threadList;
+	};
+
+#pragma region Template Implementations
+
+	template<typename TFunction>
+	inline void ThreadPool::ParallelFor(size_t begin, size_t end, TFunction function, size_t minBlockSize)
+	{
+		if (begin >= end)
+			return;
+
+		const size_t count = end - begin;
+		const size_t blockCount = std::min(GetThreadCount() + 1, count / std::max(minBlockSize, size_t(1)));
+		if (blockCount <= 1)
+		{
+			function(begin, end);
+			return;
+		}
+
+		auto state = std::make_shared<ParallelForState>();
+		state->blockCount = blockCount;
+
+		// One helper task per additional block (helpers that start late find no blocks left)
+		for (size_t i = 1; i < blockCount; i++)
+		{
+			Enqueue([state, &function, begin, end]()
+				{
+					ProcessBlocks(*state, function, begin, end);
+				});
+		}
+
+		ProcessBlocks(*state, function, begin, end);
+
+		// Wait for the blocks that are processed by the worker threads
+		std::unique_lock lock(state->mutex);
+		state->conditionVariable.wait(lock, [&state]() { return state->completedBlockCount == state->blockCount; });
+
+		if (state->exception)
+			std::rethrow_exception(state->exception);
+	}
+
+	template<typename TFunction>
+	inline void ThreadPool::ProcessBlocks(ParallelForState& state, TFunction& function, size_t begin, size_t end)
+	{
+		const size_t count = end - begin;
+		while (true)
+		{
+			const size_t block = state.nextBlock++;
+			if (block >= state.blockCount)
+				return;
+
+			// The sizes of the blocks differ by at most one element
+			const size_t blockBegin = begin + block * count / state.blockCount;
+			const size_t blockEnd = begin + (block + 1) * count / state.blockCount;
+
+			std::exception_ptr exception;
+			try
+			{
+				function(blockBegin, blockEnd);
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+
+			std::lock_guard lock(state.mutex);
+			if (exception && !state.exception)
+				state.exception = exception;
+			if (++state.completedBlockCount == state.blockCount)
+				state.conditionVariable.notify_all();
+		}
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -0,0 +1,633 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::TileConnectivity
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/ReachableTileList.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The component of tiles that are not walkable
+		constexpr unsigned int NO_TILE_COMPONENT = 0u;
+
+		/// @brief The number of tiles around a changed area that are searched to prove that no component has been split
+		constexpr unsigned int DEFAULT_CONNECTIVITY_SEARCH_MARGIN = 8u;
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief Labels the connected components of the walkable tiles of a tile map
+	/// @details Two walkable tiles have the same label if and only if there is a path between them. A pathfinder can therefore
+	/// tell in O(1) that a goal can not be reached instead of searching the whole region of the start (see mbe::AStarPathfinder::SetConnectivity()).
+	/// @n When the walkability of tiles changes, InvalidateTiles() must be called. The labels are updated right away.
+	/// If an event manager is passed to the constructor, the labels are updated whenever it raises a mbe::event::TileMapChangedEvent.
+	/// The tiles around the changed area are searched first. If this proves that every affected component is still connected,
+	/// only the changed tiles are labelled and the components that have been merged by them are relabelled in a single pass over the map.
+	/// Otherwise, the map is searched from each part of a component that may have been split at the same time. The parts that are found completely
+	/// get new labels and the search stops as soon as only one part is left, so the cost depends on the size of the smaller parts.
+	/// @n Queries do not change the labels, so multiple threads can query the labels at the same time.
+	/// @tparam TTileMap The type of tile map. It has the same requirements as for the mbe::AStarPathfinder.
+	/// In addition, a tile must be reachable from another tile if and only if the other tile is reachable from it.
+	template <class TTileMap>
+	class TileConnectivity
+	{
+	public:
+		/// @brief The type of a map position
+		typedef typename TTileMap::Position Position;
+
+		/// @brief The label of a component
+		typedef unsigned int ComponentID;
+
+	public:
+		/// @brief Constructor
+		/// @details Labels the whole map
+		/// @param tileMap The tile map whose tiles are labelled. Its size must not change.
+		/// @param searchMargin The number of tiles around a changed area that are searched to prove that no component has been split
+		TileConnectivity(const TTileMap & tileMap, unsigned int searchMargin = detail::DEFAULT_CONNECTIVITY_SEARCH_MARGIN);
+
+		/// @brief Constructor
+		/// @details Labels the whole map and updates the labels whenever the event manager raises a mbe::event::TileMapChangedEvent
+		/// @param tileMap The tile map whose tiles are labelled. Its size must not change.
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent. It must outlive the labels.
+		/// @param searchMargin The number of tiles around a changed area that are searched to prove that no component has been split
+		TileConnectivity(const TTileMap & tileMap, EventManager & eventManager, unsigned int searchMargin = detail::DEFAULT_CONNECTIVITY_SEARCH_MARGIN);
+
+		/// @brief Default destructor
+		~TileConnectivity() = default;
+
+	public:
+		/// @brief Labels the whole map from scratch
+		void Create();
+
+		/// @brief Updates the labels after the walkability of the tiles in the area has changed
+		/// @param position The top left tile of the area
+		/// @param size The number of tiles in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+		/// @brief Returns the component of a tile or mbe::detail::NO_TILE_COMPONENT if the tile is not walkable
+		inline ComponentID GetComponent(Position position) const { return labelList[GetTileIndex(position)]; }
+
+		/// @brief Returns whether there may be a path between two tiles
+		/// @details If the start is not walkable, the tiles reachable from it are checked. Returns false if the goal is not walkable.
+		bool IsReachable(Position start, Position goal) const;
+
+		/// @brief Returns the number of tiles in a component
+		inline size_t GetComponentSize(ComponentID componentId) const { return componentId < componentSizeList.size() ? componentSizeList[componentId] : 0; }
+
+		/// @brief Returns the number of components
+		inline size_t GetComponentCount() const { return componentSizeList.size() - 1 - freeComponentList.size(); }
+
+		/// @brief Returns the number of tiles whose label has been changed by the last call to InvalidateTiles() or Create()
+		inline size_t GetRelabelledTileCount() const { return relabelledTileCount; }
+
+	private:
+		struct TileBounds
+		{
+			long long left;
+			long long top;
+			long long right;
+			long long bottom;
+
+			inline bool Contains(long long x, long long y) const { return x >= left && x <= right && y >= top && y <= bottom; }
+		};
+
+		// Returns the bounds grown by the margin and clipped to the map
+		TileBounds GrowBounds(const TileBounds & bounds, long long margin) const;
+
+		ComponentID AddComponent();
+
+		void RemoveComponent(ComponentID componentId);
+
+		// Labels all unlabelled tiles that are connected to the tile
+		void Flood(size_t tileIndex, ComponentID componentId);
+
+		// Searches the map from each local component until at most one search has not found its whole component
+		// The complete components get new labels and the remaining labels of the local components are merged
+		void SplitComponents(size_t localComponentCount);
+
+		// Merges the labels of the local component into the largest one
+		// Only the remap list is changed. Returns the merged label or mbe::detail::NO_TILE_COMPONENT if there are no labels.
+		ComponentID MergeComponents(const std::vector<ComponentID> & labels);
+
+		// Changes the labels of all tiles according to the remap list in a single pass
+		void RemapComponents();
+
+		// Returns the search that a search has been merged into
+		size_t FindSearch(size_t search);
+
+		inline size_t GetTileIndex(Position position) const { return static_cast<size_t>(position.y) * width + static_cast<size_t>(position.x); }
+
+		inline Position GetTilePosition(size_t tileIndex) const { return Position(static_cast<int>(tileIndex % width), static_cast<int>(tileIndex / width)); }
+
+	private:
+		const TTileMap & map;
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
+
+		const size_t width;
+		const size_t height;
+		const unsigned int searchMargin;
+
+		std::vector<ComponentID> labelList;
+		// Indexed by the component id (the first entry belongs to mbe::detail::NO_TILE_COMPONENT)
+		std::vector<size_t> componentSizeList;
+		// The ids of the removed components that can be reused
+		std::vector<ComponentID> freeComponentList;
+		size_t relabelledTileCount;
+
+		// Scratch memory of InvalidateTiles()
+		std::vector<int> localComponentList;
+		std::vector<std::vector<ComponentID>> localComponentLabelList;
+		// The walkable tiles of the local components and the first tile of each local component
+		std::vector<size_t> localTileList;
+		std::vector<size_t> localSeedList;
+		std::vector<int> labelLocalComponentList;
+		std::vector<ComponentID> localComponentIdList;
+		// Indexed by the component id
+		std::vector<ComponentID> componentRemapList;
+		std::vector<size_t> stack;
+
+		// Scratch memory of SplitComponents()
+		// A tile has been visited by the search in the seed list if its generation is the current one
+		std::vector<unsigned int> visitGenerationList;
+		std::vector<unsigned int> visitSearchList;
+		unsigned int visitGeneration;
+		std::vector<size_t> searchParentList;
+		std::vector<std::vector<size_t>> searchStackList;
+		std::vector<std::vector<size_t>> searchedTileList;
+		std::vector<char> activeSearchList;
+		std::vector<ComponentID> emptiedComponentList;
+	};
+
+#pragma region Template Implementations
+
+	template <class TTileMap>
+	TileConnectivity<TTileMap>::TileConnectivity(const TTileMap & tileMap, unsigned int searchMargin) :
+		map(tileMap),
+		width(tileMap.GetSize().x),
+		height(tileMap.GetSize().y),
+		searchMargin(searchMargin),
+		relabelledTileCount(0),
+		visitGeneration(0u)
+	{
+		Create();
+	}
+
+	template <class TTileMap>
+	TileConnectivity<TTileMap>::TileConnectivity(const TTileMap & tileMap, EventManager & eventManager, unsigned int searchMargin) :
+		TileConnectivity(tileMap, searchMargin)
+	{
+		tileMapChangedSubscription.Subscribe(eventManager, *this);
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::Create()
+	{
+		labelList.assign(width * height, detail::NO_TILE_COMPONENT);
+		componentSizeList.assign(1, 0);
+		freeComponentList.clear();
+		relabelledTileCount = 0;
+
+		for (size_t tileIndex = 0; tileIndex < labelList.size(); tileIndex++)
+		{
+			const Position position = GetTilePosition(tileIndex);
+			if (labelList[tileIndex] == detail::NO_TILE_COMPONENT && map.IsTileWalkable(position.x, position.y))
+				Flood(tileIndex, AddComponent());
+		}
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::InvalidateTiles(Position position, sf::Vector2u size)
+	{
+		relabelledTileCount = 0;
+		if (size.x == 0u || size.y == 0u)
+			return;
+
+		TileBounds changedBounds;
+		changedBounds.left = std::max(static_cast<long long>(position.x), 0ll);
+		changedBounds.top = std::max(static_cast<long long>(position.y), 0ll);
+		changedBounds.right = std::min(static_cast<long long>(position.x) + size.x - 1, static_cast<long long>(width) - 1);
+		changedBounds.bottom = std::min(static_cast<long long>(position.y) + size.y - 1, static_cast<long long>(height) - 1);
+		if (changedBounds.left > changedBounds.right || changedBounds.top > changedBounds.bottom)
+			return;
+
+		// Every edge that may have changed connects two tiles of the grown area
+		const TileBounds affectedBounds = GrowBounds(changedBounds, 1);
+		const TileBounds searchBounds = GrowBounds(affectedBounds, searchMargin);
+		const size_t searchWidth = static_cast<size_t>(searchBounds.right - searchBounds.left + 1);
+		const size_t searchHeight = static_cast<size_t>(searchBounds.bottom - searchBounds.top + 1);
+		const auto getLocalIndex = [&searchBounds, searchWidth](long long x, long long y)
+		{
+			return static_cast<size_t>(y - searchBounds.top) * searchWidth + static_cast<size_t>(x - searchBounds.left);
+		};
+
+		// Remove the changed tiles from their components
+		for (long long y = changedBounds.top; y <= changedBounds.bottom; y++)
+		{
+			for (long long x = changedBounds.left; x <= changedBounds.right; x++)
+			{
+				auto & label = labelList[static_cast<size_t>(y) * width + static_cast<size_t>(x)];
+				if (label == detail::NO_TILE_COMPONENT)
+					continue;
+
+				if (--componentSizeList[label] == 0)
+					RemoveComponent(label);
+				label = detail::NO_TILE_COMPONENT;
+			}
+		}
+
+		// Find the components of the walkable tiles of the affected area within the search area
+		localComponentList.assign(searchWidth * searchHeight, -1);
+		localTileList.clear();
+		localSeedList.clear();
+		size_t localComponentCount = 0;
+		for (long long y = affectedBounds.top; y <= affectedBounds.bottom; y++)
+		{
+			for (long long x = affectedBounds.left; x <= affectedBounds.right; x++)
+			{
+				if (localComponentList[getLocalIndex(x, y)] != -1 || map.IsTileWalkable(static_cast<int>(x), static_cast<int>(y)) == false)
+					continue;
+
+				if (localComponentLabelList.size() <= localComponentCount)
+					localComponentLabelList.emplace_back();
+				auto & labels = localComponentLabelList[localComponentCount];
+				labels.clear();
+
+				localComponentList[getLocalIndex(x, y)] = static_cast<int>(localComponentCount);
+				localSeedList.push_back(static_cast<size_t>(y) * width + static_cast<size_t>(x));
+				stack.assign(1, localSeedList.back());
+				while (stack.empty() == false)
+				{
+					const size_t tileIndex = stack.back();
+					stack.pop_back();
+					localTileList.push_back(tileIndex);
+
+					if (labelList[tileIndex] != detail::NO_TILE_COMPONENT)
+						labels.push_back(labelList[tileIndex]);
+
+					for (const auto & neighbourPosition : detail::GetReachableTileList(map, GetTilePosition(tileIndex)))
+					{
+						if (searchBounds.Contains(neighbourPosition.x, neighbourPosition.y) == false)
+							continue;
+
+						auto & localComponent = localComponentList[getLocalIndex(neighbourPosition.x, neighbourPosition.y)];
+						if (localComponent != -1)
+							continue;
+
+						localComponent = static_cast<int>(localComponentCount);
+						stack.push_back(GetTileIndex(neighbourPosition));
+					}
+				}
+
+				std::sort(labels.begin(), labels.end());
+				labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+				localComponentCount++;
+			}
+		}
+
+		// A component may have been split if its tiles belong to different local components
+		labelLocalComponentList.resize(componentSizeList.size());
+		for (size_t localComponent = 0; localComponent < localComponentCount; localComponent++)
+		{
+			for (const auto label : localComponentLabelList[localComponent])
+				labelLocalComponentList[label] = -1;
+		}
+
+		bool split = false;
+		for (size_t localComponent = 0; localComponent < localComponentCount && split == false; localComponent++)
+		{
+			for (const auto label : localComponentLabelList[localComponent])
+			{
+				if (labelLocalComponentList[label] != -1 && labelLocalComponentList[label] != static_cast<int>(localComponent))
+					split = true;
+				labelLocalComponentList[label] = static_cast<int>(localComponent);
+			}
+		}
+
+		if (split)
+		{
+			SplitComponents(localComponentCount);
+			return;
+		}
+
+		// Merge the components that have been connected by the changed tiles
+		componentRemapList.resize(componentSizeList.size());
+		for (ComponentID componentId = 0; componentId < componentRemapList.size(); componentId++)
+			componentRemapList[componentId] = componentId;
+
+		localComponentIdList.resize(localComponentCount);
+		for (size_t localComponent = 0; localComponent < localComponentCount; localComponent++)
+			localComponentIdList[localComponent] = MergeComponents(localComponentLabelList[localComponent]);
+
+		RemapComponents();
+
+		// Label the changed tiles
+		for (const auto tileIndex : localTileList)
+		{
+			if (labelList[tileIndex] != detail::NO_TILE_COMPONENT)
+				continue;
+
+			const Position tilePosition = GetTilePosition(tileIndex);
+			auto & componentId = localComponentIdList[localComponentList[getLocalIndex(tilePosition.x, tilePosition.y)]];
+			if (componentId == detail::NO_TILE_COMPONENT)
+				componentId = AddComponent();
+
+			labelList[tileIndex] = componentId;
+			componentSizeList[componentId]++;
+			relabelledTileCount++;
+		}
+	}
+
+	template <class TTileMap>
+	bool TileConnectivity<TTileMap>::IsReachable(Position start, Position goal) const
+	{
+		if (start == goal)
+			return true;
+
+		const ComponentID goalComponent = GetComponent(goal);
+		if (goalComponent == detail::NO_TILE_COMPONENT)
+			return false;
+
+		const ComponentID startComponent = GetComponent(start);
+		if (startComponent != detail::NO_TILE_COMPONENT)
+			return startComponent == goalComponent;
+
+		// An agent may stand on a tile that is not walkable
+		for (const auto & neighbourPosition : detail::GetReachableTileList(map, start))
+		{
+			if (GetComponent(neighbourPosition) == goalComponent)
+				return true;
+		}
+		return false;
+	}
+
+	template <class TTileMap>
+	typename TileConnectivity<TTileMap>::TileBounds TileConnectivity<TTileMap>::GrowBounds(const TileBounds & bounds, long long margin) const
+	{
+		TileBounds grownBounds;
+		grownBounds.left = std::max(bounds.left - margin, 0ll);
+		grownBounds.top = std::max(bounds.top - margin, 0ll);
+		grownBounds.right = std::min(bounds.right + margin, static_cast<long long>(width) - 1);
+		grownBounds.bottom = std::min(bounds.bottom + margin, static_cast<long long>(height) - 1);
+		return grownBounds;
+	}
+
+	template <class TTileMap>
+	typename TileConnectivity<TTileMap>::ComponentID TileConnectivity<TTileMap>::AddComponent()
+	{
+		if (freeComponentList.empty() == false)
+		{
+			const ComponentID componentId = freeComponentList.back();
+			freeComponentList.pop_back();
+			return componentId;
+		}
+
+		componentSizeList.push_back(0);
+		return static_cast<ComponentID>(componentSizeList.size() - 1);
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::RemoveComponent(ComponentID componentId)
+	{
+		assert(componentId != detail::NO_TILE_COMPONENT && componentSizeList[componentId] == 0);
+		freeComponentList.push_back(componentId);
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::Flood(size_t tileIndex, ComponentID componentId)
+	{
+		labelList[tileIndex] = componentId;
+		componentSizeList[componentId]++;
+		relabelledTileCount++;
+
+		stack.assign(1, tileIndex);
+		while (stack.empty() == false)
+		{
+			const size_t currentIndex = stack.back();
+			stack.pop_back();
+
+			for (const auto & neighbourPosition : detail::GetReachableTileList(map, GetTilePosition(currentIndex)))
+			{
+				auto & label = labelList[GetTileIndex(neighbourPosition)];
+				if (label != detail::NO_TILE_COMPONENT)
+					continue;
+
+				label = componentId;
+				componentSizeList[componentId]++;
+				relabelledTileCount++;
+				stack.push_back(GetTileIndex(neighbourPosition));
+			}
+		}
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::SplitComponents(size_t localComponentCount)
+	{
+		const size_t searchCount = localComponentCount;
+		if (visitGenerationList.size() != labelList.size())
+		{
+			visitGenerationList.assign(labelList.size(), 0u);
+			visitSearchList.resize(labelList.size());
+		}
+
+		// When the generation wraps around, tiles of the generation that is now reused would appear to be visited
+		if (++visitGeneration == 0u)
+		{
+			std::fill(visitGenerationList.begin(), visitGenerationList.end(), 0u);
+			visitGeneration = 1u;
+		}
+
+		searchParentList.resize(searchCount);
+		activeSearchList.assign(searchCount, 1);
+		if (searchStackList.size() < searchCount)
+		{
+			searchStackList.resize(searchCount);
+			searchedTileList.resize(searchCount);
+		}
+
+		for (size_t search = 0; search < searchCount; search++)
+		{
+			const size_t seedIndex = localSeedList[search];
+			searchParentList[search] = search;
+			searchStackList[search].assign(1, seedIndex);
+			searchedTileList[search].clear();
+			visitGenerationList[seedIndex] = visitGeneration;
+			visitSearchList[seedIndex] = static_cast<unsigned int>(search);
+		}
+
+		// Expand one tile of each search in turn
+		// Searches that meet belong to the same component and are merged. A search whose stacks are empty has found its whole component.
+		size_t activeSearchCount = searchCount;
+		while (activeSearchCount > 1)
+		{
+			for (size_t search = 0; search < searchCount; search++)
+			{
+				auto & searchStack = searchStackList[search];
+				if (searchStack.empty())
+					continue;
+
+				const size_t tileIndex = searchStack.back();
+				searchStack.pop_back();
+				searchedTileList[search].push_back(tileIndex);
+
+				for (const auto & neighbourPosition : detail::GetReachableTileList(map, GetTilePosition(tileIndex)))
+				{
+					const size_t neighbourIndex = GetTileIndex(neighbourPosition);
+					if (visitGenerationList[neighbourIndex] == visitGeneration)
+					{
+						const size_t otherSearch = FindSearch(visitSearchList[neighbourIndex]);
+						const size_t ownSearch = FindSearch(search);
+						if (otherSearch != ownSearch)
+							searchParentList[otherSearch] = ownSearch;
+						continue;
+					}
+
+					visitGenerationList[neighbourIndex] = visitGeneration;
+					visitSearchList[neighbourIndex] = static_cast<unsigned int>(search);
+					searchStack.push_back(neighbourIndex);
+				}
+			}
+
+			std::fill(activeSearchList.begin(), activeSearchList.end(), 0);
+			activeSearchCount = 0;
+			for (size_t search = 0; search < searchCount; search++)
+			{
+				auto & active = activeSearchList[FindSearch(search)];
+				if (searchStackList[search].empty() == false && active == 0)
+				{
+					active = 1;
+					activeSearchCount++;
+				}
+			}
+		}
+
+		// The searches that have finished have found complete components, which get new labels
+		size_t unfinishedSearch = searchCount;
+		for (size_t search = 0; search < searchCount; search++)
+		{
+			if (activeSearchList[FindSearch(search)] != 0)
+				unfinishedSearch = FindSearch(search);
+		}
+
+		// The labels that are no longer used are only removed at the end, so that they are not reused for the new components
+		emptiedComponentList.clear();
+		for (size_t rootSearch = 0; rootSearch < searchCount; rootSearch++)
+		{
+			if (FindSearch(rootSearch) != rootSearch || rootSearch == unfinishedSearch)
+				continue;
+
+			const ComponentID componentId = AddComponent();
+			for (size_t search = 0; search < searchCount; search++)
+			{
+				if (FindSearch(search) != rootSearch)
+					continue;
+
+				for (const auto tileIndex : searchedTileList[search])
+				{
+					auto & label = labelList[tileIndex];
+					if (label != detail::NO_TILE_COMPONENT && --componentSizeList[label] == 0)
+						emptiedComponentList.push_back(label);
+
+					label = componentId;
+					componentSizeList[componentId]++;
+					relabelledTileCount++;
+				}
+			}
+		}
+
+		if (unfinishedSearch == searchCount)
+		{
+			for (const auto emptiedComponentId : emptiedComponentList)
+				RemoveComponent(emptiedComponentId);
+			return;
+		}
+
+		// All tiles of the affected components that have not been found belong to the component of the unfinished search
+		componentRemapList.resize(componentSizeList.size());
+		for (ComponentID componentId = 0; componentId < componentRemapList.size(); componentId++)
+			componentRemapList[componentId] = componentId;
+
+		std::vector<ComponentID> & labels = localComponentLabelList[0];
+		for (size_t localComponent = 1; localComponent < localComponentCount; localComponent++)
+			labels.insert(labels.end(), localComponentLabelList[localComponent].begin(), localComponentLabelList[localComponent].end());
+		labels.erase(std::remove_if(labels.begin(), labels.end(), [this](ComponentID label) { return componentSizeList[label] == 0; }), labels.end());
+		std::sort(labels.begin(), labels.end());
+		labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+		ComponentID componentId = MergeComponents(labels);
+		RemapComponents();
+		for (const auto emptiedComponentId : emptiedComponentList)
+			RemoveComponent(emptiedComponentId);
+		if (componentId == detail::NO_TILE_COMPONENT)
+			componentId = AddComponent();
+
+		// The changed tiles of the unfinished search have not been labelled yet
+		for (const auto tileIndex : localTileList)
+		{
+			if (labelList[tileIndex] != detail::NO_TILE_COMPONENT)
+				continue;
+
+			labelList[tileIndex] = componentId;
+			componentSizeList[componentId]++;
+			relabelledTileCount++;
+		}
+	}
+
+	template <class TTileMap>
+	typename TileConnectivity<TTileMap>::ComponentID TileConnectivity<TTileMap>::MergeComponents(const std::vector<ComponentID> & labels)
+	{
+		if (labels.empty())
+			return detail::NO_TILE_COMPONENT;
+
+		// Keep the label of the largest component, so that the fewest tiles are relabelled
+		const ComponentID componentId = *std::max_element(labels.begin(), labels.end(), [this](ComponentID a, ComponentID b) { return componentSizeList[a] < componentSizeList[b]; });
+		for (const auto label : labels)
+			componentRemapList[label] = componentId;
+		return componentId;
+	}
+
+	template <class TTileMap>
+	void TileConnectivity<TTileMap>::RemapComponents()
+	{
+		bool remapped = false;
+		for (ComponentID componentId = 0; componentId < componentRemapList.size(); componentId++)
+		{
+			if (componentRemapList[componentId] == componentId)
+				continue;
+
+			remapped = true;
+			relabelledTileCount += componentSizeList[componentId];
+			componentSizeList[componentRemapList[componentId]] += componentSizeList[componentId];
+			componentSizeList[componentId] = 0;
+			RemoveComponent(componentId);
+		}
+
+		if (remapped == false)
+			return;
+
+		for (auto & label : labelList)
+			label = componentRemapList[label];
+	}
+
+	template <class TTileMap>
+	size_t TileConnectivity<TTileMap>::FindSearch(size_t search)
+	{
+		while (searchParentList[search] != search)
+		{
+			searchParentList[search] = searchParentList[searchParentList[search]];
+			search = searchParentList[search];
+		}
+		return search;
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -0,0 +1,156 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::EntitySpatialHash
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <limits>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <MBE/Core/Entity.h>
+#include <MBE/Core/EntityManager.h>
+#include <MBE/Core/EventManager.h>
+#include <MBE/Graphics/SpatialGrid.h>
+
+namespace mbe
+{
+
+	/// @brief Indexes the world positions of all entities with a mbe::TransformComponent for range, nearest neighbour and ray queries
+	/// @details Entities are stored in a mbe::SpatialGrid by their world bounds. If an entity has a mbe::TextureWrapperComponent,
+	/// its bounds are its transformed texture rect (the area that can be clicked). Otherwise, its bounds are its world position.
+	/// @n The index is updated incrementally. Entities are marked dirty when they are created, when a component is added,
+	/// when their world transform changes (see mbe::TransformComponent) or when their texture rect changes.
+	/// Update() recalculates the bounds of the dirty entities, so it should be called once per frame after the game logic has moved the entities.
+	/// @n Entities for which a mbe::event::EntityRemovedEvent is raised are removed immediately.
+	/// Entities that have been deleted without that event are never returned and removed from the index when a query finds them.
+	/// @n Queries are cheap enough to replace brute force scans of component groups, e.g. for finding the clicked entities,
+	/// culling sounds that are out of earshot or selecting the nearest target of an AI.
+	class EntitySpatialHash
+	{
+	public:
+		/// @brief Function that returns whether an entity should be considered by a nearest neighbour query
+		typedef std::function<bool(const Entity&)> Filter;
+
+	public:
+		/// @brief Constructor
+		/// @details The entities that already exist are indexed by the first call to Update().
+		/// @param eventManager A reference to the mbe::EventManager used to keep track of created, moved and removed entities
+		/// @param entityManager A reference to the mbe::EntityManager holding the entities with a mbe::TransformComponent
+		/// @param cellSize The width and height of a cell of the underlying grid. It should be in the order of the typical query radius.
+		EntitySpatialHash(EventManager & eventManager, const EntityManager & entityManager, float cellSize = 128.f);
+
+		/// @brief Destructor
+		/// @details Unsubscribes from the events
+		~EntitySpatialHash();
+
+	public:
+		/// @brief Updates the bounds of the entities that have changed since the last update
+		void Update();
+
+		/// @brief Appends the entities whose bounds intersect the area to the result list
+		/// @details The order of the entities is undefined.
+		void QueryArea(const sf::FloatRect & area, std::vector<Entity::ID> & resultList);
+
+		/// @brief Appends the entities whose bounds contain the point to the result list
+		/// @details The order of the entities is undefined.
+		inline void QueryPoint(const sf::Vector2f & point, std::vector<Entity::ID> & resultList) { QueryArea(sf::FloatRect(point, sf::Vector2f()), resultList); }
+
+		/// @brief Appends the entities whose bounds are at most radius away from the center to the result list
+		/// @details The order of the entities is undefined.
+		void QueryRadius(const sf::Vector2f & center, float radius, std::vector<Entity::ID> & resultList);
+
+		/// @brief Appends the entities that are closest to the point to the result list
+		/// @details The entities are appended in the order of increasing distance.
+		/// @param point The point from which the distance is measured
+		/// @param count The maximum number of entities to return
+		/// @param resultList The list to which the entities are appended
+		/// @param filter Entities for which the filter returns false are ignored. If it is empty, every entity is considered.
+		/// @param maxDistance Entities that are further away are ignored
+		void QueryNearest(const sf::Vector2f & point, size_t count, std::vector<Entity::ID> & resultList,
+			const Filter & filter = nullptr, float maxDistance = std::numeric_limits<float>::infinity());
+
+		/// @brief Appends the entities that have all the components and are closest to the point to the result list
+		/// @see QueryNearest
+		template <class... TComponents>
+		void QueryNearestWith(const sf::Vector2f & point, size_t count, std::vector<Entity::ID> & resultList,
+			float maxDistance = std::numeric_limits<float>::infinity());
+
+		/// @brief Appends the entities that are hit by a ray to the result list
+		/// @details The entities are appended in the order in which the ray hits them.
+		/// @param origin The start of the ray
+		/// @param direction The direction of the ray. It does not need to be normalised but must not be zero.
+		/// @param maxDistance The length of the ray
+		/// @param resultList The list to which the entities are appended
+		/// @param radius The thickness of the ray on either side. Entities without a mbe::TextureWrapperComponent can only be hit if it is greater than 0.
+		void QueryRay(const sf::Vector2f & origin, const sf::Vector2f & direction, float maxDistance, std::vector<Entity::ID> & resultList, float radius = 0.f);
+
+		/// @brief Returns the number of indexed entities
+		inline size_t GetEntityCount() const { return valueIdDictionary.size(); }
+
+		/// @brief Returns the number of entities that have been updated in the last call to Update()
+		inline size_t GetUpdatedEntityCount() const { return updatedEntityCount; }
+
+	private:
+		// Adds the entity to the dirty entity set if it has a mbe::TransformComponent
+		void MarkDirty(Entity & entity);
+
+		// Inserts the entity or updates its bounds
+		void UpdateEntity(Entity & entity);
+
+		void RemoveEntity(Entity::ID entityId);
+
+		// Returns whether the entity of a value still exists
+		// Deleted entities are remembered and removed after the current query
+		bool IsValueValid(SpatialGrid::ValueID valueId);
+
+		// Converts the values found by a query to entity ids and removes the deleted entities
+		void AppendEntityIDs(std::vector<Entity::ID> & resultList);
+
+		static sf::FloatRect CalculateBounds(const Entity & entity);
+
+	private:
+		EventManager & eventManager;
+		const EntityManager & entityManager;
+
+		EventManager::SubscriptionID entityCreatedSubscription;
+		EventManager::SubscriptionID entityRemovedSubscription;
+		EventManager::SubscriptionID componentsChangedSubscription;
+		EventManager::SubscriptionID transformChangedSubscription;
+		EventManager::SubscriptionID textureWrapperChangedSubscription;
+
+		SpatialGrid spatialGrid;
+
+		// The value ids are the indices into the entity id list
+		std::unordered_map<Entity::ID, SpatialGrid::ValueID> valueIdDictionary;
+		std::vector<Entity::ID> entityIdList;
+		std::vector<SpatialGrid::ValueID> freeValueIdList;
+
+		// The entities whose bounds must be updated
+		std::unordered_set<Entity::ID> dirtyEntityIdSet;
+		bool initialised;
+		size_t updatedEntityCount;
+
+		// Reused between queries
+		std::vector<SpatialGrid::ValueID> queryResultList;
+		std::vector<Entity::ID> deletedEntityIdList;
+	};
+
+#pragma region Template Implementations
+
+	template <class... TComponents>
+	void EntitySpatialHash::QueryNearestWith(const sf::Vector2f & point, size_t count, std::vector<Entity::ID> & resultList, float maxDistance)
+	{
+		QueryNearest(point, count, resultList, [](const Entity & entity)
+			{
+				return entity.HasComponents<TComponents...>();
+			}, maxDistance);
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -0,0 +1,126 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::RenderCommandList
+
+#include <cstddef>
+#include <vector>
+
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <MBE/Core/ThreadPool.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The minimum number of sprites whose vertices are generated by a single task
+		constexpr size_t MIN_SPRITE_VERTEX_BLOCK_SIZE = 512;
+	} // namespace detail
+
+	class RenderComponent;
+
+	/// @brief Records the draw calls of a render layer so that they can be replayed later
+	/// @details The mbe::RenderSystem fills a command list per render layer (possibly on a worker thread) and submits it on the thread that owns the window.
+	/// @n Sprites are transformed on the CPU and their vertices are copied into the list. Consecutive sprites that share a texture
+	/// are merged into a single command, so they are drawn with one draw call. Since only consecutive sprites are merged,
+	/// the draw order is the same as when drawing every sprite on its own.
+	/// @n Adding a sprite only reserves its vertices. They are generated for all sprites at once by calling GenerateVertices(),
+	/// which can split the work between the threads of a mbe::ThreadPool.
+	/// @n Render components that can not be expressed as sprites are recorded by reference and drawn by calling mbe::RenderComponent::Draw()
+	/// when the list is submitted. Unlike the sprite vertices, they are therefore drawn in the state they are in at that time.
+	class RenderCommandList
+	{
+	public:
+		/// @brief A single draw call
+		struct RenderCommand
+		{
+			/// @brief The render component to draw or null if the command draws a range of the vertex list
+			const RenderComponent* renderComponent = nullptr;
+			/// @brief The texture of the vertex range (The vertices are drawn with the default blend mode and without a shader)
+			const sf::Texture* texture = nullptr;
+			size_t vertexOffset = 0;
+			size_t vertexCount = 0;
+			/// @brief The position in the draw order of the first entity that is drawn by this command
+			size_t sortKey = 0;
+		};
+
+	public:
+		/// @brief Constructor
+		RenderCommandList();
+
+		/// @brief Default destructor
+		~RenderCommandList() = default;
+
+	public:
+		/// @brief Removes all commands and vertices
+		/// @details The memory is kept for the next frame.
+		void Clear();
+
+		/// @brief Sets the sort key of the commands that are added next
+		inline void SetSortKey(size_t sortKey) { this->sortKey = sortKey; }
+
+		/// @brief Reserves the vertices of a sprite
+		/// @details If the previous command draws vertices with the same texture, the vertices are appended to that command.
+		/// Sprites without a texture are not drawn (like when drawing an sf::Sprite).
+		/// @param sprite The sprite to add. Its own transform is combined with the passed transform.
+		/// @param transform The transform that is applied to the sprite
+		/// @note The sprite and the transform are referenced until GenerateVertices() is called
+		void AddSprite(const sf::Sprite & sprite, const sf::Transform & transform);
+
+		/// @brief Generates the vertices of the sprites that have been added since the last call
+		/// @param threadPool If not null, the sprites are split into blocks that are processed by the threads of the thread pool
+		void GenerateVertices(ThreadPool * threadPool = nullptr);
+
+		/// @brief Adds a command that draws the render component when the list is submitted
+		/// @details The render component must stay alive until the list has been submitted or cleared.
+		void AddRenderComponent(const RenderComponent & renderComponent);
+
+		/// @brief Draws all commands in the order they have been added
+		/// @details GenerateVertices() must have been called after adding the last sprite.
+		void Submit(sf::RenderTarget & target) const;
+
+		inline const std::vector<RenderCommand>& GetCommandList() const { return commandList; }
+
+		inline const std::vector<sf::Vertex>& GetVertexList() const { return vertexList; }
+
+		/// @brief Returns the number of draw calls when submitting the list
+		inline size_t GetDrawCallCount() const { return commandList.size(); }
+
+		/// @brief Returns the number of sprites that have been added since the last call to Clear()
+		inline size_t GetSpriteCount() const { return spriteCount; }
+
+		/// @brief Returns the number of times the texture changes between two batched commands
+		/// @details The textures of unbatched render components are not known and therefore not counted.
+		inline size_t GetTextureSwitchCount() const { return textureSwitchCount; }
+
+	private:
+		// A sprite whose vertices have not been generated yet
+		struct SpriteReference
+		{
+			const sf::Sprite* sprite;
+			const sf::Transform* transform;
+			size_t vertexOffset;
+		};
+
+		// Writes the 6 vertices of a sprite
+		static void WriteSpriteVertices(sf::Vertex* vertices, const sf::Sprite & sprite, const sf::Transform & transform);
+
+	private:
+		std::vector<RenderCommand> commandList;
+		// Two triangles per sprite
+		std::vector<sf::Vertex> vertexList;
+		std::vector<SpriteReference> spriteReferenceList;
+
+		size_t sortKey;
+		size_t spriteCount;
+		size_t textureSwitchCount;
+		// The texture of the last batched command
+		const sf::Texture* lastTexture;
+	};
+
+} // namespace mbe
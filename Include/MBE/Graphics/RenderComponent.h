@@ -10,6 +10,7 @@
 #include <MBE/Core/Entity.h>
 #include <MBE/Core/Component.h>
 #include <MBE/TransformComponent.h>
+#include <MBE/Graphics/RenderCommandList.h>
 
 namespace mbe
 {
@@ -32,6 +33,14 @@ namespace mbe
 	public:
 		virtual void Draw(sf::RenderTarget & target) const = 0;
 
+		/// @brief Adds the vertices of this component to the command list instead of drawing it directly
+		/// @details Components that can be expressed as textured quads with the default render states should override this function.
+		/// The mbe::RenderSystem records a call to Draw() for components that return false.
+		/// @n This may be called on a worker thread, so it must not modify any shared state.
+		/// @param commandList The command list of the current render layer
+		/// @returns Whether the component has been added to the command list. The default implementation returns false.
+		virtual bool AppendToCommandList(RenderCommandList & commandList) const;
+
 		// Default implementation applies the entity's transform if it has a transform component
 		virtual sf::FloatRect GetGlobalBounds() const;
 
@@ -43,8 +52,26 @@ namespace mbe
 
 		bool IsHidden() const;
 
+		/// @brief Returns a number that changes whenever the global bounds or the appearance of this component change
+		/// @details This is only meaningful if IsRevisionTracked() returns true.
+		inline unsigned long long GetRevision() const { return revision; }
+
+		/// @brief Returns whether the revision is incremented on every change of the global bounds
+		/// @details The mbe::RenderSystem only recalculates the global bounds of tracked components when their revision changes.
+		/// The global bounds of untracked components are tested against the view every frame.
+		/// By default, components are not tracked since their bounds depend on the mbe::TransformComponent of the entity.
+		virtual bool IsRevisionTracked() const;
+
+	protected:
+		/// @brief Must be called by tracked components whenever their global bounds or appearance change
+		inline void IncrementRevision() { revision++; }
+
+		/// @brief Returns true if the two transforms have the same matrix
+		static bool AreTransformsEqual(const sf::Transform & a, const sf::Transform & b);
+
 	private:
 		bool hidden;
+		unsigned long long revision;
 	};
 } // namespace mbe
 
@@ -41,6 +41,8 @@ namespace mbe
 		// A pointer is returned since the value may be null if this entity is not been rendered
 		typedef std::function<const sf::View * (const Entity&)> ViewGetterFunction;
 		typedef std::function<const sf::RenderWindow * ()> WindowGetterFunction;
+		// Called whenever the z-order changes so that the render system only needs to update the changed sort keys
+		typedef std::function<void()> ZOrderChangedFunction;
 
 	public:
 		// Default zorder = 0
@@ -50,12 +52,15 @@ namespace mbe
 	public:
 		inline void SetRenderLayer(RenderLayer renderLayer) { this->renderLayer = renderLayer; }
 
-		inline void SetZOrder(float value) { zOrder = value; }
+		// Calls the z-order changed function if the value is different from the current z-order
+		void SetZOrder(float value);
 
 		inline void SetViewGetterFunction(ViewGetterFunction function) { viewGetterFunction = function; }
 
 		inline void SetWindowGetterFunction(WindowGetterFunction function) { windowGetterFunction = function; }
 
+		inline void SetZOrderChangedFunction(ZOrderChangedFunction function) { zOrderChangedFunction = function; }
+
 		inline RenderLayer GetRenderLayer() const { return renderLayer; }
 
 		inline float GetZOrder() const { return zOrder; }
@@ -68,6 +73,8 @@ namespace mbe
 
 		void ResetWindowGetterFunction();
 
+		void ResetZOrderChangedFunction();
+
 		// Returns true if the passed in render information component would be drawn above this
 		bool IsAbove(const RenderInformationComponent& renderInformationComponent) const;
 
@@ -80,6 +87,7 @@ namespace mbe
 		float zOrder;
 		ViewGetterFunction viewGetterFunction;
 		WindowGetterFunction windowGetterFunction;
+		ZOrderChangedFunction zOrderChangedFunction;
 	};
 
 	using RenderLayer = RenderInformationComponent::RenderLayer;
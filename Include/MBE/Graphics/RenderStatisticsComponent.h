@@ -0,0 +1,47 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::RenderStatisticsComponent
+
+#include <string>
+
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Font.hpp>
+
+#include <MBE/Graphics/RenderComponent.h>
+
+namespace mbe
+{
+
+	/// @brief Displays the render statistics of the last frame as text
+	/// @details The text is set by the mbe::RenderStatisticsSystem. The entity should be in the GUI render layer.
+	/// The transform of the entity's mbe::TransformComponent is applied if it has one.
+	class RenderStatisticsComponent : public RenderComponent
+	{
+	public:
+		typedef std::shared_ptr<RenderStatisticsComponent> Ptr;
+		typedef std::weak_ptr<RenderStatisticsComponent> WPtr;
+		typedef std::unique_ptr<RenderStatisticsComponent> UPtr;
+
+	public:
+		/// @brief Constructor
+		/// @param font The font of the text. It must outlive this component.
+		/// @param characterSize The character size of the text in pixels
+		RenderStatisticsComponent(EventManager& eventManager, Entity& parentEntity, const sf::Font& font, unsigned int characterSize = 14u);
+
+		~RenderStatisticsComponent() = default;
+
+	public:
+		void Draw(sf::RenderTarget& target) const override;
+
+		sf::FloatRect GetLocalBounds() const override;
+
+		void SetText(const std::string& value);
+
+		inline void SetColor(const sf::Color& color) { text.setFillColor(color); }
+
+	private:
+		sf::Text text;
+	};
+
+} // namespace mbe
@@ -0,0 +1,33 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::RenderStatisticsSystem
+
+#include <sstream>
+
+#include <MBE/Graphics/BaseComponentRenderSystem.h>
+#include <MBE/Graphics/RenderSystem.h>
+#include <MBE/Graphics/RenderStatisticsComponent.h>
+
+namespace mbe
+{
+
+	/// @brief Writes the render statistics of the last frame into the mbe::RenderStatisticsComponent of every entity
+	/// @details This system can be added to the mbe::RenderSystem using RenderSystem::AddComponentRenderer().
+	class RenderStatisticsSystem : public BaseComponentRenderSystem
+	{
+	public:
+		/// @brief Constructor
+		/// @param renderSystem The render system whose statistics are displayed. It must outlive this system.
+		RenderStatisticsSystem(const EntityManager& entityManager, const RenderSystem& renderSystem);
+
+		~RenderStatisticsSystem() = default;
+
+	public:
+		void Update() override;
+
+	private:
+		const RenderSystem& renderSystem;
+	};
+
+} // namespace mbe
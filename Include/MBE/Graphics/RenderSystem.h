@@ -7,19 +7,26 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <ostream>
 #include <algorithm>
 #include <functional>
 #include <cassert>
 
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/View.hpp>
+#include <SFML/System/Clock.hpp>
 
 #include <MBE/TransformComponent.h>
 #include <MBE/Graphics/RenderComponent.h>
 #include <MBE/Graphics/BaseComponentRenderSystem.h>
+#include <MBE/Graphics/SpatialGrid.h>
+#include <MBE/Graphics/RenderCommandList.h>
 #include <MBE/Graphics/RenderInformationComponent.h>
 #include <MBE/Graphics/TextureWrapperComponent.h>
 #include <MBE/Core/AssetHolder.h>
+#include <MBE/Core/ThreadPool.h>
 
 #include <MBE/Core/EventManager.h>
 #include <MBE/Core/EntityCreatedEvent.h>
@@ -30,9 +37,27 @@ using mbe::event::EntityRemovedEvent;
 
 namespace mbe
 {
+	namespace detail
+	{
+		/// @brief The maximum number of changed z-order keys per layer for which the sorted draw order is fixed up using an insertion sort
+		/// @details When more keys have changed, the draw order is sorted using a merge sort.
+		constexpr size_t MAX_INSERTION_SORT_CHANGED_KEY_COUNT = 16;
+
+		/// @brief The number of pixels by which a layer cache extends beyond each side of the view
+		/// @details The cache is reused as long as the view stays within this guard band.
+		constexpr unsigned int LAYER_CACHE_GUARD_BAND_SIZE = 128u;
+	} // namespace detail
+
 	/// @brief Takes care of drawing all entities with a mbe::RenderComponent in the correct order
 	/// @details A mbe::Entity can be registered by raising the mbe::event::EntityCreatedEvent.
 	/// Similarly, it can be unregistered by raising the mbe::event::RenderNodeRemovedEvent.
+	/// Each render layer indexes the global bounds of its entities in a mbe::SpatialGrid, so that only the entities
+	/// within the view are considered for drawing. The bounds are only recalculated when the revision of a render component changes.
+	/// Consecutive entities (in draw order) that share a texture are merged into a single draw call.
+	/// @n Rendering is split into two stages. Prepare() assigns the z-order, culls and sorts the entities and records the draw calls
+	/// of each layer in a mbe::RenderCommandList. Submit() replays the command lists on the thread that owns the window.
+	/// When a mbe::ThreadPool is set, the layers are prepared in parallel and the sprite vertices of large layers are generated in parallel.
+	/// @n Layers that rarely change (e.g. the tiled terrain layers) can be cached (see SetLayerCachingEnabled()).
 	/// @n The render system already has component renderers for the
 	/// - SpriteRenderComponent
 	/// - TiledRenderComponent
@@ -43,13 +68,148 @@ namespace mbe
 	{
 	public:
 		// The signature of the function that is used to assign the zOrder to a layer of render entities
+		// The function must not reorder or resize the list
 		typedef std::function<void(std::vector<Entity::ID>&)> ZOrderAssignmentFunction;
 
 		// When using the std::unordered_map operator[] the a default sf::View instance is created
 		typedef std::unordered_map<RenderLayer, sf::View> ViewDictionary;
 
-		// When using the std::unordered_map operator[] an emtpty std::vector<RenderObject::ID>() is created
-		typedef std::unordered_map<RenderLayer, std::vector<Entity::ID>> RenderEntityDictionary;
+		/// @brief The counters of a single render layer in the last frame
+		struct LayerStatistics
+		{
+			/// @brief The number of registered render entities
+			size_t consideredEntityCount = 0;
+			/// @brief The number of render entities outside the view (or outside the strips that are drawn to the layer cache)
+			size_t culledEntityCount = 0;
+			/// @brief The number of render entities that have been drawn (batched or not)
+			size_t drawnEntityCount = 0;
+			/// @brief Every unbatched render entity is counted as a single draw call
+			size_t drawCallCount = 0;
+			size_t batchedSpriteCount = 0;
+			/// @brief The number of vertices of the batched sprites (the vertices drawn by unbatched render entities are not known)
+			size_t vertexCount = 0;
+			/// @brief The number of texture changes between batched draw calls
+			size_t textureSwitchCount = 0;
+			/// @brief The time taken by the z-order assignment and sorting
+			sf::Time sortTime;
+		};
+
+		typedef std::unordered_map<RenderLayer, LayerStatistics> LayerStatisticsDictionary;
+
+		/// @brief The counters of the last frame summed over all render layers
+		struct RenderStatistics : public LayerStatistics
+		{
+			/// @brief The time taken by the last call to Prepare()
+			sf::Time prepareTime;
+			/// @brief The time taken by the last call to Submit() (on the CPU)
+			sf::Time submitTime;
+			LayerStatisticsDictionary layerStatisticsDictionary;
+		};
+
+	private:
+		// The components of a render entity are cached so that they do not have to be looked up every frame
+		// Components are never removed from an entity, so the pointers are valid for as long as the entity is valid
+		struct RenderEntity
+		{
+			Entity::ID entityId;
+			// Null if the slot is free
+			const RenderComponent* renderComponent = nullptr;
+			RenderInformationComponent* renderInformationComponent = nullptr;
+			// Null if the entity does not have a mbe::TransformComponent (it may be added later)
+			const TransformComponent* transformComponent = nullptr;
+			// Whether the global bounds are stored in the spatial grid (see RenderComponent::IsRevisionTracked())
+			bool tracked = false;
+			// The revision of the render component when its global bounds have last been inserted into the spatial grid
+			unsigned long long boundsRevision = 0;
+			// The position in the draw order
+			size_t sortIndex = 0;
+			// The last frame in which the entity has been found to be on screen
+			unsigned int visibleFrame = 0;
+		};
+
+		// The cached z-order of a render entity and its slot in the render entity slot list
+		struct SortKey
+		{
+			float zOrder;
+			size_t slot;
+		};
+
+		// The composed output of a layer rendered to an offscreen texture
+		// The texture covers the view and a guard band around it (aligned to the pixel grid)
+		struct LayerCache
+		{
+			enum class Action
+			{
+				// The layer is not cached this frame and is drawn directly
+				None,
+				// The cached texture is drawn as it is
+				Reuse,
+				// The view has moved past the guard band. The cached pixels are copied and only the newly exposed strips are drawn.
+				Shift,
+				// The content or the scale has changed. The whole texture is drawn again.
+				Rebuild
+			};
+
+			bool enabled = false;
+			// Whether the front texture holds the content of the area
+			// This is only set once the texture has been drawn, so that a Prepare() without a Submit() does not commit anything
+			bool valid = false;
+			Action action = Action::None;
+
+			// The front texture holds the cached content. The back texture is drawn to when shifting or rebuilding and then swapped.
+			// The textures are only created and drawn to on the thread that submits
+			std::unique_ptr<sf::RenderTexture> frontTexture;
+			std::unique_ptr<sf::RenderTexture> backTexture;
+
+			// The world area that is covered by the front texture
+			sf::FloatRect area;
+			sf::Vector2u pixelSize;
+			// The size of a pixel in world coordinates
+			sf::Vector2f pixelWorldSize;
+
+			// The area, size and pixel size of the texture that is drawn this frame
+			// They become the ones of the front texture after it has been drawn
+			sf::FloatRect nextArea;
+			sf::Vector2u nextPixelSize;
+			sf::Vector2f nextPixelWorldSize;
+			// The position of the front texture in the next texture when shifting (in pixels)
+			sf::Vector2i shift;
+			// The parts of the next texture (in pixels) that must be drawn this frame
+			std::vector<sf::IntRect> stripList;
+		};
+
+		// The render entities of a single layer
+		struct RenderLayerData
+		{
+			// The ids of all registered entities (passed to the z-order assignment function)
+			std::vector<Entity::ID> entityIdList;
+			// The slot of a render entity does not change while it is registered. Free slots are reused.
+			std::vector<RenderEntity> renderEntitySlotList;
+			std::vector<size_t> freeSlotList;
+			// The draw order. This list is kept sorted between frames so that it only needs to be fixed up.
+			std::vector<SortKey> sortKeyList;
+			// The number of entities that have been added since the last sort
+			size_t addedKeyCount = 0;
+			// The slots of the entities whose z-order has changed since the last sort (may contain duplicates and free slots)
+			std::vector<size_t> changedSlotList;
+			// Indexes the global bounds of the tracked render entities by their slot
+			SpatialGrid spatialGrid;
+			// The slots of the untracked render entities. These are tested against the view every frame.
+			std::vector<size_t> untrackedSlotList;
+			// The slots of the on screen render entities in draw order (reused every frame)
+			std::vector<size_t> drawSlotList;
+			unsigned int frame = 0;
+			// The draw calls of the last call to Prepare()
+			RenderCommandList commandList;
+			LayerStatistics statistics;
+			// Set whenever an entity has been added, removed, changed or reordered
+			bool contentChanged = true;
+			LayerCache layerCache;
+		};
+
+	public:
+		// When using the std::unordered_map operator[] an empty RenderLayerData is created
+		typedef std::unordered_map<RenderLayer, RenderLayerData> RenderEntityDictionary;
 
 		typedef std::unordered_map<RenderLayer, ZOrderAssignmentFunction> ZOrderAssignmentFunctionDictionary;
 
@@ -67,9 +227,26 @@ namespace mbe
 		~RenderSystem();
 
 		/// @brief Draws all the registered entites
-		/// @details Entities are only drawn when visible on screen.
+		/// @details Entities are only drawn when visible on screen. This is the same as calling Prepare() followed by Submit().
 		void Render();
 
+		/// @brief Builds the render command lists of all layers
+		/// @details The mbe::BaseComponentRenderSystem instances are updated first (on the calling thread).
+		/// If a thread pool has been set, each layer is then prepared as a separate task. In that case, the z-order assignment functions
+		/// and the mbe::RenderComponent functions used for culling and batching must not modify state that is shared between layers.
+		/// Since calculating the world transforms is not thread safe, the dirty world transforms of the render entities are calculated on the calling thread first.
+		void Prepare();
+
+		/// @brief Draws the command lists that have been built by the last call to Prepare()
+		/// @details This must be called on the thread that owns the window. The vertices of batched entities have been copied,
+		/// so they may change during submission. Unbatched entities are drawn in their current state.
+		void Submit();
+
+		/// @brief Sets the thread pool that is used to prepare the render layers in parallel
+		/// @param threadPool The thread pool or nullptr to prepare the layers on the calling thread (default).
+		/// The thread pool must outlive the render system or be reset.
+		inline void SetThreadPool(ThreadPool* threadPool) { this->threadPool = threadPool; }
+
 		template <class TComponentRenderSystem, typename ...TArguments>
 		void AddComponentRenderer(TArguments&&... arguments);
 
@@ -84,6 +261,37 @@ namespace mbe
 		inline sf::RenderWindow& GetRenderWindow() { return window; }
 		inline const sf::RenderWindow& GetRenderWindow() const { return window; }
 
+		/// @brief Enables or disables merging consecutive entities that share a texture into a single draw call
+		/// @details Batching is enabled by default. Disabling it can be useful for comparing the number of draw calls.
+		inline void SetBatchingEnabled(bool value = true) { batchingEnabled = value; }
+
+		inline bool IsBatchingEnabled() const { return batchingEnabled; }
+
+		/// @brief Returns the counters of the last frame
+		/// @details The statistics are complete after calling Submit().
+		inline const RenderStatistics& GetRenderStatistics() const { return renderStatistics; }
+
+		/// @brief Sets the cell size of the spatial grid that is used for culling the entities of a render layer
+		/// @details The cell size should be a few times larger than the typical entity in the layer. The default is 256.
+		/// @param renderLayer The render layer whose spatial grid is rebuilt
+		/// @param cellSize The width and height of a grid cell in world coordinates
+		void SetCullingCellSize(RenderLayer renderLayer, float cellSize);
+
+		/// @brief Enables or disables caching the composed output of a render layer in an offscreen texture
+		/// @details Caching is disabled by default. A cached layer is only drawn again when an entity in the layer is added, removed,
+		/// reordered or changes its revision, or when the view is zoomed. When the view moves beyond the guard band
+		/// (see detail::LAYER_CACHE_GUARD_BAND_SIZE), only the newly exposed strips are drawn.
+		/// @n Layers with rotated views or with entities that are not revision tracked (see mbe::RenderComponent::IsRevisionTracked()) are drawn directly.
+		/// @param renderLayer The render layer to cache
+		/// @param value Whether the layer should be cached
+		void SetLayerCachingEnabled(RenderLayer renderLayer, bool value = true);
+
+		bool IsLayerCachingEnabled(RenderLayer renderLayer) const;
+
+		/// @brief Forces a cached layer to be drawn again in the next frame
+		/// @details This is only needed for changes that do not change the revision of a render component, e.g. when the content of a texture is updated.
+		void InvalidateLayerCache(RenderLayer renderLayer);
+
 	private:
 		void AddRenderEntity(Entity::ID entityId);
 		void RemoveRenderEntity(Entity::ID entityId);
@@ -95,12 +303,56 @@ namespace mbe
 		// Removes expires render entities
 		void Refresh();
 
+		// Calculates the dirty world transforms of all render entities and their parents
+		// The transforms are calculated lazily otherwise, which is not thread safe since the parents may be in other layers
+		void ResolveWorldTransforms();
+
+		// Removes the render entities for which the predicate returns true
+		template <typename TPredicate>
+		static void RemoveRenderEntities(RenderLayerData& renderLayerData, TPredicate predicate);
+
+		// Updates the cached z-order keys of the changed entities and sorts them if necessary
+		// If only a few keys have changed, each of them is moved to its new place in the sorted list
+		// Otherwise a merge sort is used. Neither changes the order of unchanged entities, which prevents flickering of entities with the same z-order.
+		static void SortByZOrder(RenderLayerData& renderLayerData);
+
+		// Moves the sort key at the sort index to its place in the otherwise sorted range [0, endIndex)
+		static void MoveSortKey(RenderLayerData& renderLayerData, size_t sortIndex, size_t endIndex);
+
+		// Stores the position of every render entity in the draw order
+		static void UpdateSortIndices(RenderLayerData& renderLayerData);
+
+		// Reinserts the global bounds of the tracked render entities whose revision has changed
+		static void UpdateSpatialGrid(RenderLayerData& renderLayerData);
+
 		// Culling
-		bool IsVisible(const Entity& entity, const sf::View& view);
+		// Fills the draw slot list with the render entities that intersect the view in draw order
+		static void BuildDrawList(RenderLayerData& renderLayerData, const sf::View& view);
+
+		// Fills the draw slot list with the tracked render entities that intersect any of the areas in draw order
+		static void BuildDrawList(RenderLayerData& renderLayerData, const std::vector<sf::FloatRect>& areaList);
 
-		// Performs an insertion sort
-		// Assumes that render nodes exist for all render node ids
-		static void SortByZOrder(std::vector<Entity::ID>& renderNodeIdList);
+		// Brings the slots in the draw slot list into draw order and removes duplicates
+		static void SortDrawList(RenderLayerData& renderLayerData);
+
+		// Decides whether the layer cache is reused, shifted or rebuilt and fills the draw slot list with the entities that must be drawn to the cache
+		// Returns false if the layer can not be cached this frame
+		static bool PrepareLayerCache(RenderLayerData& renderLayerData, const sf::View& view, const sf::Vector2u& targetSize);
+
+		// Draws the strips of the layer cache and then the cached texture to the window
+		void SubmitLayerCache(RenderLayerData& renderLayerData);
+
+		// Counts the draw calls, vertices and texture switches of a submitted layer
+		static void UpdateLayerStatistics(RenderLayerData& renderLayerData);
+
+		// Returns the world coordinates of a rectangle in the pixels of the next layer cache texture
+		static sf::FloatRect MapCachePixelsToArea(const LayerCache& layerCache, const sf::IntRect& pixelRect);
+
+		// Assigns the z-order, sorts, culls and records the draw calls of a single layer
+		// Only the passed in layer data is modified, so different layers can be prepared concurrently
+		// The vertices of the batched sprites are generated using the thread pool (if not null)
+		static void PrepareLayer(RenderLayerData& renderLayerData, const sf::View& view, const sf::Vector2u& targetSize,
+			const ZOrderAssignmentFunction& zOrderAssignmentFunction, bool batchingEnabled, ThreadPool* threadPool);
 
 	private:
 		// A reference to the pointer is stored so that when a new window is created the correct pointer is referenced
@@ -112,6 +364,10 @@ namespace mbe
 		ZOrderAssignmentFunctionDictionary zOrderAssignmentFunctionDictionary;
 		ComponentRenderSystemList componentRenderSystemList;
 
+		bool batchingEnabled;
+		RenderStatistics renderStatistics;
+		ThreadPool* threadPool;
+
 		// Refernce to the event manager
 		EventManager& eventManager;
 
@@ -121,6 +377,10 @@ namespace mbe
 		EventManager::SubscriptionID textureWrapperChangedSubscription;
 	};
 
+	/// @brief Writes the render statistics in a human readable form (one line for the totals and one line per render layer)
+	/// @details This is used by the mbe::RenderStatisticsSystem and can be used to write benchmark logs.
+	std::ostream& operator << (std::ostream& stream, const RenderSystem::RenderStatistics& renderStatistics);
+
 #pragma region Template Implementations
 
 	template<class TComponentRenderSystem, typename ...TArguments>
@@ -130,6 +390,50 @@ namespace mbe
 		componentRenderSystemList.emplace_back(std::move(ptr));
 	}
 
+	template<typename TPredicate>
+	inline void RenderSystem::RemoveRenderEntities(RenderLayerData& renderLayerData, TPredicate predicate)
+	{
+		auto& renderEntitySlotList = renderLayerData.renderEntitySlotList;
+
+		bool removed = false;
+		for (size_t slot = 0; slot < renderEntitySlotList.size(); slot++)
+		{
+			auto& renderEntity = renderEntitySlotList[slot];
+			if (renderEntity.renderComponent == nullptr || predicate(renderEntity) == false)
+				continue;
+
+			renderLayerData.spatialGrid.Remove(slot);
+			if (renderEntity.entityId.Valid())
+				renderEntity.renderInformationComponent->ResetZOrderChangedFunction();
+			renderEntity = RenderEntity();
+			renderLayerData.freeSlotList.push_back(slot);
+			renderLayerData.contentChanged = true;
+			removed = true;
+		}
+
+		if (removed == false)
+			return;
+
+		const auto isFree = [&renderEntitySlotList](size_t slot) { return renderEntitySlotList[slot].renderComponent == nullptr; };
+
+		// Remove the sort keys of the removed entities while keeping the sorted order
+		auto& sortKeyList = renderLayerData.sortKeyList;
+		sortKeyList.erase(std::remove_if(sortKeyList.begin(), sortKeyList.end(), [&isFree](const SortKey& sortKey)
+			{
+				return isFree(sortKey.slot);
+			}), sortKeyList.end());
+
+		auto& untrackedSlotList = renderLayerData.untrackedSlotList;
+		untrackedSlotList.erase(std::remove_if(untrackedSlotList.begin(), untrackedSlotList.end(), isFree), untrackedSlotList.end());
+
+		// Rebuild the entity id list from the remaining entities
+		renderLayerData.entityIdList.clear();
+		for (const auto& sortKey : sortKeyList)
+			renderLayerData.entityIdList.push_back(renderEntitySlotList[sortKey.slot].entityId);
+
+		UpdateSortIndices(renderLayerData);
+	}
+
 #pragma endregion
 
 } // namespace mbe
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::SpatialGrid
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+namespace mbe
+{
+	/// @brief A uniform grid that indexes rectangles for fast area, radius, nearest neighbour and ray queries
+	/// @details The values are identified by dense indices (e.g. the index of a slot in a list).
+	/// Every value is stored in all the cells its bounds overlap. Values that overlap too many cells
+	/// (e.g. a tile map layer that covers the entire world) are stored in a separate list that is tested on every query.
+	/// Only the cells that are actually occupied are allocated, so the world does not need to have a fixed size.
+	/// @n The bounds are treated as closed rectangles, so values with an empty size (points) can be found as well.
+	class SpatialGrid
+	{
+	public:
+		/// @brief The index used to identify a value in the grid
+		typedef size_t ValueID;
+
+		/// @brief Function that returns whether a value should be considered by a nearest neighbour query
+		typedef std::function<bool(ValueID)> Filter;
+
+	private:
+		// The inclusive range of cells overlapped by a value
+		struct CellRange
+		{
+			int left;
+			int top;
+			int right;
+			int bottom;
+		};
+
+		struct Entry
+		{
+			sf::FloatRect bounds;
+			CellRange cellRange;
+			bool inserted = false;
+			bool large = false;
+			// The last query in which this value has been returned (prevents duplicates)
+			unsigned int queryStamp = 0;
+		};
+
+		typedef unsigned long long CellKey;
+
+	public:
+		/// @brief Constructor
+		/// @param cellSize The width and height of a cell. It should be a few times larger than the typical value.
+		/// @param maxCellCount The maximum number of cells a value can overlap before it is treated as a large value
+		explicit SpatialGrid(float cellSize = 256.f, size_t maxCellCount = 64);
+
+		/// @brief Default destructor
+		~SpatialGrid() = default;
+
+	public:
+		/// @brief Inserts a value or updates its bounds if it has already been inserted
+		/// @details The value is only moved between cells if its cell range has changed
+		/// @param valueId The index of the value
+		/// @param bounds The bounds of the value
+		void Insert(ValueID valueId, const sf::FloatRect & bounds);
+
+		/// @brief Removes a value from the grid
+		/// @details Nothing happens if the value has not been inserted
+		/// @param valueId The index of the value to remove
+		void Remove(ValueID valueId);
+
+		/// @brief Removes all values from the grid
+		void Clear();
+
+		/// @brief Appends the values whose bounds intersect the area to the result list
+		/// @details Every value is returned at most once. The order of the values is undefined.
+		/// @param area The area to query
+		/// @param resultList The list to which the values are appended
+		void Query(const sf::FloatRect & area, std::vector<ValueID> & resultList);
+
+		/// @brief Appends the values whose bounds are at most radius away from the center to the result list
+		/// @details Every value is returned at most once. The order of the values is undefined.
+		/// @param center The center of the circle to query
+		/// @param radius The radius of the circle to query
+		/// @param resultList The list to which the values are appended
+		void QueryRadius(const sf::Vector2f & center, float radius, std::vector<ValueID> & resultList);
+
+		/// @brief Appends the values whose bounds are closest to the point to the result list
+		/// @details The cells are searched in rings around the point until no unvisited cell can contain a closer value.
+		/// The values are appended in the order of increasing distance. Values whose bounds contain the point have a distance of 0.
+		/// @param point The point from which the distance is measured
+		/// @param count The maximum number of values to return
+		/// @param resultList The list to which the values are appended
+		/// @param filter Values for which the filter returns false are ignored (e.g. entities without a certain component).
+		/// It is called at most once per value. If it is empty, every value is considered.
+		/// @param maxDistance Values that are further away are ignored
+		void QueryNearest(const sf::Vector2f & point, size_t count, std::vector<ValueID> & resultList,
+			const Filter & filter = nullptr, float maxDistance = std::numeric_limits<float>::infinity());
+
+		/// @brief Appends the values whose bounds are hit by a ray to the result list
+		/// @details Only the cells along the ray are visited. The values are appended in the order in which the ray hits them.
+		/// @param origin The start of the ray
+		/// @param direction The direction of the ray. It does not need to be normalised but must not be zero.
+		/// @param maxDistance The length of the ray. It must be finite.
+		/// @param resultList The list to which the values are appended
+		/// @param radius The bounds are extended by this value on all sides, which turns the ray into a thick line.
+		/// This is needed to hit values with an empty size.
+		void QueryRay(const sf::Vector2f & origin, const sf::Vector2f & direction, float maxDistance, std::vector<ValueID> & resultList, float radius = 0.f);
+
+		/// @brief Returns whether the value has been inserted
+		bool Contains(ValueID valueId) const;
+
+		/// @brief Returns the cell size
+		inline float GetCellSize() const { return cellSize; }
+
+	private:
+		CellRange GetCellRange(const sf::FloatRect & bounds) const;
+		CellRange GetCellRange(int x, int y, int extent) const;
+
+		// Calls the function once for every value that overlaps a cell in the range (and every large value)
+		// The query stamp must have been incremented
+		template <class TFunction>
+		void ForEachValue(const CellRange & cellRange, TFunction function);
+
+		// Calls the function for every value in the cell that has not been visited during the current query
+		template <class TFunction>
+		void ForEachValueInCell(int x, int y, TFunction function);
+
+		void AddToCells(ValueID valueId, const CellRange & cellRange);
+		void RemoveFromCells(ValueID valueId, const CellRange & cellRange);
+
+		static CellKey GetCellKey(int x, int y);
+		static size_t GetCellCount(const CellRange & cellRange);
+
+		// Closed rectangle intersection (unlike sf::Rect::intersects(), rectangles with an empty size can intersect)
+		static bool Intersects(const sf::FloatRect & a, const sf::FloatRect & b);
+		// Returns the distance from the point to the closest point of the bounds
+		static float GetDistance(const sf::FloatRect & bounds, const sf::Vector2f & point);
+		// Returns whether the ray (with a normalised direction) hits the bounds and the distance to the first hit
+		static bool IntersectsRay(const sf::FloatRect & bounds, const sf::Vector2f & origin, const sf::Vector2f & direction, float & distance);
+
+	private:
+		float cellSize;
+		size_t maxCellCount;
+		unsigned int queryStamp;
+
+		// Indexed by the value id
+		std::vector<Entry> entryList;
+		std::unordered_map<CellKey, std::vector<ValueID>> cellDictionary;
+		std::vector<ValueID> largeValueIdList;
+
+		// The distances and values found by the current nearest neighbour or ray query (reused between queries)
+		std::vector<std::pair<float, ValueID>> candidateList;
+	};
+
+} // namespace mbe
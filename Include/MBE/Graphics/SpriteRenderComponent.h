@@ -22,8 +22,17 @@ namespace mbe
 
 		void Draw(sf::RenderTarget& target) const override;
 
+		// Sprites are always batched by texture
+		bool AppendToCommandList(RenderCommandList& commandList) const override;
+
+		// Applies the transform of this component (rather than looking up the entity's transform component)
+		sf::FloatRect GetGlobalBounds() const override;
+
 		sf::FloatRect GetLocalBounds() const override;
 
+		// The revision is incremented by all setters that change a value
+		bool IsRevisionTracked() const override;
+
 		inline const sf::Color& GetColor() const { return sprite.getColor(); }
 
 		inline const sf::Texture* GetTexture() const { return sprite.getTexture(); }
@@ -32,13 +41,13 @@ namespace mbe
 
 		inline const sf::Transform& GetTransform() const { return transform; }
 
-		inline void SetColor(const sf::Color& color) { sprite.setColor(color); }
+		void SetColor(const sf::Color& color);
 
-		inline void SetTexture(const sf::Texture& texture, bool resetRect = false) { sprite.setTexture(texture, resetRect); }
+		void SetTexture(const sf::Texture& texture, bool resetRect = false);
 
-		inline void SetTextureRect(const sf::IntRect& textureRect) { sprite.setTextureRect(textureRect); }
+		void SetTextureRect(const sf::IntRect& textureRect);
 
-		inline void SetTransform(const sf::Transform& transform) { this->transform = transform; }
+		void SetTransform(const sf::Transform& transform);
 
 	private:
 		mutable sf::Sprite sprite;
@@ -4,10 +4,12 @@
 /// @brief Class mbe::SpriteRenderSystem
 
 #include <cassert>
+#include <unordered_set>
 
 #include <MBE/Graphics/BaseComponentRenderSystem.h>
 #include <MBE/Core/EventManager.h>
 #include <MBE/Core/EntityCreatedEvent.h>
+#include <MBE/Core/ComponentValueChangedEvent.h>
 
 #include <MBE/Graphics/SpriteRenderComponent.h>
 #include <MBE/Graphics/TextureWrapperComponent.h>
@@ -16,6 +18,10 @@
 namespace mbe
 {
 
+	/// @brief Keeps the texture, texture rect and transform of the mbe::SpriteRenderComponent in sync with the entity's other components
+	/// @details Sprites are only updated when they are created or when their mbe::TransformComponent or mbe::TextureWrapperComponent
+	/// raises a mbe::event::ComponentValueChangedEvent. The changed entities are collected and updated once per frame,
+	/// so static sprites do not cost anything.
 	class SpriteRenderSystem : public BaseComponentRenderSystem
 	{
 	public:
@@ -30,14 +36,30 @@ namespace mbe
 		~SpriteRenderSystem();
 
 	public:
+		// Updates the sprites that have changed since the last update
 		void Update() override;
 
+		// Returns the number of sprites that have been updated in the last call to Update()
+		inline size_t GetUpdatedSpriteCount() const { return updatedSpriteCount; }
+
 	private:
 		void OnEntityCreatedEvent(Entity & entity);
 
+		// Adds the entity to the dirty entity set if it has a mbe::SpriteRenderComponent
+		void MarkDirty(Entity & entity);
+
+		// Sets the sprite's texture, texture rect and transform from the entity's components
+		static void UpdateSprite(Entity & entity);
+
 	private:
 		EventManager & eventManager;
 		EventManager::SubscriptionID entityCreatedSubscription;
+		EventManager::SubscriptionID transformChangedSubscription;
+		EventManager::SubscriptionID textureWrapperChangedSubscription;
+
+		// The entities whose sprites must be updated
+		std::unordered_set<Entity::ID> dirtyEntityIdSet;
+		size_t updatedSpriteCount;
 	};
 
 } // namespace mbe
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::TextureAtlas
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief The maximum width and height of a texture atlas page
+		/// @details The page size is further limited by sf::Texture::getMaximumSize()
+		constexpr unsigned int MAX_TEXTURE_ATLAS_PAGE_SIZE = 2048u;
+
+		/// @brief The number of transparent pixels between two images in a texture atlas page
+		/// @details This prevents neighbouring images from bleeding into each other when the texture is smoothed
+		constexpr unsigned int TEXTURE_ATLAS_PADDING = 1u;
+
+		/// @brief The version of the texture atlas layout cache file
+		constexpr unsigned int TEXTURE_ATLAS_CACHE_VERSION = 1u;
+	} // namespace detail
+
+	/// @brief Packs images into one or more texture pages
+	/// @details Images are added using their file path and then packed into pages using a shelf packer.
+	/// Sprites whose textures share a page can be drawn with a single draw call (see mbe::RenderCommandList).
+	/// @n The packed layout is stored in a cache file. As long as the same images with the same sizes are added,
+	/// the layout is read from the cache instead of being packed again.
+	/// @n Images that are larger than a page are not packed (Contains() returns false for them).
+	class TextureAtlas : private sf::NonCopyable
+	{
+	public:
+		/// @brief The position of a packed image
+		struct Region
+		{
+			size_t pageIndex;
+			/// @brief The area of the page that is covered by the image (in pixels)
+			sf::IntRect textureRect;
+		};
+
+	private:
+		struct Entry
+		{
+			std::string filePath;
+			sf::Image image;
+			Region region;
+			bool packed = false;
+		};
+
+	public:
+		/// @brief Constructor
+		/// @param maxPageSize The maximum width and height of a page
+		explicit TextureAtlas(unsigned int maxPageSize = detail::MAX_TEXTURE_ATLAS_PAGE_SIZE);
+
+		/// @brief Default destructor
+		~TextureAtlas() = default;
+
+	public:
+		/// @brief Loads an image that is packed when calling Pack()
+		/// @details Adding the same file path more than once has no effect
+		/// @param filePath The file path of the image
+		/// @throws std::runtime_error if the image failed to load
+		/// @throws std::runtime_error if the atlas has already been packed
+		void AddImage(const std::string & filePath);
+
+		/// @brief Packs the added images and creates the page textures
+		/// @details If the cache file describes a layout for exactly the added images, that layout is used.
+		/// Otherwise, the images are packed and the layout is written to the cache file.
+		/// @param cacheFilePath The file path of the layout cache. Failing to write the cache is not an error.
+		/// @throws std::runtime_error if a page texture could not be created
+		void Pack(const std::string & cacheFilePath);
+
+		/// @brief Returns true if the image has been packed into a page
+		bool Contains(const std::string & filePath) const;
+
+		/// @brief Returns the position of a packed image
+		/// @throws std::runtime_error if the image has not been packed
+		const Region & GetRegion(const std::string & filePath) const;
+
+		/// @brief Returns the image as it has been loaded from the file
+		/// @details This can be used to create a mbe::PixelMask in the original image space
+		/// @throws std::runtime_error if the image has not been added
+		const sf::Image & GetImage(const std::string & filePath) const;
+
+		/// @brief Returns the texture of a page
+		/// @details The texture is shared with all mbe::TextureWrapper instances that have been loaded from this page
+		std::shared_ptr<sf::Texture> GetPage(size_t pageIndex) const;
+
+		inline size_t GetPageCount() const { return pageList.size(); }
+
+		/// @brief Returns true if the layout of the last call to Pack() has been read from the cache file
+		inline bool IsLoadedFromCache() const { return loadedFromCache; }
+
+	private:
+		// Returns false if the cache does not exist or does not match the added images
+		bool LoadLayout(const std::string & cacheFilePath);
+		void StoreLayout(const std::string & cacheFilePath) const;
+
+		// Shelf packing: the images are sorted by height and placed next to each other in rows (shelves)
+		void PackShelves();
+
+		void CreatePages();
+
+		const Entry & GetEntry(const std::string & filePath) const;
+
+	private:
+		unsigned int maxPageSize;
+		bool loadedFromCache;
+
+		std::vector<Entry> entryList;
+		std::unordered_map<std::string, size_t> entryIndexDictionary;
+
+		std::vector<sf::Vector2u> pageSizeList;
+		std::vector<std::shared_ptr<sf::Texture>> pageList;
+	};
+
+} // namespace mbe
@@ -3,9 +3,11 @@
 /// @file
 /// @brief Class mbe::TextureWrapper
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
 #include <MBE/Core/PixelMask.h>
+#include <MBE/Graphics/TextureAtlas.h>
 
 namespace mbe
 {
@@ -31,6 +33,15 @@ namespace mbe
 		/// @see mbe::AssetHolder
 		bool loadFromFile(std::string filePath, bool createPixelMask = false);
 
+		/// @brief Loads a texture from a page of a texture atlas and optionally creates a pixel mask for it
+		/// @details If the image has not been packed into the atlas, it is loaded from the file instead.
+		/// The pixel mask is created from the original image, so it is in the same coordinate space as the texture rects
+		/// (see GetSize() and MapTextureRect()).
+		/// @param filePath The file path of the image that has been added to the texture atlas
+		/// @param textureAtlas The packed texture atlas
+		/// @param createPixelMask If true, a pixel mask is created for the image
+		bool loadFromFile(std::string filePath, const TextureAtlas & textureAtlas, bool createPixelMask = false);
+
 		// returns nullptr if the pixel mask has not been created yet
 		inline const PixelMask::Ptr GetPixelMask() const { return pixelMask; }
 
@@ -42,8 +53,24 @@ namespace mbe
 		// const overload
 		inline const sf::Texture & GetTexture() const { return *texture; }
 
+		/// @brief Returns the size of the original image
+		/// @details When the texture is an atlas page, this is smaller than the size of the texture.
+		/// Texture rects and pixel mask lookups use the original image space.
+		inline sf::Vector2u GetSize() const { return { static_cast<unsigned int>(atlasRect.width), static_cast<unsigned int>(atlasRect.height) }; }
+
+		/// @brief Returns true if the texture is a page of a texture atlas that is shared with other texture wrappers
+		inline bool IsInAtlas() const { return inAtlas; }
+
+		/// @brief Returns the area of the texture that is covered by the original image
+		inline const sf::IntRect & GetAtlasRect() const { return atlasRect; }
+
+		/// @brief Converts a texture rect from the original image space into texture coordinates
+		sf::IntRect MapTextureRect(const sf::IntRect & textureRect) const;
+
 	private:
 		std::shared_ptr<sf::Texture> texture;
 		PixelMask::Ptr pixelMask;
+		sf::IntRect atlasRect;
+		bool inAtlas = false;
 	};
 }
\ No newline at end of file
@@ -116,6 +116,7 @@ namespace mbe
 		void SetTextureWrapper(const std::string& textureWrapperId, bool resetTextureRect = true);
 
 		// Raises mbe::event::ComponentValueChangedEvent (value = textureRect)
+		// The texture rect is in the space of the original image, also when the texture wrapper has been loaded from a texture atlas
 		void SetTextureRect(const sf::IntRect& textureRect, TextureID textureId);
 		// Set the currently active texture rect
 		void SetTextureRect(const sf::IntRect& textureRect);
@@ -138,6 +139,13 @@ namespace mbe
 		// Get the currently active texture rect
 		const sf::IntRect& GetTextureRect() const;
 
+		// The texture rect in the coordinates of the texture that is drawn
+		// This is only different from GetTextureRect() if the texture wrapper has been loaded from a texture atlas
+		// Throws if no texture wrapper is assigned
+		sf::IntRect GetAtlasTextureRect(TextureID textureId) const;
+		// Get the currently active atlas texture rect
+		sf::IntRect GetAtlasTextureRect() const;
+
 		TextureID GetActiveTextureId() const;
 
 		// Returns the number of textures that have been added to this component
@@ -3,45 +3,78 @@
 /// @file
 /// @brief Class mbe::TiledRenderComponent
 
-#include <iostream>
+#include <vector>
 #include <cassert>
 
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/Texture.hpp>
-#include <SFML/System/Clock.hpp>
 
 #include <MBE/Graphics/RenderComponent.h>
+#include <MBE/Core/ThreadPool.h>
 
 
 namespace mbe
 {
+	namespace detail
+	{
+		/// @brief The width and height (in tiles) of the chunks a mbe::TiledRenderComponent is split into
+		constexpr unsigned int TILE_CHUNK_SIZE = 32u;
+	} // namespace detail
+
 	// Does not store information on the tile index list
 	// Some other system must take care of syncronysing it with the tiled terrain data
+	// The layer is split into chunks of detail::TILE_CHUNK_SIZE x detail::TILE_CHUNK_SIZE tiles, each with its own vertex array
+	// Changing a tile only touches the vertices of its chunk and only the chunks within the view are drawn
 	class TiledRenderComponent : public RenderComponent
 	{
+	private:
+		struct Chunk
+		{
+			sf::VertexArray vertices;
+			// The position of the top left tile of this chunk in tiles
+			sf::Vector2u tileOffset;
+			// The size of this chunk in tiles (chunks at the right and bottom edge may be smaller)
+			sf::Vector2u tileCount;
+		};
+
 	public:
 		TiledRenderComponent(EventManager& eventManager, Entity& parentEntity, const sf::Vector2u& size, const sf::Vector2u& tileSize);
 		~TiledRenderComponent() = default;
 
 	public:
+		// Only draws the chunks that intersect the view of the target
 		void Draw(sf::RenderTarget& target) const override;
 
+		// Applies the transform of the render states (rather than looking up the entity's transform component)
+		sf::FloatRect GetGlobalBounds() const override;
+
 		sf::FloatRect GetLocalBounds() const override;
 
+		// The revision is incremented when the tiles or the render states change
+		bool IsRevisionTracked() const override;
+
 	public:
-		void Create(std::vector<size_t> tileIndexList);
+		// Sets all the tiles of the layer
+		// The tile index list must contain size.x * size.y indices (row by row)
+		// If a thread pool is passed, the chunks are split between its threads (the vertices are allocated in the constructor)
+		// Throws if no texture is set
+		void Create(const std::vector<size_t>& tileIndexList, ThreadPool* threadPool = nullptr);
 
 		// Throws if no texture is set
 		// Cannot calculate the texture coordinates for the tile
+		// Only the vertices of the tile's chunk are changed
 		void SetTile(sf::Vector2u position, size_t tileIndex);
 
-		inline void SetRenderStates(const sf::RenderStates& states) { renderStates = states; }
-
-		inline void SetRenderStates(sf::RenderStates&& states) { renderStates = std::move(states); }
+		void SetRenderStates(const sf::RenderStates& states);
 
 		inline bool IsCreated() const { return isCreated; }
 
-		inline sf::VertexArray& GetVertices() { return vertices; }
+		inline size_t GetChunkCount() const { return chunkList.size(); }
+
+		inline const sf::VertexArray& GetChunkVertices(size_t chunkIndex) const { return chunkList[chunkIndex].vertices; }
+
+		// Returns the local bounds of a chunk (independent of which of its tiles are empty)
+		sf::FloatRect GetChunkLocalBounds(size_t chunkIndex) const;
 
 		inline const sf::Vector2u& GetSize() const { return size; }
 
@@ -54,7 +87,21 @@ namespace mbe
 		static const int emptyTile = -1;
 
 	private:
-		sf::VertexArray vertices;
+		// Returns a pointer to the first of the 4 vertices of the tile
+		sf::Vertex* GetQuad(sf::Vector2u position);
+
+		// Sets the positions and texture coordinates of the 4 vertices of a tile
+		// This does not modify any members, so it can be called concurrently for different tiles
+		void SetQuad(sf::Vertex* quad, sf::Vector2u position, size_t tileIndex, unsigned int tilesetColumnCount) const;
+
+		// Returns the number of tiles in a row of the tileset texture
+		// Throws if no texture is set
+		unsigned int GetTilesetColumnCount() const;
+
+	private:
+		std::vector<Chunk> chunkList;
+		// The number of chunks in each direction
+		sf::Vector2u chunkCount;
 		sf::RenderStates renderStates;
 
 		bool isCreated;
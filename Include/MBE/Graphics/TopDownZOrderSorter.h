@@ -4,6 +4,7 @@
 /// @brief Class mbe::TopDownZOrderSystem
 
 #include <vector>
+#include <unordered_map>
 #include <memory>
 #include <cassert>
 
@@ -15,8 +16,27 @@
 namespace mbe
 {
 	/// @brief Provides functionality to assign the correct z-order to top down objects in a layer
+	/// @details The z-order of an entity is only recalculated when the revision of its mbe::RenderComponent or its logical bottom offset
+	/// has changed since the last call (see mbe::RenderComponent::IsRevisionTracked()). Since the z-order is only set when it changes,
+	/// the mbe::RenderSystem only needs to move the changed entities in the draw order. Layers with many static objects are therefore cheap to sort.
 	class TopDownZOrderSorter
 	{
+	private:
+		// The components of an entity and the values its z-order has last been calculated from
+		// Components are never removed from an entity, so the pointers are valid for as long as the entity is valid
+		struct CacheEntry
+		{
+			const RenderComponent* renderComponent = nullptr;
+			RenderInformationComponent* renderInformationComponent = nullptr;
+			// Null if the entity is not a top down object (it may be added later)
+			const TopDownInformationComponent* topDownInformationComponent = nullptr;
+			unsigned long long revision = 0;
+			float logicalBottomOffset = 0.f;
+			bool calculated = false;
+			// The call in which the entity has last been in the layer
+			unsigned int frame = 0;
+		};
+
 	public:
 		/// @brief Default constructor
 		TopDownZOrderSorter() = default;
@@ -31,5 +51,10 @@ namespace mbe
 		/// @param layer The layer to sort the top down objects in
 		/// @note In order to be sorted the the entity must be in the group: "TopDownObjects" and have the mbe::VisibleObjectInformationComponent
 		void operator() (std::vector<Entity::ID>& layer);
+
+	private:
+		// Keyed by the entity so that removing entities from the layer does not affect the entries of the others
+		std::unordered_map<Entity::ID, CacheEntry> cacheEntryDictionary;
+		unsigned int frame = 0;
 	};
 }
\ No newline at end of file
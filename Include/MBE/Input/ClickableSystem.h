@@ -3,7 +3,10 @@
 /// @file
 /// @brief Class mbe::ClickableSystem
 
+#include <vector>
+
 #include <SFML/System/Vector2.hpp>
+#include <SFML/Window/Mouse.hpp>
 
 #include <MBE/Core/EventManager.h>
 #include <MBE/Core/EntityManager.h>
@@ -19,6 +22,9 @@
 
 namespace mbe
 {
+	// Forward declare the spatial hash and the render system
+	class EntitySpatialHash;
+	class RenderSystem;
 
 	class ClickableSystem
 	{
@@ -26,9 +32,24 @@ namespace mbe
 		ClickableSystem(EventManager& eventManager, EntityManager& entityManager);
 		~ClickableSystem();
 
+	public:
+		/// @brief Finds the clicked entities using a spatial hash instead of testing every clickable entity
+		/// @details The click position is converted to world coordinates using the view of every render layer of the render system
+		/// (and without a view for entities without a mbe::RenderInformationComponent). Only the entities found at these positions are tested.
+		/// Hence, clickable entities must have a mbe::TransformComponent and entities with a mbe::RenderInformationComponent must be drawn by the render system.
+		/// @param spatialHash The spatial hash or nullptr to test every clickable entity (default). It must outlive this system or be reset.
+		/// @param renderSystem The render system whose views are used. It must be set if the spatial hash is set.
+		void SetSpatialHash(EntitySpatialHash* spatialHash, const RenderSystem* renderSystem);
+
 	private:
 		void OnClick(sf::Vector2f clickPosition, sf::Mouse::Button button);
 
+		// Appends the clickable entities found in the spatial hash to the candidate list
+		void FindCandidates(sf::Vector2f clickPosition);
+
+		// Tests the pixel mask of the entity and either raises the click events or adds it to the clicked entity list
+		void TestClick(const Entity& entity, sf::Vector2f clickPosition, sf::Mouse::Button button, std::vector<const Entity*>& clickedEntityList);
+
 		// Reverses view and entity transfroms based on the entity's components
 		sf::Vector2f CalculatePosition(const Entity& entity, sf::Vector2f clickPosition);
 
@@ -40,6 +61,13 @@ namespace mbe
 		EntityManager& entityManager;
 
 		EventManager::SubscriptionID onClickSubscription;
+
+		EntitySpatialHash* spatialHash;
+		const RenderSystem* renderSystem;
+
+		// The entities that may have been clicked (reused between clicks)
+		std::vector<Entity::ID> candidateEntityIdList;
+		std::vector<Entity::ID> queryResultList;
 	};
 
 } // namespace mbe
\ No newline at end of file
@@ -3,6 +3,8 @@
 /// @file
 /// @brief Class mbe::GoalReachedEvent
 
+#include <ostream>
+
 #include <MBE/Core/Entity.h>
 
 namespace mbe
@@ -0,0 +1,50 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::event::PathFoundEvent
+
+#include <vector>
+#include <ostream>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <MBE/Core/Entity.h>
+
+namespace mbe
+{
+	namespace event
+	{
+		/// @brief Raised by the mbe::PathRequestService when the path an entity has requested has been found
+		/// @details If no path exists, a mbe::event::GoalInaccessibleEvent is raised instead.
+		class PathFoundEvent
+		{
+		public:
+			/// @brief A list of tile positions (the same type as mbe::TileMapBase::Position)
+			typedef std::vector<sf::Vector2i> Path;
+
+		public:
+			PathFoundEvent();
+			PathFoundEvent(Entity::ID entityId, Path path);
+			~PathFoundEvent() = default;
+
+		public:
+			inline Entity::ID GetEntityID() const { return entityId; }
+
+			/// @brief Returns the path including the start and the goal tile
+			inline const Path& GetPath() const { return path; }
+
+			inline void SetEntityID(Entity::ID id) { entityId = id; }
+
+			inline void SetPath(Path path) { this->path = std::move(path); }
+
+			/// @brief Allows this class to be written to an out stream
+			/// @details This may be used to output the event's data to the console or a log file
+			friend std::ostream& operator << (std::ostream& stream, const PathFoundEvent& event);
+
+		private:
+			Entity::ID entityId;
+			Path path;
+		};
+
+	} // namespace event
+} // namespace mbe
@@ -0,0 +1,148 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::ReachableTileList
+
+#include <utility>
+#include <type_traits>
+#include <cassert>
+
+namespace mbe
+{
+	/// @brief A bit for each of the eight neighbours of a tile
+	/// @details Bit i stands for the neighbour at the offset (mbe::detail::TILE_NEIGHBOUR_OFFSET_X[i], mbe::detail::TILE_NEIGHBOUR_OFFSET_Y[i]).
+	/// The straight neighbours come first (right, left, down, up), followed by the diagonal ones (bottom right, bottom left, top right, top left).
+	typedef unsigned char TileNeighbourMask;
+
+	namespace detail
+	{
+		/// @brief The x offsets of the neighbours in the order of the bits of a mbe::TileNeighbourMask
+		constexpr int TILE_NEIGHBOUR_OFFSET_X[] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+
+		/// @brief The y offsets of the neighbours in the order of the bits of a mbe::TileNeighbourMask
+		constexpr int TILE_NEIGHBOUR_OFFSET_Y[] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+		/// @brief Returns the bit of the neighbour at the offset or 0 if the offset does not refer to a neighbour
+		constexpr TileNeighbourMask GetTileNeighbourBit(int offsetX, int offsetY)
+		{
+			for (unsigned int i = 0u; i < 8u; i++)
+			{
+				if (TILE_NEIGHBOUR_OFFSET_X[i] == offsetX && TILE_NEIGHBOUR_OFFSET_Y[i] == offsetY)
+					return static_cast<TileNeighbourMask>(1u << i);
+			}
+			return 0u;
+		}
+	} // namespace detail
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// @brief The tiles that can be reached from a tile in a single move
+	/// @details Unlike the std::vector returned by GetReachableTiles(), the tiles are stored in a fixed size array,
+	/// so the list can be created for every node a search expands without allocating.
+	/// @tparam TPosition The type of a map position. It must be constructible from an x and a y coordinate.
+	template <class TPosition>
+	class ReachableTileList
+	{
+	public:
+		/// @brief The maximum number of tiles (the eight neighbours)
+		static constexpr unsigned int MAX_TILE_COUNT = 8u;
+
+	public:
+		/// @brief Creates an empty list
+		ReachableTileList();
+
+		/// @brief Creates the list of the neighbours of a tile whose bits are set in the mask
+		/// @param position The tile whose neighbours are added
+		/// @param neighbourMask The neighbours that can be reached
+		ReachableTileList(TPosition position, TileNeighbourMask neighbourMask);
+
+		/// @brief Default destructor
+		~ReachableTileList() = default;
+
+	public:
+		/// @brief Adds a tile
+		/// @details The list must not be full.
+		inline void PushBack(TPosition position) { assert(tileCount < MAX_TILE_COUNT && "ReachableTileList: The list is full"); tileList[tileCount++] = position; }
+
+		inline unsigned int GetSize() const { return tileCount; }
+
+		inline bool IsEmpty() const { return tileCount == 0u; }
+
+		inline const TPosition & operator[](unsigned int index) const { assert(index < tileCount); return tileList[index]; }
+
+		// Allow range based for loops and the standard algorithms
+		inline const TPosition * begin() const { return tileList; }
+
+		inline const TPosition * end() const { return tileList + tileCount; }
+
+	private:
+		TPosition tileList[MAX_TILE_COUNT];
+		unsigned int tileCount;
+	};
+
+	namespace detail
+	{
+		/// @brief Whether a tile map type provides the GetReachableTileMask(int x, int y) function
+		/// @details A tile map opts in by declaring static constexpr bool HAS_REACHABLE_TILE_MASK = true. mbe::TileMapBase does so,
+		/// so every tile map derived from it uses the masks unless it hides the declaration with false.
+		/// This must only be done if every tile that can be reached from a tile is one of its neighbours, since the mask can not store
+		/// other tiles (e.g. the exit of a teleporter or a ladder).
+		template <class TTileMap, class = void>
+		struct HasReachableTileMask : std::false_type {};
+
+		template <class TTileMap>
+		struct HasReachableTileMask<TTileMap, std::void_t<decltype(TTileMap::HAS_REACHABLE_TILE_MASK)>> : std::bool_constant<TTileMap::HAS_REACHABLE_TILE_MASK> {};
+
+		/// @brief Returns the tiles that can be reached from a tile
+		/// @details If the tile map provides a mask (see mbe::detail::HasReachableTileMask), the tiles are returned as a mbe::ReachableTileList, which does not allocate.
+		/// Otherwise, the result of GetReachableTiles() is returned. In both cases, the result can be iterated over.
+		template <class TTileMap>
+		inline auto GetReachableTileList(const TTileMap & tileMap, typename TTileMap::Position position)
+		{
+			if constexpr (HasReachableTileMask<TTileMap>::value)
+				return ReachableTileList<typename TTileMap::Position>(position, tileMap.GetReachableTileMask(position.x, position.y));
+			else
+				return tileMap.GetReachableTiles(position);
+		}
+
+		/// @brief Returns the neighbours that can be reached from a tile as a mask
+		/// @details If the tile map does not provide a mask, it is created from GetReachableTiles().
+		/// Reachable tiles that are not neighbours are ignored.
+		template <class TTileMap>
+		inline TileNeighbourMask GetReachableTileMask(const TTileMap & tileMap, typename TTileMap::Position position)
+		{
+			if constexpr (HasReachableTileMask<TTileMap>::value)
+			{
+				return tileMap.GetReachableTileMask(position.x, position.y);
+			}
+			else
+			{
+				TileNeighbourMask neighbourMask = 0u;
+				for (const auto & reachablePosition : tileMap.GetReachableTiles(position))
+					neighbourMask |= GetTileNeighbourBit(reachablePosition.x - position.x, reachablePosition.y - position.y);
+				return neighbourMask;
+			}
+		}
+	} // namespace detail
+
+#pragma region Template Implementations
+
+	template <class TPosition>
+	ReachableTileList<TPosition>::ReachableTileList() :
+		tileCount(0u)
+	{
+	}
+
+	template <class TPosition>
+	ReachableTileList<TPosition>::ReachableTileList(TPosition position, TileNeighbourMask neighbourMask) :
+		tileCount(0u)
+	{
+		for (unsigned int i = 0u; i < MAX_TILE_COUNT; i++)
+		{
+			if (neighbourMask & (1u << i))
+				tileList[tileCount++] = TPosition(position.x + detail::TILE_NEIGHBOUR_OFFSET_X[i], position.y + detail::TILE_NEIGHBOUR_OFFSET_Y[i]);
+		}
+	}
+
+#pragma endregion
+
+} // namespace mbe
@@ -25,8 +25,19 @@ namespace mbe
 
 		inline const std::vector<size_t> & GetIndexList() const { return indexList; }
 
+		// Sets the tile index at a single position of the index list (row by row)
+		// Raises mbe::event::ComponentValueChangedEvent (value = Tile)
+		// Unlike changing the entire index list, this only requires the tile's chunk to be updated
+		void SetTile(size_t position, size_t tileIndex);
+
+		// The positions that have been changed using SetTile() since the last call to ClearChangedTileList()
+		inline const std::vector<size_t> & GetChangedTileList() const { return changedTileList; }
+
+		inline void ClearChangedTileList() { changedTileList.clear(); }
+
 	private:
 		std::vector<size_t> indexList;
+		std::vector<size_t> changedTileList;
 
 	};
 
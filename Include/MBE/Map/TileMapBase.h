@@ -5,17 +5,27 @@
 
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <cassert>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/NonCopyable.hpp>
 
 #include <MBE/Core/EventManager.h>
 #include <MBE/Map/TiledTerrain.h>
+#include <MBE/Map/ReachableTileList.h>
+#include <MBE/Map/TileMapChangedSubscription.h>
 #include <MBE/Core/Entity.h>
 
 namespace mbe
 {
 	/// @brief Base class for tile maps
-	/// @details
+	/// @details The pathfinders iterate over the reachable neighbours of a tile using a precomputed mask (see GetReachableTileMask()),
+	/// so their searches do not allocate. The masks are created from GetReachableTiles() when they are first used.
+	/// When the tiles change, the masks of the changed tiles must be updated. A tile map that is constructed with an event manager
+	/// does this whenever a mbe::event::TileMapChangedEvent is raised. Other changes must be passed to InvalidateTiles().
+	/// @n A derived tile map where tiles can be reached that are not neighbours (e.g. the exit of a teleporter or a ladder)
+	/// must declare static constexpr bool HAS_REACHABLE_TILE_MASK = false. The pathfinders then use GetReachableTiles() instead.
 	class TileMapBase : sf::NonCopyable
 	{
 	public:
@@ -23,8 +33,19 @@ namespace mbe
 		typedef sf::Vector2i Position;
 		typedef std::vector<mbe::Entity::ID> EntityIdList;
 
+		/// @brief Whether the pathfinders use GetReachableTileMask() (see mbe::detail::HasReachableTileMask)
+		static constexpr bool HAS_REACHABLE_TILE_MASK = true;
+
 	public:
+		/// @brief Default constructor
+		/// @details The reachable tile masks are only updated by InvalidateTiles().
 		TileMapBase() = default;
+
+		/// @brief Constructor
+		/// @details The reachable tile masks are updated whenever the event manager raises a mbe::event::TileMapChangedEvent.
+		/// @param eventManager The event manager that raises the mbe::event::TileMapChangedEvent. It must outlive the tile map.
+		explicit TileMapBase(EventManager& eventManager);
+
 		~TileMapBase() = default;
 
 	public:
@@ -32,7 +53,25 @@ namespace mbe
 		virtual mbe::TiledTerrain& GetTiledTerrain() const = 0;
 
 		virtual std::vector<Position> GetReachableTiles(int x, int y) const = 0;
-		inline std::vector<Position> GetReachableTiles(Position position) const { return std::move(GetReachableTiles(position.x, position.y)); };
+		inline std::vector<Position> GetReachableTiles(Position position) const { return GetReachableTiles(position.x, position.y); };
+
+		/// @brief Returns the neighbours that can be reached from a tile in a single move
+		/// @details The masks of all tiles are created from GetReachableTiles() when this is first called.
+		/// After that, this neither allocates nor calls GetReachableTiles().
+		/// @returns A bit for each reachable neighbour (see mbe::TileNeighbourMask)
+		inline TileNeighbourMask GetReachableTileMask(int x, int y) const
+		{
+			if (reachableTileMasksCreated.load(std::memory_order_acquire) == false)
+				CreateReachableTileMasks();
+
+			assert(x >= 0 && y >= 0 && static_cast<size_t>(y) * reachableTileMaskWidth + static_cast<size_t>(x) < reachableTileMaskList.size() && "TileMapBase: The tile lies outside the map");
+			return reachableTileMaskList[static_cast<size_t>(y) * reachableTileMaskWidth + static_cast<size_t>(x)];
+		}
+		inline TileNeighbourMask GetReachableTileMask(Position position) const { return GetReachableTileMask(position.x, position.y); }
+
+		/// @brief Returns the tiles that can be reached from a tile in a single move without allocating
+		/// @details This uses the precomputed masks (see GetReachableTileMask()).
+		inline ReachableTileList<Position> GetReachableTileList(Position position) const { return ReachableTileList<Position>(position, GetReachableTileMask(position.x, position.y)); }
 
 		virtual bool IsTileWalkable(int x, int y) const = 0;
 		inline bool IsTileWalkable(Position position) const { return IsTileWalkable(position.x, position.y); };
@@ -90,6 +129,32 @@ namespace mbe
 		/// @returns False if the coordinate is on the center of the tile, true otherwise
 		/// @see IsOffsetFromTile, GetOffsetFromTileCenter, GetOffsetFromTile
 		bool IsOffsetFromTileCenter(const sf::Vector2f& coordinate) const;
+
+		/// @brief Updates the reachable tile masks of the tiles in an area and of the tiles around it
+		/// @details This must be called when the walkability of the tiles in the area changes without a mbe::event::TileMapChangedEvent
+		/// being raised. The surrounding tiles are updated as well, since whether they can reach the area may have changed.
+		/// If the size of the map has changed, the masks of all tiles are created again when they are next used.
+		/// @n Like the tiles themselves, the masks must not be changed while a search is running on another thread.
+		/// @param position The top left tile of the changed area
+		/// @param size The number of tiles of the changed area in the x and y direction
+		void InvalidateTiles(Position position, sf::Vector2u size = { 1u, 1u });
+
+	private:
+		// Creates the masks of all tiles
+		// Several searches may use the tile map on different threads, so only the first one creates them
+		void CreateReachableTileMasks() const;
+
+		// Computes the masks of the tiles in an area and of the tiles around it
+		void ComputeReachableTileMasks(Position position, sf::Vector2u size) const;
+
+	private:
+		// The masks are created when they are first used
+		mutable std::vector<TileNeighbourMask> reachableTileMaskList;
+		mutable size_t reachableTileMaskWidth = 0u;
+		mutable std::atomic<bool> reachableTileMasksCreated{ false };
+		mutable std::mutex reachableTileMaskMutex;
+
+		detail::TileMapChangedSubscription tileMapChangedSubscription;
 	};
 
 } // namespace mbe
\ No newline at end of file
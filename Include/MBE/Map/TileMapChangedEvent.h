@@ -0,0 +1,53 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::event::TileMapChangedEvent
+
+#include <iostream>
+
+#include <SFML/System/Vector2.hpp>
+
+namespace mbe
+{
+	namespace event
+	{
+		/// @brief Raised when the movement speed or the walkability of tiles may have changed
+		/// @details The mbe::TileMapComponent raises this event when its position or shape changes.
+		/// Tile maps should raise it when the walkability of their tiles changes, so that cached paths can be invalidated.
+		class TileMapChangedEvent
+		{
+		public:
+			/// @brief Default constructor
+			/// @details The area is empty.
+			TileMapChangedEvent();
+
+			/// @brief Constructor
+			/// @param position The top left tile of the changed area
+			/// @param size The number of tiles of the changed area in the x and y direction
+			TileMapChangedEvent(sf::Vector2i position, sf::Vector2u size);
+
+			/// @brief Default destructor
+			~TileMapChangedEvent() = default;
+
+		public:
+			/// @brief Returns the top left tile of the changed area
+			inline sf::Vector2i GetPosition() const { return position; }
+
+			/// @brief Returns the number of tiles of the changed area in the x and y direction
+			inline sf::Vector2u GetSize() const { return size; }
+
+			inline void SetPosition(sf::Vector2i position) { this->position = position; }
+
+			inline void SetSize(sf::Vector2u size) { this->size = size; }
+
+			/// @brief Allows this class to be written to an out stream
+			/// @details This may be used to output the event's data to the console or a log file
+			friend std::ostream& operator << (std::ostream& stream, const TileMapChangedEvent& event);
+
+		private:
+			sf::Vector2i position;
+			sf::Vector2u size;
+		};
+
+	} // namespace event
+} // namespace mbe
@@ -0,0 +1,71 @@
+#pragma once
+
+/// @file
+/// @brief Class mbe::detail::TileMapChangedSubscription
+
+#include <functional>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <MBE/Core/EventManager.h>
+#include <MBE/Map/TileMapChangedEvent.h>
+
+namespace mbe
+{
+	namespace detail
+	{
+		/// @brief Passes the area of every mbe::event::TileMapChangedEvent to the InvalidateTiles() function of its owner
+		/// @details The pathfinders and caches that can be constructed with an event manager hold one of these as a member.
+		/// The subscription is removed when it is destroyed. Since it refers to its owner, neither of them can be copied.
+		class TileMapChangedSubscription : private sf::NonCopyable
+		{
+		public:
+			/// @brief Default constructor
+			/// @details Nothing is subscribed until Subscribe() is called.
+			TileMapChangedSubscription();
+
+			/// @brief Destructor
+			/// @details Removes the subscription.
+			~TileMapChangedSubscription();
+
+		public:
+			/// @brief Calls owner.InvalidateTiles() with the area of every mbe::event::TileMapChangedEvent the event manager raises
+			/// @details A previous subscription is removed.
+			/// @tparam TOwner The type of the owner. It must define a Position type and an InvalidateTiles(Position, sf::Vector2u) function.
+			/// @param eventManager The event manager that raises the event. It must outlive the subscription.
+			/// @param owner The object whose tiles are invalidated. It must outlive the subscription (e.g. by holding it as a member).
+			template <class TOwner>
+			void Subscribe(EventManager & eventManager, TOwner & owner);
+
+			/// @brief Removes the subscription if there is one
+			void UnSubscribe();
+
+			inline bool IsSubscribed() const { return eventManager != nullptr; }
+
+		private:
+			// Null if nothing is subscribed
+			EventManager * eventManager;
+			EventManager::SubscriptionID subscriptionId;
+		};
+
+#pragma region Template Implementations
+
+		template <class TOwner>
+		void TileMapChangedSubscription::Subscribe(EventManager & eventManager, TOwner & owner)
+		{
+			UnSubscribe();
+
+			std::function<void(const event::TileMapChangedEvent&)> onTileMapChangedFunction = [&owner](const event::TileMapChangedEvent& event)
+			{
+				owner.InvalidateTiles(typename TOwner::Position(event.GetPosition().x, event.GetPosition().y), event.GetSize());
+			};
+
+			subscriptionId = eventManager.Subscribe(onTileMapChangedFunction);
+			this->eventManager = &eventManager;
+		}
+
+#pragma endregion
+
+	} // namespace detail
+} // namespace mbe
@@ -15,6 +15,9 @@
 namespace mbe
 {
 
+	/// @brief The movement speed of the tiles covered by an entity
+	/// @details Changing the position or the shape raises a mbe::event::TileMapChangedEvent for the tiles covered before and after the change.
+	/// It is raised once the change has been made, so that the subscribers see the new tiles. If both areas overlap, a single event covers them.
 	class TileMapComponent : public Component
 	{
 	public:
@@ -43,10 +46,10 @@ namespace mbe
 
 		sf::Vector2u GetSize() const;
 
-		inline void SetPosition(const Position& position) { this->position = position; }
+		void SetPosition(const Position& position);
 
-		inline void SetMovementSpeedShape(const MovementSpeedShape& movementSpeedShape) { this->movementSpeedShape = movementSpeedShape; }
-		inline void SetMovementSpeedShape(MovementSpeedShape&& movementSpeedShape) { this->movementSpeedShape = std::move(movementSpeedShape); }
+		inline void SetMovementSpeedShape(const MovementSpeedShape& movementSpeedShape) { SetMovementSpeedShape(MovementSpeedShape(movementSpeedShape)); }
+		void SetMovementSpeedShape(MovementSpeedShape&& movementSpeedShape);
 
 		// Throw if not in range
 		void SetMovementSpeed(unsigned int x, unsigned int y, float speed);
@@ -54,6 +57,10 @@ namespace mbe
 		// Makes the rows columns and vice versa
 		void Rotate();
 
+	private:
+		// Raises a mbe::event::TileMapChangedEvent for the tiles that were covered before a change and for the tiles that are covered now
+		void RaiseTileMapChangedEvent(const Position& previousPosition, sf::Vector2u previousSize) const;
+
 	private:
 		Position position;
 		MovementSpeedShape movementSpeedShape;
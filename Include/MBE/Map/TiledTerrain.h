@@ -8,6 +8,7 @@
 
 #include <MBE/Core/EventManager.h>
 #include <MBE/Core/EntityManager.h>
+#include <MBE/Core/ThreadPool.h>
 
 #include <MBE/TransformComponent.h>
 #include <MBE/Graphics/TextureWrapperComponent.h>
@@ -54,8 +55,10 @@ namespace mbe
 #pragma endregion
 
 	public:
-		TiledTerrain(EventManager& eventManager, EntityManager& entityManager, sf::Vector2u size, sf::Vector2u tileSize);
-		TiledTerrain(EventManager& eventManager, EntityManager& entityManager, Data::Ptr mapData, const std::string& tileMapTextureWrapperId);
+		// If a thread pool is passed, the vertices of the layers are generated on its threads
+		// The thread pool must outlive the tiled terrain
+		TiledTerrain(EventManager& eventManager, EntityManager& entityManager, sf::Vector2u size, sf::Vector2u tileSize, ThreadPool* threadPool = nullptr);
+		TiledTerrain(EventManager& eventManager, EntityManager& entityManager, Data::Ptr mapData, const std::string& tileMapTextureWrapperId, ThreadPool* threadPool = nullptr);
 
 		// Unsubscribe from event
 		~TiledTerrain();
@@ -65,6 +68,9 @@ namespace mbe
 		inline const sf::Vector2u& GetSize() const { return size; }
 		inline const sf::Vector2u& GetTileSize() const { return tileSize; }
 
+		// Pass nullptr to generate the vertices of the layers on the calling thread
+		inline void SetThreadPool(ThreadPool* threadPool) { this->threadPool = threadPool; }
+
 		// The zOrder Of the layer is automatically set to last
 		Entity::ID AddTileMapLayer(const std::string& textureWrapperId);
 		Entity::ID GetLayer(const size_t layerIndex);
@@ -78,6 +84,8 @@ namespace mbe
 		void SubscribeEvents();
 		void OnTextureWrapperChangedEvent(TextureWrapperComponent& textureWraapperComponent);
 		void OnIndexListChangedEvent(TileComponent& tileComponent);
+		// Only updates the changed tiles
+		void OnTileChangedEvent(TileComponent& tileComponent);
 
 	private:
 		const sf::Vector2u size;
@@ -89,6 +97,7 @@ namespace mbe
 		EntityManager& entityManager;
 		EventManager& eventManager;
 		EventManager::SubscriptionID componentChangedSubscription;
+		ThreadPool* threadPool;
 	};
 
 } // namespace mbe
@@ -15,6 +15,10 @@ namespace mbe
 	/// @details It is esentially a wrapper around the sf::Transformable class. The underlying transformable can be retrieved using
 	/// the GetTransformable() methdod.
 	/// @n The transform is relative to the parent entity. To get the actual position and transform, use the GetWorldPosition() and GetWorldTransform() methods.
+	/// @n The world transform and its inverse are cached. Changing the transform marks the cached values of this component and of all its
+	/// child entities as dirty. Dirty values are recalculated on access or by the mbe::TransformSystem, which updates them once per frame.
+	/// When a world transform becomes dirty, a mbe::event::ComponentValueChangedEvent (value = WorldTransform) is raised.
+	/// This happens at most once between two recalculations, so systems can keep track of the moved entities.
 	class TransformComponent : public Component
 	{
 	public:
@@ -33,7 +37,7 @@ namespace mbe
 		/// The default position of a transformable object is { 0.f, 0.f }.
 		/// @param position The new position
 		/// @see Move, GetPosition
-		inline void SetPosition(const sf::Vector2f & position) { transformable.setPosition(position); }
+		inline void SetPosition(const sf::Vector2f & position) { transformable.setPosition(position); MarkWorldTransformDirty(); }
 
 		/// @brief Set the (relative) rotation
 		/// @details This function completely overwrites the previous rotation.
@@ -41,7 +45,7 @@ namespace mbe
 		/// The default rotation of a transformable object is 0.
 		/// @param angle The new angle of rotation in degrees
 		/// @see Rotate, GetRotation
-		inline void SetRotation(float angle) { transformable.setRotation(angle); }
+		inline void SetRotation(float angle) { transformable.setRotation(angle); MarkWorldTransformDirty(); }
 
 		/// @brief Set the (relative) scale factors
 		/// @details This function completely overwrites the previous scale value.
@@ -49,7 +53,7 @@ namespace mbe
 		/// The default scale of a transformable object is { 1.f, 1.f }.
 		/// @param factors New scale factors
 		/// @see Scale, GetScale
-		inline void SetScale(const sf::Vector2f & factors) { transformable.setScale(factors); }
+		inline void SetScale(const sf::Vector2f & factors) { transformable.setScale(factors); MarkWorldTransformDirty(); }
 
 		/// @brief set the local origin of the object
 		/// @details The origin of an object defines the center point for
@@ -58,7 +62,7 @@ namespace mbe
 		/// transformations (position, scale, rotation). The default origin of a transformable object is { 0.f , 0.f }.
 		/// @param origin New origin
 		/// @see GetOrigin
-		inline void SetOrigin(const sf::Vector2f origin) { transformable.setOrigin(origin); }
+		inline void SetOrigin(const sf::Vector2f origin) { transformable.setOrigin(origin); MarkWorldTransformDirty(); }
 
 		/// @brief Get the (relative) position
 		/// @returns Current position
@@ -91,7 +95,7 @@ namespace mbe
 		///
 		/// @param offset The vector by which the entity is moved
 		/// @see SetPosition, GetPosition
-		inline void Move(const sf::Vector2f & offset) { transformable.move(offset); }
+		inline void Move(const sf::Vector2f & offset) { transformable.move(offset); MarkWorldTransformDirty(); }
 
 		/// @brief Rotate the entity's transform component
 		/// @details This function adds to the current rotation of the object unlike setRotation which overwrites it.
@@ -103,7 +107,7 @@ namespace mbe
 		///
 		/// @param angle Angle of rotation, in degrees
 		/// @see SetRotation, GetRotation
-		inline void Rotate(float angle) { transformable.rotate(angle); }
+		inline void Rotate(float angle) { transformable.rotate(angle); MarkWorldTransformDirty(); }
 
 		/// @brief Scale the entity's transform component
 		/// @details This function multiplies the current scale of the object unlike setScale which overwrites it.
@@ -116,7 +120,7 @@ namespace mbe
 		///
 		/// @param factor Scale factors
 		/// @see SetScale, GetScale
-		inline void Scale(const sf::Vector2f & factor) { transformable.scale(factor); }
+		inline void Scale(const sf::Vector2f & factor) { transformable.scale(factor); MarkWorldTransformDirty(); }
 
 		/// @brief Get the underlying sf::Transformable
 		/// @returns A reference to the underlying sf::Transformable
@@ -143,13 +147,37 @@ namespace mbe
 		/// @brief Get the actual transform
 		/// @details To get the local transform, use GetLocalTransform().
 		/// Accumulates all the relative transforms until reaching the root i.e. an entity whose parent transform entiy is null.
+		/// The result is cached until this transform or the transform of a parent entity changes.
 		/// @returns The absolute transform of this entity
 		/// @see GetLocalTransform, GetInverseTransform, GetTransformaable
-		// no const & since the value is calculates within the function
-		sf::Transform GetWorldTransform() const;
+		const sf::Transform & GetWorldTransform() const;
+
+		/// @brief Get the inverse of the actual transform
+		/// @details The result is cached until this transform or the transform of a parent entity changes.
+		/// @returns The inverse of the absolute transform of this entity
+		/// @see GetWorldTransform
+		const sf::Transform & GetInverseWorldTransform() const;
+
+		/// @brief Returns true if the cached world transform must be recalculated
+		inline bool IsWorldTransformDirty() const { return worldTransformDirty; }
+
+	protected:
+		// The world transform depends on the parent entity's transform
+		void OnParentEntityChanged() override;
+
+	private:
+		// Marks the world transform of this and all child entities as dirty
+		// If this transform is already dirty, the child transforms must be dirty as well (a transform can only be recalculated after its parent)
+		void MarkWorldTransformDirty();
+		void MarkChildrenWorldTransformDirty();
 
 	private:
 		sf::Transformable transformable;
+
+		mutable sf::Transform worldTransform;
+		mutable sf::Transform inverseWorldTransform;
+		mutable bool worldTransformDirty;
+		mutable bool inverseWorldTransformDirty;
 	};
 
 } // namespace mbe
\ No newline at end of file
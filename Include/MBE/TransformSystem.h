@@ -0,0 +1,42 @@
+#pragma once
+
+/// @file
+/// @brief class mbe::TransformSystem
+
+#include <vector>
+
+#include <MBE/Core/Entity.h>
+#include <MBE/Core/EntityManager.h>
+
+#include <MBE/TransformComponent.h>
+
+namespace mbe
+{
+
+	/// @brief Recalculates the dirty world transforms of all entities with a mbe::TransformComponent
+	/// @details The entity hierarchy is traversed from the root entities down to their children, so that every world transform
+	/// is calculated from the already updated world transform of its parent. Transforms that have not changed are not recalculated.
+	/// @n Update() should be called once per frame after the game logic has moved the entities and before the entities are drawn.
+	/// Afterwards, mbe::TransformComponent::GetWorldTransform() only returns cached values.
+	class TransformSystem
+	{
+	public:
+		/// @brief Constructor
+		/// @param entityManager A reference to the mbe::EntityManager holding the entities with a mbe::TransformComponent
+		TransformSystem(const EntityManager & entityManager);
+
+		/// @brief Default destructor
+		~TransformSystem() = default;
+
+	public:
+		/// @brief Updates the world transforms of all dirty transform components in topological order
+		void Update();
+
+	private:
+		const EntityManager & entityManager;
+
+		// The entities that still have to be visited (reused between updates)
+		std::vector<const Entity*> entityStack;
+	};
+
+} // namespace mbe
@@ -6,4 +6,8 @@ Component::Component(EventManager& eventManager, Entity& parentEntity) :
 	eventManager(eventManager),
 	parentEntity(parentEntity)
 {
-}
\ No newline at end of file
+}
+
+void Component::OnParentEntityChanged()
+{
+}
@@ -59,12 +59,15 @@ void Entity::AttachChild(const ID& childEntityId)
 
 	// Add the child entity to the list of child entities
 	childEntityIdList.emplace_back(std::move(childEntityId));
+
+	childEntityId->OnParentEntityChanged();
 }
 
 void Entity::DetatchChild(const ID& childEntityId)
 {
 	// Set the child entity's parent to null
 	childEntityId->parentEntityId = Entity::GetNullID();
+	childEntityId->OnParentEntityChanged();
 
 	// Remove the child entity from this entity's child entity list
 	childEntityIdList.erase(std::remove(childEntityIdList.begin(), childEntityIdList.end(), childEntityId), childEntityIdList.end());
@@ -125,6 +128,12 @@ std::vector<detail::ComponentTypeID> Entity::GetComponentTypeIDList() const
 	return componentTypeIdList;
 }
 
+void Entity::OnParentEntityChanged()
+{
+	for (const auto& pair : actualComponentDictionary)
+		pair.second->OnParentEntityChanged();
+}
+
 //void Entity::RemovePolymorphism(detail::ComponentTypeID typeId)
 //{
 //	RemoveDerivedComponents(typeId);
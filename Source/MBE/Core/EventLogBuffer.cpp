@@ -0,0 +1,188 @@
+#include <MBE/Core/EventLogBuffer.h>
+
+#include <cstring>
+#include <ctime>
+#include <cassert>
+#include <sstream>
+
+using namespace mbe;
+
+namespace
+{
+	template <typename T>
+	void WriteBinaryValue(std::ostream& stream, T value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+} // namespace
+
+EventLogBuffer::EventLogBuffer(std::ostream& textStream, std::ostream& binaryStream, size_t capacity, OverflowPolicy overflowPolicy) :
+	textStream(textStream),
+	binaryStream(binaryStream),
+	binaryHeaderWritten(false),
+	overflowPolicy(overflowPolicy),
+	droppedCount(0),
+	unreportedDroppedCount(0),
+	running(true)
+{
+	assert(capacity > 0 && "EventLogBuffer: The capacity must be greater than 0");
+
+	pendingRing.recordList.resize(capacity);
+	writeRing.recordList.resize(capacity);
+
+	writerThread = std::thread(&EventLogBuffer::Run, this);
+}
+
+EventLogBuffer::~EventLogBuffer()
+{
+	{
+		std::lock_guard lock(mutex);
+		running = false;
+	}
+	recordsAvailable.notify_one();
+	writerThread.join();
+}
+
+size_t EventLogBuffer::GetDroppedCount() const
+{
+	std::lock_guard lock(mutex);
+	return droppedCount;
+}
+
+void EventLogBuffer::SetOverflowPolicy(OverflowPolicy overflowPolicy)
+{
+	std::lock_guard lock(mutex);
+	this->overflowPolicy = overflowPolicy;
+}
+
+detail::EventLogRecord* EventLogBuffer::AcquireRecord(std::unique_lock<std::mutex>& lock, bool binary)
+{
+	if (pendingRing.IsFull())
+	{
+		// Binary records are never dropped
+		const OverflowPolicy policy = binary ? OverflowPolicy::Block : overflowPolicy;
+
+		if (policy == OverflowPolicy::Block)
+		{
+			spaceAvailable.wait(lock, [this]() { return pendingRing.IsFull() == false; });
+		}
+		else if (policy == OverflowPolicy::DropOldest && pendingRing.Front().binary == false)
+		{
+			auto& oldestRecord = pendingRing.Front();
+			oldestRecord.destroy(oldestRecord.eventPtr);
+			pendingRing.head = (pendingRing.head + 1) % pendingRing.recordList.size();
+			pendingRing.count--;
+			droppedCount++;
+			unreportedDroppedCount++;
+		}
+		else
+		{
+			// Drop newest (or drop oldest when the oldest record is binary and must be kept)
+			droppedCount++;
+			unreportedDroppedCount++;
+			return nullptr;
+		}
+	}
+
+	pendingRing.count++;
+	return &pendingRing.Back();
+}
+
+void EventLogBuffer::Run()
+{
+	while (true)
+	{
+		size_t droppedSinceLastWrite;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			recordsAvailable.wait(lock, [this]() { return pendingRing.count > 0 || running == false; });
+
+			if (pendingRing.count == 0 && running == false)
+				break;
+
+			// Take all pending records at once so that the lock is only held for the swap
+			std::swap(pendingRing, writeRing);
+			droppedSinceLastWrite = unreportedDroppedCount;
+			unreportedDroppedCount = 0;
+		}
+		spaceAvailable.notify_all();
+
+		if (droppedSinceLastWrite > 0)
+			textStream << "[" << droppedSinceLastWrite << " events have been dropped]\n";
+
+		for (; writeRing.count > 0; writeRing.count--)
+		{
+			auto& record = writeRing.Front();
+			WriteRecord(record);
+			record.destroy(record.eventPtr);
+			writeRing.head = (writeRing.head + 1) % writeRing.recordList.size();
+		}
+		writeRing.head = 0;
+
+		// Only flush once the buffer has been drained
+		bool drained;
+		{
+			std::lock_guard lock(mutex);
+			drained = pendingRing.count == 0;
+		}
+		if (drained)
+		{
+			textStream.flush();
+			if (binaryHeaderWritten)
+				binaryStream.flush();
+		}
+	}
+
+	textStream.flush();
+	if (binaryHeaderWritten)
+		binaryStream.flush();
+}
+
+void EventLogBuffer::WriteRecord(detail::EventLogRecord& record)
+{
+	if (record.binary == false)
+	{
+		// Get a string of the record time
+		time_t recordTime = std::chrono::system_clock::to_time_t(record.time);
+		char timeString[detail::MIN_TIME_BUFFER_SIZE];
+		ctime_s(timeString, sizeof(timeString), &recordTime);
+
+		// Remove the new line
+		timeString[std::strlen(timeString) - 1] = '\0';
+
+		textStream << '[' << timeString << "] ";
+		record.write(record.eventPtr, textStream);
+		textStream << '\n';
+		return;
+	}
+
+	if (binaryHeaderWritten == false)
+	{
+		binaryStream.write(detail::BINARY_EVENT_LOG_MAGIC, sizeof(detail::BINARY_EVENT_LOG_MAGIC));
+		WriteBinaryValue<unsigned int>(binaryStream, detail::BINARY_EVENT_LOG_VERSION);
+		binaryHeaderWritten = true;
+	}
+
+	// Declare the event type the first time it is written
+	if (declaredTypeIdSet.insert(record.typeId).second)
+	{
+		const auto nameLength = static_cast<unsigned int>(std::strlen(record.eventName));
+		WriteBinaryValue(binaryStream, detail::BinaryEventLogRecordType::TypeDeclaration);
+		WriteBinaryValue<unsigned int>(binaryStream, static_cast<unsigned int>(record.typeId));
+		WriteBinaryValue<unsigned int>(binaryStream, nameLength);
+		binaryStream.write(record.eventName, nameLength);
+	}
+
+	// The payload is written to a buffer first since its size is not known in advance
+	static thread_local std::ostringstream payloadStream(std::ios::binary);
+	payloadStream.str(std::string());
+	record.write(record.eventPtr, payloadStream);
+	const std::string payload = payloadStream.str();
+
+	const long long time = std::chrono::duration_cast<std::chrono::nanoseconds>(record.time.time_since_epoch()).count();
+	WriteBinaryValue(binaryStream, detail::BinaryEventLogRecordType::Event);
+	WriteBinaryValue<unsigned int>(binaryStream, static_cast<unsigned int>(record.typeId));
+	WriteBinaryValue<long long>(binaryStream, time);
+	WriteBinaryValue<unsigned int>(binaryStream, static_cast<unsigned int>(payload.size()));
+	binaryStream.write(payload.data(), payload.size());
+}
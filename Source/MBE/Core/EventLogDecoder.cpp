@@ -0,0 +1,96 @@
+#include <MBE/Core/EventLogDecoder.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <stdexcept>
+
+using namespace mbe;
+
+namespace
+{
+	template <typename T>
+	T ReadBinaryValue(std::istream& stream)
+	{
+		T value;
+		if (!stream.read(reinterpret_cast<char*>(&value), sizeof(T)))
+			throw std::runtime_error("EventLogDecoder: Unexpected end of the binary event log");
+		return value;
+	}
+} // namespace
+
+void EventLogDecoder::Decode(std::istream& input, std::ostream& output) const
+{
+	// Check the header
+	char magic[sizeof(detail::BINARY_EVENT_LOG_MAGIC)];
+	if (!input.read(magic, sizeof(magic)) || std::memcmp(magic, detail::BINARY_EVENT_LOG_MAGIC, sizeof(magic)) != 0)
+		throw std::runtime_error("EventLogDecoder: The input is not a binary event log");
+
+	const auto version = ReadBinaryValue<unsigned int>(input);
+	if (version != detail::BINARY_EVENT_LOG_VERSION)
+		throw std::runtime_error("EventLogDecoder: Unsupported binary event log version: " + std::to_string(version));
+
+	// Maps the type ids used in the log to the declared type names
+	std::unordered_map<unsigned int, std::string> typeNameDictionary;
+	std::vector<char> payload;
+
+	while (input.peek() != std::char_traits<char>::eof())
+	{
+		const auto recordType = ReadBinaryValue<detail::BinaryEventLogRecordType>(input);
+		const auto typeId = ReadBinaryValue<unsigned int>(input);
+
+		if (recordType == detail::BinaryEventLogRecordType::TypeDeclaration)
+		{
+			const auto nameLength = ReadBinaryValue<unsigned int>(input);
+			std::string typeName(nameLength, '\0');
+			if (!input.read(&typeName[0], nameLength))
+				throw std::runtime_error("EventLogDecoder: Unexpected end of the binary event log");
+			typeNameDictionary[typeId] = std::move(typeName);
+			continue;
+		}
+		if (recordType != detail::BinaryEventLogRecordType::Event)
+			throw std::runtime_error("EventLogDecoder: Invalid record type in the binary event log");
+
+		const auto time = ReadBinaryValue<long long>(input);
+		const auto payloadSize = ReadBinaryValue<unsigned int>(input);
+		payload.resize(payloadSize);
+		if (payloadSize > 0 && !input.read(payload.data(), payloadSize))
+			throw std::runtime_error("EventLogDecoder: Unexpected end of the binary event log");
+
+		const auto typeNameIterator = typeNameDictionary.find(typeId);
+		if (typeNameIterator == typeNameDictionary.cend())
+			throw std::runtime_error("EventLogDecoder: Event of undeclared type id: " + std::to_string(typeId));
+
+		// Get a string of the record time
+		const std::chrono::system_clock::time_point timePoint(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time)));
+		time_t recordTime = std::chrono::system_clock::to_time_t(timePoint);
+		char timeString[detail::MIN_TIME_BUFFER_SIZE];
+		ctime_s(timeString, sizeof(timeString), &recordTime);
+		timeString[std::strlen(timeString) - 1] = '\0';
+
+		output << '[' << timeString << "] ";
+
+		const auto decodeFunctionIterator = decodeFunctionDictionary.find(typeNameIterator->second);
+		if (decodeFunctionIterator == decodeFunctionDictionary.cend())
+		{
+			output << "Unregistered event: " << typeNameIterator->second << '\n';
+			continue;
+		}
+
+		std::istringstream payloadStream(std::string(payload.data(), payload.size()), std::ios::binary);
+		decodeFunctionIterator->second(payloadStream, output);
+		output << '\n';
+	}
+}
+
+void EventLogDecoder::Decode(const std::string& filePath, std::ostream& output) const
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (file.is_open() == false)
+		throw std::runtime_error("EventLogDecoder: Failed to open file: " + filePath);
+
+	Decode(file, output);
+}
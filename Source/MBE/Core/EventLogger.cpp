@@ -2,16 +2,27 @@
 
 using namespace mbe;
 
-EventLogger::EventLogger(EventManager & eventManager, std::string filePath) :
+EventLogger::EventLogger(EventManager & eventManager, std::string filePath, std::string binaryFilePath, size_t bufferCapacity, OverflowPolicy overflowPolicy) :
 	eventManager(eventManager),
-	logFile(filePath)
+	logFile(filePath),
+	binaryFilePath(std::move(binaryFilePath)),
+	eventLogBuffer(logFile, binaryLogFile, bufferCapacity, overflowPolicy)
 {
 }
 
 EventLogger::~EventLogger() {
-	logFile.close();
+	// The event log buffer is destroyed before the log files are closed
+	// This makes sure that all buffered events are written
 	for (const auto subscription : subscriptions)
 	{
 		eventManager.UnSubscribe(subscription);
 	}
-}
\ No newline at end of file
+}
+
+void EventLogger::OpenBinaryLogFile()
+{
+	// The binary log file is opened the first time an event is subscribed to it
+	// No binary events can have been pushed before, so the writer thread does not access the file yet
+	if (binaryLogFile.is_open() == false)
+		binaryLogFile.open(binaryFilePath, std::ios::binary | std::ios::trunc);
+}
@@ -1,17 +1,129 @@
 #include <MBE/Core/EventManager.h>
 
+#ifdef MBE_EVENT_STATISTICS
+#include <fstream>
+#include <iomanip>
+#endif // MBE_EVENT_STATISTICS
+
 using namespace mbe;
 
+#ifdef MBE_EVENT_STATISTICS
+EventManager::~EventManager()
+{
+	if (eventStatisticsReportFilePath.empty())
+		return;
+
+	std::ofstream reportFile(eventStatisticsReportFilePath);
+	if (reportFile.is_open())
+		WriteEventStatisticsReport(reportFile);
+}
+#endif // MBE_EVENT_STATISTICS
+
 void EventManager::UnSubscribe(SubscriptionID subscriptionId)
 {
 	// There is no way to get the type id of the event for which the function has been subscibed to
 	// Therefore, the entire callback dictionary must be searched
 
-	for (auto& callbackDictionary : callbackDictionaryDictionary)
+	bool subscriptionFound = false;
+	for (detail::BaseEvent::TypeID typeId = 0; typeId < callbackDictionaryDictionary.size(); typeId++)
 	{
 		// Erase by key
-		callbackDictionary.erase(subscriptionId);
-		// Delete the wrapper (this will not be necessary when using unique pointers)
+		if (callbackDictionaryDictionary[typeId].erase(subscriptionId) == 0)
+			continue;
+
+		subscriptionFound = true;
+
+#ifdef MBE_EVENT_STATISTICS
+		eventStatisticsList[typeId].subscriberCount = callbackDictionaryDictionary[typeId].size();
+#endif // MBE_EVENT_STATISTICS
+	}
+
+	// Delete the wrapper (this will not be necessary when using unique pointers)
+	// The wrapper must only be deleted once, even though every callback dictionary is searched
+	if (subscriptionFound)
 		delete subscriptionId.GetObjectPtr();
+}
+
+#ifdef MBE_EVENT_STATISTICS
+void EventManager::ResetEventStatistics()
+{
+	for (auto& eventStatistics : eventStatisticsList)
+	{
+		eventStatistics.raiseCount = 0;
+		eventStatistics.totalDispatchTime = std::chrono::nanoseconds::zero();
+		eventStatistics.maxDispatchTime = std::chrono::nanoseconds::zero();
+		eventStatistics.subscriberStatisticsDictionary.clear();
 	}
 }
+
+void EventManager::WriteEventStatisticsReport(std::ostream& stream, size_t subscriberCount) const
+{
+	// Only report event types that have been used
+	std::vector<const EventStatistics*> sortedStatisticsList;
+	for (const auto& eventStatistics : eventStatisticsList)
+	{
+		if (eventStatistics.eventName.empty() == false)
+			sortedStatisticsList.push_back(&eventStatistics);
+	}
+
+	// Sort by total dispatch time (the hottest events come first)
+	std::sort(sortedStatisticsList.begin(), sortedStatisticsList.end(), [](const EventStatistics* a, const EventStatistics* b)
+	{
+		return a->totalDispatchTime > b->totalDispatchTime;
+	});
+
+	const auto toMicroseconds = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::micro>(time).count(); };
+
+	stream << "Event statistics (times in microseconds)" << std::endl;
+	for (const auto* eventStatistics : sortedStatisticsList)
+	{
+		const double averageTime = eventStatistics->raiseCount == 0 ? 0.0 : toMicroseconds(eventStatistics->totalDispatchTime) / eventStatistics->raiseCount;
+
+		stream << eventStatistics->eventName << std::endl;
+		stream << std::fixed << std::setprecision(3)
+			<< "\traised: " << eventStatistics->raiseCount
+			<< "\tsubscribers: " << eventStatistics->subscriberCount
+			<< "\ttotal: " << toMicroseconds(eventStatistics->totalDispatchTime)
+			<< "\taverage: " << averageTime
+			<< "\tmax: " << toMicroseconds(eventStatistics->maxDispatchTime) << std::endl;
+
+		for (const auto& subscriberStatistics : eventStatistics->GetSlowestSubscribers(subscriberCount))
+		{
+			stream << "\t\tsubscription " << subscriberStatistics.subscriptionId
+				<< "\tcalls: " << subscriberStatistics.callCount
+				<< "\ttotal: " << toMicroseconds(subscriberStatistics.totalTime)
+				<< "\tmax: " << toMicroseconds(subscriberStatistics.maxTime) << std::endl;
+		}
+	}
+}
+
+EventManager::EventStatistics& EventManager::GetEventStatistics(detail::BaseEvent::TypeID typeId, const char* eventName)
+{
+	if (typeId >= eventStatisticsList.size())
+		eventStatisticsList.resize(typeId + 1);
+
+	auto& eventStatistics = eventStatisticsList[typeId];
+	if (eventStatistics.eventName.empty())
+		eventStatistics.eventName = eventName;
+
+	return eventStatistics;
+}
+
+std::vector<EventManager::SubscriberStatistics> EventManager::EventStatistics::GetSlowestSubscribers(size_t count) const
+{
+	std::vector<SubscriberStatistics> subscriberStatisticsList;
+	subscriberStatisticsList.reserve(subscriberStatisticsDictionary.size());
+	for (const auto& pair : subscriberStatisticsDictionary)
+		subscriberStatisticsList.push_back(pair.second);
+
+	count = std::min(count, subscriberStatisticsList.size());
+	std::partial_sort(subscriberStatisticsList.begin(), subscriberStatisticsList.begin() + count, subscriberStatisticsList.end(),
+		[](const SubscriberStatistics& a, const SubscriberStatistics& b)
+	{
+		return a.totalTime > b.totalTime;
+	});
+	subscriberStatisticsList.resize(count);
+
+	return subscriberStatisticsList;
+}
+#endif // MBE_EVENT_STATISTICS
@@ -0,0 +1,63 @@
+#include <MBE/Core/PathSearchSpace.h>
+
+#include <algorithm>
+
+using namespace mbe::detail;
+
+PathSearchSpace::PathSearchSpace(size_t nodeCount) :
+	generation(0u)
+{
+	SetNodeCount(nodeCount);
+}
+
+void PathSearchSpace::SetNodeCount(size_t nodeCount)
+{
+	gList.resize(nodeCount);
+	parentList.resize(nodeCount);
+	closedList.resize(nodeCount);
+	generationList.assign(nodeCount, 0u);
+	generation = 0u;
+	openList.SetCapacity(nodeCount);
+}
+
+void PathSearchSpace::Reset()
+{
+	openList.Clear();
+
+	// When the generation wraps around, nodes of the generation that is now reused would appear to be visited
+	if (++generation == 0u)
+	{
+		std::fill(generationList.begin(), generationList.end(), 0u);
+		generation = 1u;
+	}
+}
+
+bool PathSearchSpace::Relax(size_t nodeIndex, float g, float h, size_t parentIndex, float tieBreak)
+{
+	const bool visited = IsVisited(nodeIndex);
+	if (visited && (closedList[nodeIndex] != 0 || g >= gList[nodeIndex]))
+		return false;
+
+	gList[nodeIndex] = g;
+	parentList[nodeIndex] = parentIndex;
+
+	if (visited)
+	{
+		openList.Update(nodeIndex, { g + h, g, tieBreak });
+	}
+	else
+	{
+		generationList[nodeIndex] = generation;
+		closedList[nodeIndex] = 0;
+		openList.Push(nodeIndex, { g + h, g, tieBreak });
+	}
+
+	return true;
+}
+
+size_t PathSearchSpace::PopOpenNode()
+{
+	const size_t nodeIndex = openList.Pop();
+	closedList[nodeIndex] = 1;
+	return nodeIndex;
+}
@@ -8,6 +8,12 @@ PixelMask::PixelMask(const sf::Texture & texture) :
 	this->CreateMaskFromTexture(texture);
 }
 
+PixelMask::PixelMask(const sf::Image & image) :
+	pixelMaskSize(image.getSize())
+{
+	this->CreateMaskFromImage(image);
+}
+
 PixelMask::PixelMask(const sf::Sprite & sprite) :
 	pixelMaskSize(sprite.getTexture()->getSize())
 {
@@ -61,8 +67,11 @@ bool PixelMask::Contains(sf::Vector2f point, const sf::IntRect & subRect) const
 void PixelMask::CreateMaskFromTexture(const sf::Texture & texture)
 {
 	// Create an Image from the given texture
-	sf::Image image(texture.copyToImage());
+	CreateMaskFromImage(texture.copyToImage());
+}
 
+void PixelMask::CreateMaskFromImage(const sf::Image & image)
+{
 	// measure the time this function takes
 	//sf::Clock clock;
 	//sf::Time time = sf::Time::Zero;
@@ -0,0 +1,77 @@
+#include <MBE/Core/ReservationTable.h>
+
+#include <algorithm>
+#include <functional>
+
+using namespace mbe;
+
+size_t ReservationTable::KeyHash::operator()(const Key & key) const
+{
+	// Combine the hashes like boost::hash_combine
+	size_t hash = std::hash<size_t>()(key.tileIndex);
+	hash ^= std::hash<Time>()(key.time) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+bool ReservationTable::Reserve(size_t tileIndex, Time time, AgentID agentId)
+{
+	const Key key{ tileIndex, time };
+	const auto result = reservationDictionary.emplace(key, agentId);
+	if (result.second == false)
+		return result.first->second == agentId;
+
+	if (agentId >= agentReservationList.size())
+		agentReservationList.resize(agentId + 1);
+	agentReservationList[agentId].push_back(key);
+	return true;
+}
+
+ReservationTable::AgentID ReservationTable::GetAgent(size_t tileIndex, Time time) const
+{
+	const auto it = reservationDictionary.find(Key{ tileIndex, time });
+	return it == reservationDictionary.cend() ? NO_AGENT : it->second;
+}
+
+bool ReservationTable::IsMoveBlocked(size_t fromTileIndex, size_t toTileIndex, Time time, AgentID agentId) const
+{
+	if (IsReserved(toTileIndex, time + 1, agentId))
+		return true;
+
+	if (fromTileIndex == toTileIndex)
+		return false;
+
+	// Two agents can not swap their tiles
+	const auto otherAgentId = GetAgent(toTileIndex, time);
+	return otherAgentId != NO_AGENT && otherAgentId != agentId && GetAgent(fromTileIndex, time + 1) == otherAgentId;
+}
+
+void ReservationTable::Release(AgentID agentId)
+{
+	if (agentId >= agentReservationList.size())
+		return;
+
+	for (const auto& key : agentReservationList[agentId])
+		reservationDictionary.erase(key);
+	agentReservationList[agentId].clear();
+}
+
+void ReservationTable::ReleaseBefore(Time time)
+{
+	for (auto& reservationList : agentReservationList)
+	{
+		reservationList.erase(std::remove_if(reservationList.begin(), reservationList.end(), [this, time](const Key & key)
+			{
+				if (key.time >= time)
+					return false;
+
+				reservationDictionary.erase(key);
+				return true;
+			}), reservationList.end());
+	}
+}
+
+void ReservationTable::Clear()
+{
+	reservationDictionary.clear();
+	agentReservationList.clear();
+}
@@ -0,0 +1,44 @@
+#include <MBE/Core/ThreadPool.h>
+
+#include <algorithm>
+
+using namespace mbe;
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+	// std::thread::hardware_concurrency() may return 0 if the value can not be determined
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (size_t i = 0; i < threadCount; i++)
+		threadList.emplace_back(&ThreadPool::Run, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	taskQueue.ShutDown();
+
+	for (auto& thread : threadList)
+		thread.join();
+}
+
+std::future<void> ThreadPool::Enqueue(Task task)
+{
+	auto packagedTask = std::make_shared<std::packaged_task<void()>>(std::move(task));
+	auto future = packagedTask->get_future();
+	taskQueue.Push(std::move(packagedTask));
+	return future;
+}
+
+void ThreadPool::Run()
+{
+	while (true)
+	{
+		// Blocks until there is a task or the queue has been shut down (in which case a null pointer is returned)
+		auto packagedTask = taskQueue.TryPop();
+		if (packagedTask == nullptr)
+			return;
+
+		(*packagedTask)();
+	}
+}
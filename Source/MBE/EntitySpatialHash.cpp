@@ -0,0 +1,203 @@
+#include <MBE/EntitySpatialHash.h>
+
+#include <MBE/Core/EntityCreatedEvent.h>
+#include <MBE/Core/EntityRemovedEvent.h>
+#include <MBE/Core/ComponentsChangedEvent.h>
+#include <MBE/Core/ComponentValueChangedEvent.h>
+#include <MBE/TransformComponent.h>
+#include <MBE/Graphics/TextureWrapperComponent.h>
+
+using namespace mbe;
+using mbe::event::EntityCreatedEvent;
+using mbe::event::EntityRemovedEvent;
+using mbe::event::ComponentsChangedEvent;
+using TransformChangedEvent = mbe::event::ComponentValueChangedEvent<TransformComponent>;
+using TextureWrapperChangedEvent = mbe::event::ComponentValueChangedEvent<TextureWrapperComponent>;
+
+EntitySpatialHash::EntitySpatialHash(EventManager & eventManager, const EntityManager & entityManager, float cellSize) :
+	eventManager(eventManager),
+	entityManager(entityManager),
+	spatialGrid(cellSize),
+	initialised(false),
+	updatedEntityCount(0)
+{
+	entityCreatedSubscription = eventManager.Subscribe(EventManager::TCallback<EntityCreatedEvent>([this](const EntityCreatedEvent& event)
+		{
+			if (event.GetEntityID().Valid())
+				MarkDirty(*event.GetEntityID());
+		}));
+
+	entityRemovedSubscription = eventManager.Subscribe(EventManager::TCallback<EntityRemovedEvent>([this](const EntityRemovedEvent& event)
+		{
+			RemoveEntity(event.GetEntityID());
+		}));
+
+	// A mbe::TransformComponent may be added after the entity has been created
+	componentsChangedSubscription = eventManager.Subscribe(EventManager::TCallback<ComponentsChangedEvent>([this](const ComponentsChangedEvent& event)
+		{
+			MarkDirty(event.GetEntity());
+		}));
+
+	transformChangedSubscription = eventManager.Subscribe(EventManager::TCallback<TransformChangedEvent>([this](const TransformChangedEvent& event)
+		{
+			MarkDirty(event.GetComponent().GetParentEntity());
+		}));
+
+	// The texture rect determines the bounds
+	textureWrapperChangedSubscription = eventManager.Subscribe(EventManager::TCallback<TextureWrapperChangedEvent>([this](const TextureWrapperChangedEvent& event)
+		{
+			MarkDirty(event.GetComponent().GetParentEntity());
+		}));
+}
+
+EntitySpatialHash::~EntitySpatialHash()
+{
+	eventManager.UnSubscribe<EntityCreatedEvent>(entityCreatedSubscription);
+	eventManager.UnSubscribe<EntityRemovedEvent>(entityRemovedSubscription);
+	eventManager.UnSubscribe<ComponentsChangedEvent>(componentsChangedSubscription);
+	eventManager.UnSubscribe<TransformChangedEvent>(transformChangedSubscription);
+	eventManager.UnSubscribe<TextureWrapperChangedEvent>(textureWrapperChangedSubscription);
+}
+
+void EntitySpatialHash::Update()
+{
+	updatedEntityCount = 0;
+
+	// Index the entities that existed before this was created
+	if (initialised == false)
+	{
+		for (const auto& entityId : entityManager.GetComponentGroup<TransformComponent>())
+			dirtyEntityIdSet.insert(entityId);
+		initialised = true;
+	}
+
+	for (const auto& entityId : dirtyEntityIdSet)
+	{
+		// The entity may have been deleted since it has been marked
+		if (entityId.Valid() == false || entityId->IsActive() == false || entityId->HasComponent<TransformComponent>() == false)
+		{
+			RemoveEntity(entityId);
+			continue;
+		}
+
+		UpdateEntity(*entityId);
+		updatedEntityCount++;
+	}
+
+	dirtyEntityIdSet.clear();
+}
+
+void EntitySpatialHash::QueryArea(const sf::FloatRect & area, std::vector<Entity::ID> & resultList)
+{
+	queryResultList.clear();
+	spatialGrid.Query(area, queryResultList);
+	AppendEntityIDs(resultList);
+}
+
+void EntitySpatialHash::QueryRadius(const sf::Vector2f & center, float radius, std::vector<Entity::ID> & resultList)
+{
+	queryResultList.clear();
+	spatialGrid.QueryRadius(center, radius, queryResultList);
+	AppendEntityIDs(resultList);
+}
+
+void EntitySpatialHash::QueryNearest(const sf::Vector2f & point, size_t count, std::vector<Entity::ID> & resultList, const Filter & filter, float maxDistance)
+{
+	// Deleted entities are filtered out during the search so that they do not take the place of an existing entity
+	queryResultList.clear();
+	spatialGrid.QueryNearest(point, count, queryResultList, [this, &filter](SpatialGrid::ValueID valueId)
+		{
+			if (IsValueValid(valueId) == false)
+				return false;
+
+			return !filter || filter(*entityIdList[valueId]);
+		}, maxDistance);
+	AppendEntityIDs(resultList);
+}
+
+void EntitySpatialHash::QueryRay(const sf::Vector2f & origin, const sf::Vector2f & direction, float maxDistance, std::vector<Entity::ID> & resultList, float radius)
+{
+	queryResultList.clear();
+	spatialGrid.QueryRay(origin, direction, maxDistance, queryResultList, radius);
+	AppendEntityIDs(resultList);
+}
+
+void EntitySpatialHash::MarkDirty(Entity & entity)
+{
+	if (entity.HasComponent<TransformComponent>())
+		dirtyEntityIdSet.insert(entity.GetHandleID());
+}
+
+void EntitySpatialHash::UpdateEntity(Entity & entity)
+{
+	const auto entityId = entity.GetHandleID();
+
+	auto it = valueIdDictionary.find(entityId);
+	if (it == valueIdDictionary.end())
+	{
+		// Get a free value id
+		SpatialGrid::ValueID valueId = entityIdList.size();
+		if (freeValueIdList.empty())
+		{
+			entityIdList.push_back(entityId);
+		}
+		else
+		{
+			valueId = freeValueIdList.back();
+			freeValueIdList.pop_back();
+			entityIdList[valueId] = entityId;
+		}
+		it = valueIdDictionary.emplace(entityId, valueId).first;
+	}
+
+	spatialGrid.Insert(it->second, CalculateBounds(entity));
+}
+
+void EntitySpatialHash::RemoveEntity(Entity::ID entityId)
+{
+	const auto it = valueIdDictionary.find(entityId);
+	if (it == valueIdDictionary.end())
+		return;
+
+	spatialGrid.Remove(it->second);
+	freeValueIdList.push_back(it->second);
+	valueIdDictionary.erase(it);
+}
+
+bool EntitySpatialHash::IsValueValid(SpatialGrid::ValueID valueId)
+{
+	const auto& entityId = entityIdList[valueId];
+	if (entityId.Valid() && entityId->IsActive())
+		return true;
+
+	// The grid can not be changed while it is being queried
+	deletedEntityIdList.push_back(entityId);
+	return false;
+}
+
+void EntitySpatialHash::AppendEntityIDs(std::vector<Entity::ID> & resultList)
+{
+	for (const auto valueId : queryResultList)
+	{
+		if (IsValueValid(valueId))
+			resultList.push_back(entityIdList[valueId]);
+	}
+
+	for (const auto& entityId : deletedEntityIdList)
+		RemoveEntity(entityId);
+	deletedEntityIdList.clear();
+}
+
+sf::FloatRect EntitySpatialHash::CalculateBounds(const Entity & entity)
+{
+	const auto& transform = entity.GetComponent<TransformComponent>().GetWorldTransform();
+
+	// The clickable area of textured entities
+	if (entity.HasComponent<TextureWrapperComponent>())
+	{
+		const auto& textureRect = entity.GetComponent<TextureWrapperComponent>().GetTextureRect();
+		return transform.transformRect(sf::FloatRect(0.f, 0.f, static_cast<float>(textureRect.width), static_cast<float>(textureRect.height)));
+	}
+
+	return sf::FloatRect(transform.transformPoint(sf::Vector2f()), sf::Vector2f());
+}
@@ -0,0 +1,129 @@
+#include <MBE/Graphics/RenderCommandList.h>
+#include <MBE/Graphics/RenderComponent.h>
+
+#include <cmath>
+#include <cassert>
+
+using namespace mbe;
+
+RenderCommandList::RenderCommandList() :
+	sortKey(0),
+	spriteCount(0),
+	textureSwitchCount(0),
+	lastTexture(nullptr)
+{
+}
+
+void RenderCommandList::Clear()
+{
+	commandList.clear();
+	vertexList.clear();
+	spriteReferenceList.clear();
+	sortKey = 0;
+	spriteCount = 0;
+	textureSwitchCount = 0;
+	lastTexture = nullptr;
+}
+
+void RenderCommandList::AddSprite(const sf::Sprite & sprite, const sf::Transform & transform)
+{
+	// An sf::Sprite without a texture is not drawn either
+	if (sprite.getTexture() == nullptr)
+		return;
+
+	// Start a new command unless the previous one draws vertices with the same texture
+	if (commandList.empty() || commandList.back().renderComponent != nullptr || commandList.back().texture != sprite.getTexture())
+	{
+		RenderCommand command;
+		command.texture = sprite.getTexture();
+		command.vertexOffset = vertexList.size();
+		command.sortKey = sortKey;
+		commandList.push_back(command);
+
+		// A batch may also be interrupted by an unbatched command without changing the texture
+		if (lastTexture != nullptr && lastTexture != command.texture)
+			textureSwitchCount++;
+		lastTexture = command.texture;
+	}
+
+	// Two triangles per sprite
+	// The capacity of the vertex list is kept between frames, so this does not allocate in the steady state
+	spriteReferenceList.push_back({ &sprite, &transform, vertexList.size() });
+	vertexList.resize(vertexList.size() + 6);
+
+	commandList.back().vertexCount += 6;
+	spriteCount++;
+}
+
+void RenderCommandList::GenerateVertices(ThreadPool * threadPool)
+{
+	// Every sprite writes to its own vertices, so the blocks can be processed concurrently
+	const auto generateVertices = [this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const auto& spriteReference = spriteReferenceList[i];
+			WriteSpriteVertices(vertexList.data() + spriteReference.vertexOffset, *spriteReference.sprite, *spriteReference.transform);
+		}
+	};
+
+	if (threadPool != nullptr)
+		threadPool->ParallelFor(0, spriteReferenceList.size(), generateVertices, detail::MIN_SPRITE_VERTEX_BLOCK_SIZE);
+	else
+		generateVertices(0, spriteReferenceList.size());
+
+	spriteReferenceList.clear();
+}
+
+void RenderCommandList::AddRenderComponent(const RenderComponent & renderComponent)
+{
+	RenderCommand command;
+	command.renderComponent = &renderComponent;
+	command.sortKey = sortKey;
+	commandList.push_back(command);
+}
+
+void RenderCommandList::Submit(sf::RenderTarget & target) const
+{
+	assert(spriteReferenceList.empty() && "RenderCommandList: GenerateVertices() must be called before submitting");
+
+	for (const auto& command : commandList)
+	{
+		if (command.renderComponent != nullptr)
+		{
+			command.renderComponent->Draw(target);
+			continue;
+		}
+
+		sf::RenderStates renderStates;
+		renderStates.texture = command.texture;
+		target.draw(vertexList.data() + command.vertexOffset, command.vertexCount, sf::Triangles, renderStates);
+	}
+}
+
+void RenderCommandList::WriteSpriteVertices(sf::Vertex * vertices, const sf::Sprite & sprite, const sf::Transform & transform)
+{
+	const sf::Transform combinedTransform = transform * sprite.getTransform();
+	const sf::IntRect& textureRect = sprite.getTextureRect();
+	const sf::Color& color = sprite.getColor();
+
+	// Same layout as in sf::Sprite (the texture rect may be flipped by using a negative width or height)
+	const float width = static_cast<float>(std::abs(textureRect.width));
+	const float height = static_cast<float>(std::abs(textureRect.height));
+	const float left = static_cast<float>(textureRect.left);
+	const float top = static_cast<float>(textureRect.top);
+	const float right = left + textureRect.width;
+	const float bottom = top + textureRect.height;
+
+	const sf::Vertex topLeft(combinedTransform.transformPoint(0.f, 0.f), color, { left, top });
+	const sf::Vertex bottomLeft(combinedTransform.transformPoint(0.f, height), color, { left, bottom });
+	const sf::Vertex topRight(combinedTransform.transformPoint(width, 0.f), color, { right, top });
+	const sf::Vertex bottomRight(combinedTransform.transformPoint(width, height), color, { right, bottom });
+
+	vertices[0] = topLeft;
+	vertices[1] = bottomLeft;
+	vertices[2] = topRight;
+	vertices[3] = topRight;
+	vertices[4] = bottomLeft;
+	vertices[5] = bottomRight;
+}
@@ -1,11 +1,14 @@
 #include <MBE/Graphics/RenderComponent.h>
 
+#include <algorithm>
+
 using namespace mbe;
 
 
 RenderComponent::RenderComponent(EventManager & eventManager, Entity & parentEntity)
 	: Component(eventManager, parentEntity),
-	hidden(false)
+	hidden(false),
+	revision(0)
 {
 }
 
@@ -16,6 +19,11 @@ sf::FloatRect RenderComponent::GetGlobalBounds() const
 	return this->GetLocalBounds();
 }
 
+bool RenderComponent::AppendToCommandList(RenderCommandList & commandList) const
+{
+	return false;
+}
+
 bool RenderComponent::IsVisible(const sf::View & view) const
 {
 	// This algorithm does not account for view rotation
@@ -33,10 +41,26 @@ bool RenderComponent::IsVisible(const sf::View & view) const
 
 void RenderComponent::SetHidden(bool value)
 {
+	if (hidden == value)
+		return;
+
+	// Hiding a component changes its appearance (e.g. a cached render layer must be drawn again)
 	hidden = value;
+	IncrementRevision();
 }
 
 bool RenderComponent::IsHidden() const
 {
 	return hidden;
 }
+
+bool RenderComponent::IsRevisionTracked() const
+{
+	return false;
+}
+
+bool RenderComponent::AreTransformsEqual(const sf::Transform & a, const sf::Transform & b)
+{
+	// The transform matrices are 4x4 matrices stored as 16 floats
+	return std::equal(a.getMatrix(), a.getMatrix() + 16, b.getMatrix());
+}
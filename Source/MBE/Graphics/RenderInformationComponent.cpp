@@ -10,10 +10,20 @@ RenderInformationComponent::RenderInformationComponent(EventManager& eventManage
 	zOrder(zOrder),
 	// Set the default getter functions
 	viewGetterFunction([](const Entity& entity) { return nullptr; }),
-	windowGetterFunction([]() {return nullptr; })
+	windowGetterFunction([]() {return nullptr; }),
+	zOrderChangedFunction([]() {})
 {
 }
 
+void RenderInformationComponent::SetZOrder(float value)
+{
+	if (value == zOrder)
+		return;
+
+	zOrder = value;
+	zOrderChangedFunction();
+}
+
 const sf::View* RenderInformationComponent::GetView() const
 {
 	return viewGetterFunction(this->parentEntity);
@@ -34,6 +44,11 @@ void RenderInformationComponent::ResetWindowGetterFunction()
 	windowGetterFunction = []() {return nullptr; };
 }
 
+void RenderInformationComponent::ResetZOrderChangedFunction()
+{
+	zOrderChangedFunction = []() {};
+}
+
 bool RenderInformationComponent::IsAbove(const RenderInformationComponent& renderInformationComponent) const
 {
 	if (renderInformationComponent.GetRenderLayer() > this->GetRenderLayer())
@@ -0,0 +1,30 @@
+#include <MBE/Graphics/RenderStatisticsComponent.h>
+
+using namespace mbe;
+
+MBE_ENABLE_COMPONENT_POLYMORPHISM(RenderStatisticsComponent, RenderComponent)
+
+RenderStatisticsComponent::RenderStatisticsComponent(EventManager& eventManager, Entity& parentEntity, const sf::Font& font, unsigned int characterSize) :
+	RenderComponent(eventManager, parentEntity),
+	text("", font, characterSize)
+{
+}
+
+void RenderStatisticsComponent::Draw(sf::RenderTarget& target) const
+{
+	auto transform = sf::Transform::Identity;
+	if (parentEntity.HasComponent<TransformComponent>())
+		transform = parentEntity.GetComponent<TransformComponent>().GetWorldTransform();
+
+	target.draw(text, transform);
+}
+
+sf::FloatRect RenderStatisticsComponent::GetLocalBounds() const
+{
+	return text.getLocalBounds();
+}
+
+void RenderStatisticsComponent::SetText(const std::string& value)
+{
+	text.setString(value);
+}
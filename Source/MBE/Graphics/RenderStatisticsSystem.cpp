@@ -0,0 +1,23 @@
+#include <MBE/Graphics/RenderStatisticsSystem.h>
+
+using namespace mbe;
+
+RenderStatisticsSystem::RenderStatisticsSystem(const EntityManager& entityManager, const RenderSystem& renderSystem) :
+	BaseComponentRenderSystem(entityManager),
+	renderSystem(renderSystem)
+{
+}
+
+void RenderStatisticsSystem::Update()
+{
+	const auto& entityIdList = entityManager.GetComponentGroup<RenderStatisticsComponent>();
+	if (entityIdList.empty())
+		return;
+
+	std::ostringstream stream;
+	stream << renderSystem.GetRenderStatistics();
+	const auto text = stream.str();
+
+	for (const auto& entityId : entityIdList)
+		entityId->GetComponent<RenderStatisticsComponent>().SetText(text);
+}
@@ -2,13 +2,18 @@
 
 #include <MBE/Graphics/RenderSystem.h>
 
+#include <cmath>
+#include <stdexcept>
+
 using namespace mbe;
 using TextureWrapperChangedEvent = mbe::event::ComponentValueChangedEvent<TextureWrapperComponent>;
 
 RenderSystem::RenderSystem(sf::RenderWindow& windowPtr, EventManager& eventManager, TextureWrapperHolder<>& textureWrapperHolder) :
 	window(windowPtr),
 	eventManager(eventManager),
-	textureWrapperHolder(textureWrapperHolder)
+	textureWrapperHolder(textureWrapperHolder),
+	batchingEnabled(true),
+	threadPool(nullptr)
 {
 	// Set the default views
 	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
@@ -54,22 +59,29 @@ RenderSystem::~RenderSystem()
 	// Reset the render information component getters
 	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
 	{
-		auto& renderEntityIdList = renderEntityDictionary[renderLayer];
-		for (auto& entityId : renderEntityIdList)
+		for (auto& renderEntity : renderEntityDictionary[renderLayer].renderEntitySlotList)
 		{
-			// This should always be the case
-			assert(entityId->HasComponent<RenderInformationComponent>() && "RenderSystem: The entity must have a mbe::RenderInformationComponent");
+			// Skip free slots
+			if (renderEntity.renderComponent == nullptr)
+				continue;
 
-			// Get the render information component and reset the getters
-			auto& renderInformationComponent = entityId->GetComponent<RenderInformationComponent>();
-			renderInformationComponent.ResetViewGetterFunction();
-			renderInformationComponent.ResetWindowGetterFunction();
+			renderEntity.renderInformationComponent->ResetViewGetterFunction();
+			renderEntity.renderInformationComponent->ResetWindowGetterFunction();
+			renderEntity.renderInformationComponent->ResetZOrderChangedFunction();
 		}
 	}
 }
 
 void RenderSystem::Render()
 {
+	Prepare();
+	Submit();
+}
+
+void RenderSystem::Prepare()
+{
+	sf::Clock clock;
+
 	// Remove all expired nodes
 	this->Refresh();
 
@@ -79,32 +91,97 @@ void RenderSystem::Render()
 		componentRenderSystemPtr->Update();
 	}
 
+	// The layer tasks only read the cached world transforms
+	if (threadPool != nullptr)
+		ResolveWorldTransforms();
+
+	// The dictionaries are accessed on this thread since std::unordered_map::operator[] may insert
+	const sf::Vector2u targetSize = window.getSize();
+	std::vector<std::future<void>> futureList;
 	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
 	{
-		// Draw all the render nodes in the current layer
+		auto& renderLayerData = renderEntityDictionary[renderLayer];
+		const auto& view = viewDictionary[renderLayer];
+		const auto& zOrderAssignmentFunction = zOrderAssignmentFunctionDictionary[renderLayer];
+
+		if (threadPool == nullptr)
+		{
+			PrepareLayer(renderLayerData, view, targetSize, zOrderAssignmentFunction, batchingEnabled, nullptr);
+			continue;
+		}
+
+		futureList.push_back(threadPool->Enqueue([&renderLayerData, &view, targetSize, &zOrderAssignmentFunction, batchingEnabled = batchingEnabled, threadPool = threadPool]()
+			{
+				PrepareLayer(renderLayerData, view, targetSize, zOrderAssignmentFunction, batchingEnabled, threadPool);
+			}));
+	}
+
+	// Wait for all layers before rethrowing any exception, since the tasks reference the layer data
+	for (auto& future : futureList)
+		future.wait();
+	for (auto& future : futureList)
+		future.get();
+
+	renderStatistics.prepareTime = clock.getElapsedTime();
+}
+
+void RenderSystem::Submit()
+{
+	sf::Clock clock;
+
+	// The prepare time has been set by Prepare()
+	const auto prepareTime = renderStatistics.prepareTime;
+	renderStatistics = RenderStatistics();
+	renderStatistics.prepareTime = prepareTime;
+
+	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
+	{
+		auto& renderLayerData = renderEntityDictionary[renderLayer];
 		window.setView(viewDictionary[renderLayer]);
-		auto& renderEntityIdList = renderEntityDictionary[renderLayer];
 
-		// Assign the z-order based on the sorting method
-		// Make sure a function has been registered
-		if (zOrderAssignmentFunctionDictionary[renderLayer])
-			zOrderAssignmentFunctionDictionary[renderLayer](renderEntityIdList);
+		if (renderLayerData.layerCache.action != LayerCache::Action::None)
+			SubmitLayerCache(renderLayerData);
+		else
+			renderLayerData.commandList.Submit(window);
+
+		UpdateLayerStatistics(renderLayerData);
+
+		const auto& layerStatistics = renderLayerData.statistics;
+		renderStatistics.layerStatisticsDictionary[renderLayer] = layerStatistics;
+		renderStatistics.consideredEntityCount += layerStatistics.consideredEntityCount;
+		renderStatistics.culledEntityCount += layerStatistics.culledEntityCount;
+		renderStatistics.drawnEntityCount += layerStatistics.drawnEntityCount;
+		renderStatistics.drawCallCount += layerStatistics.drawCallCount;
+		renderStatistics.batchedSpriteCount += layerStatistics.batchedSpriteCount;
+		renderStatistics.vertexCount += layerStatistics.vertexCount;
+		renderStatistics.textureSwitchCount += layerStatistics.textureSwitchCount;
+		renderStatistics.sortTime += layerStatistics.sortTime;
+	}
 
-		// Sort the render nodes based on their z-order
-		SortByZOrder(renderEntityIdList);
+	renderStatistics.submitTime = clock.getElapsedTime();
+}
 
-		for (const auto& renderEntityId : renderEntityIdList)
+void RenderSystem::ResolveWorldTransforms()
+{
+	for (auto& pair : renderEntityDictionary)
+	{
+		for (auto& renderEntity : pair.second.renderEntitySlotList)
 		{
-			// Get the renderComponent of the entity that corresponds to the id
-			const auto& renderComponent = renderEntityId->GetComponent<RenderComponent>();
+			// Skip free slots
+			if (renderEntity.renderComponent == nullptr)
+				continue;
 
-			// Culling - only draw if the entity is visible on screen
-			if (renderComponent.IsVisible(viewDictionary[renderLayer]) && renderComponent.IsHidden() == false)
+			if (renderEntity.transformComponent == nullptr)
 			{
-				// If the entity still exists
-				// This should always be the case since expired entities are removed in the refresh function
-				renderComponent.Draw(window);
+				if (renderEntity.entityId->HasComponent<TransformComponent>() == false)
+					continue;
+
+				renderEntity.transformComponent = &renderEntity.entityId->GetComponent<TransformComponent>();
 			}
+
+			// Also calculates the world transforms of the dirty parents
+			if (renderEntity.transformComponent->IsWorldTransformDirty())
+				renderEntity.transformComponent->GetWorldTransform();
 		}
 	}
 }
@@ -129,6 +206,49 @@ const sf::View& RenderSystem::GetView(RenderLayer renderLayer) const
 	return viewDictionary[renderLayer];
 }
 
+void RenderSystem::SetCullingCellSize(RenderLayer renderLayer, float cellSize)
+{
+	auto& renderLayerData = renderEntityDictionary[renderLayer];
+	renderLayerData.spatialGrid = SpatialGrid(cellSize);
+
+	// Reinsert the tracked render entities
+	for (size_t slot = 0; slot < renderLayerData.renderEntitySlotList.size(); slot++)
+	{
+		auto& renderEntity = renderLayerData.renderEntitySlotList[slot];
+		if (renderEntity.renderComponent == nullptr || renderEntity.tracked == false)
+			continue;
+
+		renderLayerData.spatialGrid.Insert(slot, renderEntity.renderComponent->GetGlobalBounds());
+		renderEntity.boundsRevision = renderEntity.renderComponent->GetRevision();
+	}
+}
+
+void RenderSystem::SetLayerCachingEnabled(RenderLayer renderLayer, bool value)
+{
+	auto& layerCache = renderEntityDictionary[renderLayer].layerCache;
+	layerCache.enabled = value;
+	layerCache.valid = false;
+
+	// Free the textures
+	if (value == false)
+	{
+		layerCache.action = LayerCache::Action::None;
+		layerCache.frontTexture.reset();
+		layerCache.backTexture.reset();
+	}
+}
+
+bool RenderSystem::IsLayerCachingEnabled(RenderLayer renderLayer) const
+{
+	const auto it = renderEntityDictionary.find(renderLayer);
+	return it != renderEntityDictionary.cend() && it->second.layerCache.enabled;
+}
+
+void RenderSystem::InvalidateLayerCache(RenderLayer renderLayer)
+{
+	renderEntityDictionary[renderLayer].contentChanged = true;
+}
+
 void RenderSystem::AddRenderEntity(Entity::ID entityId)
 {
 	// Can't add a non existing node
@@ -153,7 +273,47 @@ void RenderSystem::AddRenderEntity(Entity::ID entityId)
 			return &this->GetRenderWindow();
 		});
 
-	renderEntityDictionary[renderInformationComponent.GetRenderLayer()].push_back(entityId);
+	// Get a free slot
+	auto& renderLayerData = renderEntityDictionary[renderInformationComponent.GetRenderLayer()];
+	size_t slot = renderLayerData.renderEntitySlotList.size();
+	if (renderLayerData.freeSlotList.empty())
+	{
+		renderLayerData.renderEntitySlotList.emplace_back();
+	}
+	else
+	{
+		slot = renderLayerData.freeSlotList.back();
+		renderLayerData.freeSlotList.pop_back();
+	}
+
+	// The slot of a render entity does not change while it is registered and the layer data is never moved (std::unordered_map)
+	renderInformationComponent.SetZOrderChangedFunction([&renderLayerData, slot]()
+		{
+			renderLayerData.changedSlotList.push_back(slot);
+		});
+
+	auto& renderEntity = renderLayerData.renderEntitySlotList[slot];
+	renderEntity.entityId = entityId;
+	renderEntity.renderComponent = &entityId->GetComponent<RenderComponent>();
+	renderEntity.renderInformationComponent = &renderInformationComponent;
+	renderEntity.tracked = renderEntity.renderComponent->IsRevisionTracked();
+
+	if (renderEntity.tracked)
+	{
+		renderLayerData.spatialGrid.Insert(slot, renderEntity.renderComponent->GetGlobalBounds());
+		renderEntity.boundsRevision = renderEntity.renderComponent->GetRevision();
+	}
+	else
+	{
+		renderLayerData.untrackedSlotList.push_back(slot);
+	}
+
+	// Add the entity to the end of the draw order (it is moved to the right place when the layer is sorted)
+	renderEntity.sortIndex = renderLayerData.sortKeyList.size();
+	renderLayerData.sortKeyList.push_back({ renderInformationComponent.GetZOrder(), slot });
+	renderLayerData.entityIdList.push_back(entityId);
+	renderLayerData.addedKeyCount++;
+	renderLayerData.contentChanged = true;
 }
 
 void RenderSystem::RemoveRenderEntity(Entity::ID entityId)
@@ -172,18 +332,16 @@ void RenderSystem::RemoveRenderEntity(Entity::ID entityId)
 	auto renderLayer = renderInformationComponent.GetRenderLayer();
 
 	// Remove the node from this layer
-	// std::find_if returns an it to the first intance for which the lambda returns true
-	auto& renderEntityIdList = renderEntityDictionary[renderLayer];
-	auto it = std::find_if(renderEntityIdList.begin(), renderEntityIdList.end(), [=](auto currentEntityId)
+	auto& renderLayerData = renderEntityDictionary[renderLayer];
+	const size_t previousSize = renderLayerData.sortKeyList.size();
+	RemoveRenderEntities(renderLayerData, [=](const RenderEntity& renderEntity)
 		{
-			return entityId == currentEntityId;
+			return entityId == renderEntity.entityId;
 		});
 
-	if (it == renderEntityIdList.end())
+	if (renderLayerData.sortKeyList.size() == previousSize)
 		throw std::runtime_error("RenderSystem: The render entity could not be found");
 
-	renderEntityIdList.erase(it);
-
 	// Reset the RenderInformationComponent getters
 	renderInformationComponent.ResetViewGetterFunction();
 	renderInformationComponent.ResetWindowGetterFunction();
@@ -203,33 +361,461 @@ void RenderSystem::Refresh()
 	// Entities are automatically deleted when they expire (This is much more efficient than calling RemoveRenderEntity())
 	for (auto& pair : renderEntityDictionary)
 	{
-		auto& entityList = pair.second;
-		entityList.erase(std::remove_if(entityList.begin(), entityList.end(), [](const auto& currentEntityId)
+		RemoveRenderEntities(pair.second, [](const RenderEntity& renderEntity)
 			{
-				return !currentEntityId.Valid() || !currentEntityId->IsActive();
-			}), entityList.end());
+				return !renderEntity.entityId.Valid() || !renderEntity.entityId->IsActive();
+			});
 	}
 }
 
-bool RenderSystem::IsVisible(const Entity& entity, const sf::View& view)
+void RenderSystem::SortByZOrder(RenderLayerData& renderLayerData)
 {
-	//const auto & boundingBox = entity.GetComponent<RenderComponent>().GetBoundingBox();
+	auto& sortKeyList = renderLayerData.sortKeyList;
+	auto& renderEntitySlotList = renderLayerData.renderEntitySlotList;
+	auto& changedSlotList = renderLayerData.changedSlotList;
+
+	// Only the keys of entities whose z-order has been set to a different value can have changed
+	// A slot may have been freed (or even reused) since it has been added to the list
+	changedSlotList.erase(std::remove_if(changedSlotList.begin(), changedSlotList.end(), [&](size_t slot)
+		{
+			const auto& renderEntity = renderEntitySlotList[slot];
+			return renderEntity.renderComponent == nullptr
+				|| renderEntity.renderInformationComponent->GetZOrder() == sortKeyList[renderEntity.sortIndex].zOrder;
+		}), changedSlotList.end());
+
+	// Added entities are appended to the end of the list
+	const size_t addedKeyCount = renderLayerData.addedKeyCount;
+	renderLayerData.addedKeyCount = 0;
+
+	// The list is still sorted from the last frame
+	if (changedSlotList.empty() && addedKeyCount == 0)
+		return;
+
+	renderLayerData.contentChanged = true;
+
+	if (changedSlotList.size() + addedKeyCount <= detail::MAX_INSERTION_SORT_CHANGED_KEY_COUNT)
+	{
+		// The appended keys are inserted into the sorted part of the list one after another
+		// The keys behind them have not been inserted yet, so they are only moved towards the front
+		for (size_t sortIndex = sortKeyList.size() - addedKeyCount; sortIndex < sortKeyList.size(); sortIndex++)
+			MoveSortKey(renderLayerData, sortIndex, sortIndex + 1);
+
+		// Every other key is in its place, so a changed key only needs to be moved past its new neighbours
+		// A slot may be listed more than once, in which case it is already in place the second time
+		for (const auto slot : changedSlotList)
+		{
+			const auto& renderEntity = renderEntitySlotList[slot];
+			sortKeyList[renderEntity.sortIndex].zOrder = renderEntity.renderInformationComponent->GetZOrder();
+			MoveSortKey(renderLayerData, renderEntity.sortIndex, sortKeyList.size());
+		}
+	}
+	else
+	{
+		// Many keys have changed (e.g. when a layer is loaded or the camera has moved in a top down game)
+		for (const auto slot : changedSlotList)
+		{
+			const auto& renderEntity = renderEntitySlotList[slot];
+			sortKeyList[renderEntity.sortIndex].zOrder = renderEntity.renderInformationComponent->GetZOrder();
+		}
+
+		// std::stable_sort is a merge sort with O(n log n) comparisons
+		// It is a consistent sort which prevents flickering if two render nodes have the same z order
+		std::stable_sort(sortKeyList.begin(), sortKeyList.end(), [](const SortKey& a, const SortKey& b)
+			{
+				return a.zOrder < b.zOrder;
+			});
+
+		UpdateSortIndices(renderLayerData);
+	}
+
+	changedSlotList.clear();
+}
+
+void RenderSystem::MoveSortKey(RenderLayerData& renderLayerData, size_t sortIndex, size_t endIndex)
+{
+	auto& sortKeyList = renderLayerData.sortKeyList;
+	auto& renderEntitySlotList = renderLayerData.renderEntitySlotList;
+	const SortKey sortKey = sortKeyList[sortIndex];
+
+	// Entities with the same z-order are not passed so that their order does not change
+	size_t i = sortIndex;
+	for (; i > 0 && sortKeyList[i - 1].zOrder > sortKey.zOrder; i--)
+	{
+		sortKeyList[i] = sortKeyList[i - 1];
+		renderEntitySlotList[sortKeyList[i].slot].sortIndex = i;
+	}
+
+	// If the key has not moved towards the front, it may need to move towards the back
+	if (i == sortIndex)
+	{
+		for (; i + 1 < endIndex && sortKeyList[i + 1].zOrder < sortKey.zOrder; i++)
+		{
+			sortKeyList[i] = sortKeyList[i + 1];
+			renderEntitySlotList[sortKeyList[i].slot].sortIndex = i;
+		}
+	}
+
+	sortKeyList[i] = sortKey;
+	renderEntitySlotList[sortKey.slot].sortIndex = i;
+}
+
+void RenderSystem::UpdateSortIndices(RenderLayerData& renderLayerData)
+{
+	for (size_t sortIndex = 0; sortIndex < renderLayerData.sortKeyList.size(); sortIndex++)
+		renderLayerData.renderEntitySlotList[renderLayerData.sortKeyList[sortIndex].slot].sortIndex = sortIndex;
+}
+
+void RenderSystem::UpdateSpatialGrid(RenderLayerData& renderLayerData)
+{
+	// Only the bounds of entities whose render component has changed are recalculated
+	for (size_t slot = 0; slot < renderLayerData.renderEntitySlotList.size(); slot++)
+	{
+		auto& renderEntity = renderLayerData.renderEntitySlotList[slot];
+		if (renderEntity.tracked == false || renderEntity.boundsRevision == renderEntity.renderComponent->GetRevision())
+			continue;
+
+		renderLayerData.spatialGrid.Insert(slot, renderEntity.renderComponent->GetGlobalBounds());
+		renderEntity.boundsRevision = renderEntity.renderComponent->GetRevision();
+		renderLayerData.contentChanged = true;
+	}
+}
+
+void RenderSystem::BuildDrawList(RenderLayerData& renderLayerData, const sf::View& view)
+{
+	auto& drawSlotList = renderLayerData.drawSlotList;
+	auto& renderEntitySlotList = renderLayerData.renderEntitySlotList;
+	drawSlotList.clear();
+
+	// The axis aligned bounding box of the view in world coordinates (this accounts for view rotation)
+	const auto viewRect = view.getInverseTransform().transformRect({ -1.f, -1.f, 2.f, 2.f });
+
+	renderLayerData.spatialGrid.Query(viewRect, drawSlotList);
+	for (const auto slot : renderLayerData.untrackedSlotList)
+	{
+		if (renderEntitySlotList[slot].renderComponent->IsVisible(view))
+			drawSlotList.push_back(slot);
+	}
+
+	SortDrawList(renderLayerData);
+}
+
+void RenderSystem::BuildDrawList(RenderLayerData& renderLayerData, const std::vector<sf::FloatRect>& areaList)
+{
+	renderLayerData.drawSlotList.clear();
+
+	// An entity that intersects more than one area is found more than once
+	for (const auto& area : areaList)
+		renderLayerData.spatialGrid.Query(area, renderLayerData.drawSlotList);
+
+	SortDrawList(renderLayerData);
+}
+
+void RenderSystem::SortDrawList(RenderLayerData& renderLayerData)
+{
+	auto& drawSlotList = renderLayerData.drawSlotList;
+	auto& renderEntitySlotList = renderLayerData.renderEntitySlotList;
+
+	// Bring the visible entities into draw order
+	// When most of the layer is visible, it is faster to filter the sorted key list than to sort the visible entities
+	if (drawSlotList.size() * 4 < renderLayerData.sortKeyList.size())
+	{
+		std::sort(drawSlotList.begin(), drawSlotList.end(), [&renderEntitySlotList](size_t a, size_t b)
+			{
+				return renderEntitySlotList[a].sortIndex < renderEntitySlotList[b].sortIndex;
+			});
+		drawSlotList.erase(std::unique(drawSlotList.begin(), drawSlotList.end()), drawSlotList.end());
+		return;
+	}
+
+	renderLayerData.frame++;
+	for (const auto slot : drawSlotList)
+		renderEntitySlotList[slot].visibleFrame = renderLayerData.frame;
+
+	drawSlotList.clear();
+	for (const auto& sortKey : renderLayerData.sortKeyList)
+	{
+		if (renderEntitySlotList[sortKey.slot].visibleFrame == renderLayerData.frame)
+			drawSlotList.push_back(sortKey.slot);
+	}
+}
+
+void RenderSystem::PrepareLayer(RenderLayerData& renderLayerData, const sf::View& view, const sf::Vector2u& targetSize,
+	const ZOrderAssignmentFunction& zOrderAssignmentFunction, bool batchingEnabled, ThreadPool* threadPool)
+{
+	auto& statistics = renderLayerData.statistics;
+	statistics = LayerStatistics();
+	sf::Clock clock;
+
+	// Assign the z-order based on the sorting method
+	// Make sure a function has been registered
+	if (zOrderAssignmentFunction)
+		zOrderAssignmentFunction(renderLayerData.entityIdList);
+
+	// Sort the render nodes based on their z-order
+	SortByZOrder(renderLayerData);
+	statistics.sortTime = clock.getElapsedTime();
+
+	// Culling - only draw the entities that are visible on screen (or that must be drawn to the layer cache)
+	UpdateSpatialGrid(renderLayerData);
+	if (PrepareLayerCache(renderLayerData, view, targetSize) == false)
+		BuildDrawList(renderLayerData, view);
+
+	// The draw slot list does not contain any duplicates
+	statistics.consideredEntityCount = renderLayerData.sortKeyList.size();
+	statistics.culledEntityCount = statistics.consideredEntityCount - renderLayerData.drawSlotList.size();
+
+	auto& commandList = renderLayerData.commandList;
+	commandList.Clear();
+
+	for (const auto slot : renderLayerData.drawSlotList)
+	{
+		const auto& renderEntity = renderLayerData.renderEntitySlotList[slot];
+		const auto& renderComponent = *renderEntity.renderComponent;
+
+		if (renderComponent.IsHidden())
+			continue;
+
+		statistics.drawnEntityCount++;
+		commandList.SetSortKey(renderEntity.sortIndex);
+		if (batchingEnabled && renderComponent.AppendToCommandList(commandList))
+			continue;
+
+		commandList.AddRenderComponent(renderComponent);
+	}
+
+	commandList.GenerateVertices(threadPool);
+}
+
+bool RenderSystem::PrepareLayerCache(RenderLayerData& renderLayerData, const sf::View& view, const sf::Vector2u& targetSize)
+{
+	auto& layerCache = renderLayerData.layerCache;
+
+	// The front texture is out of date if the content has changed
+	// Invalidating it here is safe even if the frame is not submitted, since it only causes a rebuild
+	if (renderLayerData.contentChanged)
+		layerCache.valid = false;
+	renderLayerData.contentChanged = false;
+
+	// The size of the view in pixels
+	const auto& viewport = view.getViewport();
+	const sf::Vector2u viewPixelSize(
+		static_cast<unsigned int>(std::lround(viewport.width * targetSize.x)),
+		static_cast<unsigned int>(std::lround(viewport.height * targetSize.y)));
+
+	// Rotated views can not be aligned to the pixel grid
+	// The changes of untracked entities can not be detected
+	if (layerCache.enabled == false || view.getRotation() != 0.f || renderLayerData.untrackedSlotList.empty() == false
+		|| viewPixelSize.x == 0 || viewPixelSize.y == 0)
+	{
+		layerCache.action = LayerCache::Action::None;
+		layerCache.valid = false;
+		return false;
+	}
+
+	const unsigned int guardBandSize = detail::LAYER_CACHE_GUARD_BAND_SIZE;
+	const sf::Vector2u pixelSize(viewPixelSize.x + 2u * guardBandSize, viewPixelSize.y + 2u * guardBandSize);
+	const sf::Vector2f pixelWorldSize(view.getSize().x / viewPixelSize.x, view.getSize().y / viewPixelSize.y);
+	const bool sameScale = layerCache.valid && layerCache.pixelSize == pixelSize && layerCache.pixelWorldSize == pixelWorldSize;
+
+	// Reuse the texture while the view is within the cached area
+	const auto viewRect = view.getInverseTransform().transformRect({ -1.f, -1.f, 2.f, 2.f });
+	const auto& area = layerCache.area;
+	if (sameScale
+		&& viewRect.left >= area.left && viewRect.top >= area.top
+		&& viewRect.left + viewRect.width <= area.left + area.width && viewRect.top + viewRect.height <= area.top + area.height)
+	{
+		layerCache.action = LayerCache::Action::Reuse;
+		layerCache.nextArea = area;
+		layerCache.nextPixelSize = pixelSize;
+		layerCache.nextPixelWorldSize = pixelWorldSize;
+		layerCache.stripList.clear();
+		renderLayerData.drawSlotList.clear();
+		return true;
+	}
+
+	// Center the new area on the view
+	// The area is aligned to the pixel grid, so that the pixels of the previous area can be copied
+	sf::FloatRect newArea;
+	newArea.width = pixelSize.x * pixelWorldSize.x;
+	newArea.height = pixelSize.y * pixelWorldSize.y;
+	newArea.left = std::floor((view.getCenter().x - newArea.width / 2.f) / pixelWorldSize.x) * pixelWorldSize.x;
+	newArea.top = std::floor((view.getCenter().y - newArea.height / 2.f) / pixelWorldSize.y) * pixelWorldSize.y;
+
+	// The position of the area of the front texture in the pixels of the new area
+	const sf::Vector2i shift(
+		static_cast<int>(std::lround((area.left - newArea.left) / pixelWorldSize.x)),
+		static_cast<int>(std::lround((area.top - newArea.top) / pixelWorldSize.y)));
+	const sf::Vector2i size(static_cast<int>(pixelSize.x), static_cast<int>(pixelSize.y));
+
+	layerCache.stripList.clear();
+	if (sameScale && std::abs(shift.x) < size.x && std::abs(shift.y) < size.y)
+	{
+		// Only the strips that are not covered by the previous area must be drawn
+		// The horizontal strips only span the columns that are covered, so that the strips do not overlap
+		const int coveredLeft = std::max(0, shift.x);
+		const int coveredRight = std::min(size.x, shift.x + size.x);
+
+		if (shift.x > 0)
+			layerCache.stripList.push_back({ 0, 0, shift.x, size.y });
+		else if (shift.x < 0)
+			layerCache.stripList.push_back({ size.x + shift.x, 0, -shift.x, size.y });
+
+		if (shift.y > 0)
+			layerCache.stripList.push_back({ coveredLeft, 0, coveredRight - coveredLeft, shift.y });
+		else if (shift.y < 0)
+			layerCache.stripList.push_back({ coveredLeft, size.y + shift.y, coveredRight - coveredLeft, -shift.y });
+
+		layerCache.action = LayerCache::Action::Shift;
+	}
+	else
+	{
+		layerCache.stripList.push_back({ 0, 0, size.x, size.y });
+		layerCache.action = LayerCache::Action::Rebuild;
+	}
+
+	// The new area is only committed by SubmitLayerCache() once it has been drawn
+	layerCache.nextArea = newArea;
+	layerCache.nextPixelSize = pixelSize;
+	layerCache.nextPixelWorldSize = pixelWorldSize;
+	layerCache.shift = shift;
+
+	// Find the entities in the strips
+	// The areas are extended by a pixel, so that entities that only touch the border of a strip are not missed due to rounding
+	std::vector<sf::FloatRect> drawAreaList;
+	for (const auto& strip : layerCache.stripList)
+	{
+		auto drawArea = MapCachePixelsToArea(layerCache, strip);
+		drawArea.left -= pixelWorldSize.x;
+		drawArea.top -= pixelWorldSize.y;
+		drawArea.width += 2.f * pixelWorldSize.x;
+		drawArea.height += 2.f * pixelWorldSize.y;
+		drawAreaList.push_back(drawArea);
+	}
+	BuildDrawList(renderLayerData, drawAreaList);
 
 	return true;
 }
 
-void RenderSystem::SortByZOrder(std::vector<Entity::ID>& entityIdList)
+void RenderSystem::SubmitLayerCache(RenderLayerData& renderLayerData)
 {
-	// Use insertion sort to sort by zOrder
-	// Insertion sort is fast for nearly sorted lists
-	// This will nearly always be the case since not many, if any object will changes between two frames
-	// Furthermore, it is a consistent sort which prevents flickering if two render nodes have the z order
-	size_t size = entityIdList.size();
-	for (size_t i = 1; i < size; i++)
+	auto& layerCache = renderLayerData.layerCache;
+	const auto& pixelSize = layerCache.nextPixelSize;
+
+	if (layerCache.action == LayerCache::Action::Shift || layerCache.action == LayerCache::Action::Rebuild)
 	{
-		for (size_t j = i; j > 0 && entityIdList[j - 1]->GetComponent<RenderInformationComponent>().GetZOrder() > entityIdList[j]->GetComponent<RenderInformationComponent>().GetZOrder(); j--)
+		// The textures are created here since they need the OpenGL context of this thread
+		auto& backTexture = layerCache.backTexture;
+		if (backTexture == nullptr || backTexture->getSize() != pixelSize)
 		{
-			std::swap(entityIdList[j], entityIdList[j - 1]);
+			backTexture = std::make_unique<sf::RenderTexture>();
+			if (backTexture->create(pixelSize.x, pixelSize.y) == false)
+			{
+				backTexture.reset();
+				throw std::runtime_error("RenderSystem: Failed to create the layer cache texture");
+			}
+		}
+
+		backTexture->clear(sf::Color::Transparent);
+
+		// Copy the pixels of the previous area
+		// The blend mode is disabled, so that the pixels are copied as they are
+		if (layerCache.action == LayerCache::Action::Shift)
+		{
+			sf::Sprite previousSprite(layerCache.frontTexture->getTexture());
+			previousSprite.setPosition(static_cast<float>(layerCache.shift.x), static_cast<float>(layerCache.shift.y));
+			backTexture->setView(backTexture->getDefaultView());
+			backTexture->draw(previousSprite, sf::RenderStates(sf::BlendNone));
+		}
+
+		// Draw the commands into each strip
+		// The viewport clips the entities that reach into the copied pixels, so that they are not blended twice
+		for (const auto& strip : layerCache.stripList)
+		{
+			sf::View stripView(MapCachePixelsToArea(layerCache, strip));
+			stripView.setViewport(sf::FloatRect(
+				static_cast<float>(strip.left) / pixelSize.x, static_cast<float>(strip.top) / pixelSize.y,
+				static_cast<float>(strip.width) / pixelSize.x, static_cast<float>(strip.height) / pixelSize.y));
+			backTexture->setView(stripView);
+			renderLayerData.commandList.Submit(*backTexture);
 		}
+
+		backTexture->display();
+		std::swap(layerCache.frontTexture, layerCache.backTexture);
+
+		// The front texture now holds the next area
+		layerCache.valid = true;
+		layerCache.area = layerCache.nextArea;
+		layerCache.pixelSize = layerCache.nextPixelSize;
+		layerCache.pixelWorldSize = layerCache.nextPixelWorldSize;
 	}
+
+	// The cache is only reused or shifted while it is valid, which requires the front texture to have been drawn
+	assert(layerCache.valid && layerCache.frontTexture != nullptr && "RenderSystem: The layer cache texture has not been drawn");
+
+	// The colours in the texture have already been multiplied by their alpha when they were drawn into it
+	sf::Sprite cacheSprite(layerCache.frontTexture->getTexture());
+	cacheSprite.setPosition(layerCache.area.left, layerCache.area.top);
+	cacheSprite.setScale(layerCache.pixelWorldSize);
+	window.draw(cacheSprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+}
+
+void RenderSystem::UpdateLayerStatistics(RenderLayerData& renderLayerData)
+{
+	const auto& commandList = renderLayerData.commandList;
+	auto& statistics = renderLayerData.statistics;
+
+	statistics.batchedSpriteCount = commandList.GetSpriteCount();
+	statistics.textureSwitchCount = commandList.GetTextureSwitchCount();
+
+	if (renderLayerData.layerCache.action == LayerCache::Action::None)
+	{
+		statistics.drawCallCount = commandList.GetDrawCallCount();
+		statistics.vertexCount = commandList.GetVertexList().size();
+		return;
+	}
+
+	// The command list is drawn once per strip and the cached texture is drawn as a single quad
+	const size_t stripCount = renderLayerData.layerCache.stripList.size();
+	statistics.drawCallCount = commandList.GetDrawCallCount() * stripCount + 1;
+	statistics.vertexCount = commandList.GetVertexList().size() * stripCount + 4;
+}
+
+sf::FloatRect RenderSystem::MapCachePixelsToArea(const LayerCache& layerCache, const sf::IntRect& pixelRect)
+{
+	return sf::FloatRect(
+		layerCache.nextArea.left + pixelRect.left * layerCache.nextPixelWorldSize.x,
+		layerCache.nextArea.top + pixelRect.top * layerCache.nextPixelWorldSize.y,
+		pixelRect.width * layerCache.nextPixelWorldSize.x,
+		pixelRect.height * layerCache.nextPixelWorldSize.y);
+}
+
+std::ostream& mbe::operator<<(std::ostream& stream, const RenderSystem::RenderStatistics& renderStatistics)
+{
+	const auto writeCounters = [&stream](const RenderSystem::LayerStatistics& statistics)
+	{
+		stream << statistics.drawnEntityCount << "/" << statistics.consideredEntityCount << " drawn, "
+			<< statistics.culledEntityCount << " culled, "
+			<< statistics.drawCallCount << " draw calls, "
+			<< statistics.vertexCount << " vertices, "
+			<< statistics.textureSwitchCount << " texture switches, "
+			<< "sort " << statistics.sortTime.asMicroseconds() << " us";
+	};
+
+	stream << "Total: ";
+	writeCounters(renderStatistics);
+	stream << ", prepare " << renderStatistics.prepareTime.asMicroseconds() << " us"
+		<< ", submit " << renderStatistics.submitTime.asMicroseconds() << " us";
+
+	const char* layerNameList[] = { "Background", "Foreground", "Objects", "GUI" };
+	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
+	{
+		const auto it = renderStatistics.layerStatisticsDictionary.find(renderLayer);
+		if (it == renderStatistics.layerStatisticsDictionary.cend())
+			continue;
+
+		stream << "\n" << layerNameList[static_cast<size_t>(renderLayer)] << ": ";
+		writeCounters(it->second);
+	}
+
+	return stream;
 }
\ No newline at end of file
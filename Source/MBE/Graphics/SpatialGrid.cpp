@@ -0,0 +1,404 @@
+#include <MBE/Graphics/SpatialGrid.h>
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace mbe;
+
+template <class TFunction>
+void SpatialGrid::ForEachValueInCell(int x, int y, TFunction function)
+{
+	const auto it = cellDictionary.find(GetCellKey(x, y));
+	if (it == cellDictionary.cend())
+		return;
+
+	for (const auto valueId : it->second)
+	{
+		auto& entry = entryList[valueId];
+		if (entry.queryStamp == queryStamp)
+			continue;
+
+		entry.queryStamp = queryStamp;
+		function(valueId, entry);
+	}
+}
+
+template <class TFunction>
+void SpatialGrid::ForEachValue(const CellRange & cellRange, TFunction function)
+{
+	for (const auto valueId : largeValueIdList)
+	{
+		auto& entry = entryList[valueId];
+		entry.queryStamp = queryStamp;
+		function(valueId, entry);
+	}
+
+	// When zoomed out, iterating the occupied cells is faster than looking up every cell in the area
+	if (GetCellCount(cellRange) > cellDictionary.size())
+	{
+		for (const auto& pair : cellDictionary)
+		{
+			const int x = static_cast<int>(static_cast<unsigned int>(pair.first >> 32));
+			const int y = static_cast<int>(static_cast<unsigned int>(pair.first & 0xffffffff));
+			if (x < cellRange.left || x > cellRange.right || y < cellRange.top || y > cellRange.bottom)
+				continue;
+
+			ForEachValueInCell(x, y, function);
+		}
+		return;
+	}
+
+	for (int y = cellRange.top; y <= cellRange.bottom; y++)
+		for (int x = cellRange.left; x <= cellRange.right; x++)
+			ForEachValueInCell(x, y, function);
+}
+
+SpatialGrid::SpatialGrid(float cellSize, size_t maxCellCount) :
+	cellSize(cellSize),
+	maxCellCount(maxCellCount),
+	queryStamp(0)
+{
+	assert(cellSize > 0.f && "SpatialGrid: The cell size must be greater than 0");
+}
+
+void SpatialGrid::Insert(ValueID valueId, const sf::FloatRect & bounds)
+{
+	if (valueId >= entryList.size())
+		entryList.resize(valueId + 1);
+
+	auto& entry = entryList[valueId];
+	const auto cellRange = GetCellRange(bounds);
+	const bool large = GetCellCount(cellRange) > maxCellCount;
+	entry.bounds = bounds;
+
+	// Only move the value if the cells have changed
+	if (entry.inserted && entry.large == large)
+	{
+		if (large)
+			return;
+
+		const auto& oldRange = entry.cellRange;
+		if (oldRange.left == cellRange.left && oldRange.top == cellRange.top && oldRange.right == cellRange.right && oldRange.bottom == cellRange.bottom)
+			return;
+	}
+
+	if (entry.inserted)
+		Remove(valueId);
+
+	entry.inserted = true;
+	entry.large = large;
+	entry.cellRange = cellRange;
+
+	if (large)
+		largeValueIdList.push_back(valueId);
+	else
+		AddToCells(valueId, cellRange);
+}
+
+void SpatialGrid::Remove(ValueID valueId)
+{
+	if (Contains(valueId) == false)
+		return;
+
+	auto& entry = entryList[valueId];
+	if (entry.large)
+		largeValueIdList.erase(std::find(largeValueIdList.begin(), largeValueIdList.end(), valueId));
+	else
+		RemoveFromCells(valueId, entry.cellRange);
+
+	entry.inserted = false;
+}
+
+void SpatialGrid::Clear()
+{
+	entryList.clear();
+	cellDictionary.clear();
+	largeValueIdList.clear();
+}
+
+void SpatialGrid::Query(const sf::FloatRect & area, std::vector<ValueID> & resultList)
+{
+	queryStamp++;
+	ForEachValue(GetCellRange(area), [&area, &resultList](ValueID valueId, const Entry & entry)
+		{
+			if (Intersects(entry.bounds, area))
+				resultList.push_back(valueId);
+		});
+}
+
+void SpatialGrid::QueryRadius(const sf::Vector2f & center, float radius, std::vector<ValueID> & resultList)
+{
+	queryStamp++;
+	const sf::FloatRect area(center.x - radius, center.y - radius, 2.f * radius, 2.f * radius);
+	ForEachValue(GetCellRange(area), [&center, radius, &resultList](ValueID valueId, const Entry & entry)
+		{
+			if (GetDistance(entry.bounds, center) <= radius)
+				resultList.push_back(valueId);
+		});
+}
+
+void SpatialGrid::QueryNearest(const sf::Vector2f & point, size_t count, std::vector<ValueID> & resultList, const Filter & filter, float maxDistance)
+{
+	if (count == 0)
+		return;
+
+	queryStamp++;
+	candidateList.clear();
+
+	const auto addCandidate = [this, &point, &filter, maxDistance](ValueID valueId, const Entry & entry)
+	{
+		if (filter && filter(valueId) == false)
+			return;
+
+		const float distance = GetDistance(entry.bounds, point);
+		if (distance <= maxDistance)
+			candidateList.emplace_back(distance, valueId);
+	};
+
+	for (const auto valueId : largeValueIdList)
+	{
+		auto& entry = entryList[valueId];
+		entry.queryStamp = queryStamp;
+		addCandidate(valueId, entry);
+	}
+
+	const int centerX = static_cast<int>(std::floor(point.x / cellSize));
+	const int centerY = static_cast<int>(std::floor(point.y / cellSize));
+
+	for (int ring = 0; ; ring++)
+	{
+		// Once a ring has more cells than are occupied, iterating the occupied cells is faster
+		// Values that have already been found are skipped
+		const size_t ringCellCount = ring == 0 ? 1u : 8u * static_cast<size_t>(ring);
+		if (ringCellCount > cellDictionary.size())
+		{
+			for (const auto& pair : cellDictionary)
+			{
+				const int x = static_cast<int>(static_cast<unsigned int>(pair.first >> 32));
+				const int y = static_cast<int>(static_cast<unsigned int>(pair.first & 0xffffffff));
+				ForEachValueInCell(x, y, addCandidate);
+			}
+			break;
+		}
+
+		for (int y = centerY - ring; y <= centerY + ring; y++)
+		{
+			// Only the top and bottom row of a ring are complete
+			const bool edgeRow = y == centerY - ring || y == centerY + ring;
+			const int step = edgeRow ? 1 : 2 * ring;
+			for (int x = centerX - ring; x <= centerX + ring; x += step)
+				ForEachValueInCell(x, y, addCandidate);
+		}
+
+		// The values that have not been visited lie entirely outside of the searched square
+		const float minDistance = std::min(
+			std::min(point.x - static_cast<float>(centerX - ring) * cellSize, static_cast<float>(centerX + ring + 1) * cellSize - point.x),
+			std::min(point.y - static_cast<float>(centerY - ring) * cellSize, static_cast<float>(centerY + ring + 1) * cellSize - point.y));
+
+		if (minDistance > maxDistance)
+			break;
+
+		if (candidateList.size() >= count)
+		{
+			std::nth_element(candidateList.begin(), candidateList.begin() + (count - 1), candidateList.end());
+			if (candidateList[count - 1].first <= minDistance)
+				break;
+		}
+	}
+
+	const size_t resultCount = std::min(count, candidateList.size());
+	std::partial_sort(candidateList.begin(), candidateList.begin() + resultCount, candidateList.end());
+	for (size_t i = 0; i < resultCount; i++)
+		resultList.push_back(candidateList[i].second);
+}
+
+void SpatialGrid::QueryRay(const sf::Vector2f & origin, const sf::Vector2f & direction, float maxDistance, std::vector<ValueID> & resultList, float radius)
+{
+	const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	assert(length > 0.f && "SpatialGrid: The ray direction must not be zero");
+	assert(std::isfinite(maxDistance) && maxDistance >= 0.f && "SpatialGrid: The ray length must be finite");
+
+	const sf::Vector2f normalisedDirection = direction / length;
+
+	queryStamp++;
+	candidateList.clear();
+
+	const auto addCandidate = [this, &origin, &normalisedDirection, maxDistance, radius](ValueID valueId, const Entry & entry)
+	{
+		const sf::FloatRect bounds(entry.bounds.left - radius, entry.bounds.top - radius, entry.bounds.width + 2.f * radius, entry.bounds.height + 2.f * radius);
+
+		float distance;
+		if (IntersectsRay(bounds, origin, normalisedDirection, distance) && distance <= maxDistance)
+			candidateList.emplace_back(distance, valueId);
+	};
+
+	for (const auto valueId : largeValueIdList)
+	{
+		auto& entry = entryList[valueId];
+		entry.queryStamp = queryStamp;
+		addCandidate(valueId, entry);
+	}
+
+	// Cells further away from the ray than the extent can not contain a value within the radius
+	const int extent = static_cast<int>(std::ceil(radius / cellSize));
+	const size_t stepCount = 2u * static_cast<size_t>(maxDistance / cellSize) + 2u;
+	const size_t blockCellCount = static_cast<size_t>(2 * extent + 1) * static_cast<size_t>(2 * extent + 1);
+
+	if (stepCount * blockCellCount > cellDictionary.size())
+	{
+		// Iterating the occupied cells is faster than walking along the ray
+		for (const auto& pair : cellDictionary)
+		{
+			const int x = static_cast<int>(static_cast<unsigned int>(pair.first >> 32));
+			const int y = static_cast<int>(static_cast<unsigned int>(pair.first & 0xffffffff));
+			ForEachValueInCell(x, y, addCandidate);
+		}
+	}
+	else
+	{
+		// Walk along the cells the ray passes through (Amanatides and Woo)
+		int x = static_cast<int>(std::floor(origin.x / cellSize));
+		int y = static_cast<int>(std::floor(origin.y / cellSize));
+		const int stepX = normalisedDirection.x > 0.f ? 1 : (normalisedDirection.x < 0.f ? -1 : 0);
+		const int stepY = normalisedDirection.y > 0.f ? 1 : (normalisedDirection.y < 0.f ? -1 : 0);
+
+		const float infinity = std::numeric_limits<float>::infinity();
+		float nextX = stepX == 0 ? infinity : (static_cast<float>(x + (stepX > 0 ? 1 : 0)) * cellSize - origin.x) / normalisedDirection.x;
+		float nextY = stepY == 0 ? infinity : (static_cast<float>(y + (stepY > 0 ? 1 : 0)) * cellSize - origin.y) / normalisedDirection.y;
+		const float deltaX = stepX == 0 ? infinity : cellSize / std::abs(normalisedDirection.x);
+		const float deltaY = stepY == 0 ? infinity : cellSize / std::abs(normalisedDirection.y);
+
+		while (true)
+		{
+			const auto cellRange = GetCellRange(x, y, extent);
+			for (int cellY = cellRange.top; cellY <= cellRange.bottom; cellY++)
+				for (int cellX = cellRange.left; cellX <= cellRange.right; cellX++)
+					ForEachValueInCell(cellX, cellY, addCandidate);
+
+			if (nextX > maxDistance && nextY > maxDistance)
+				break;
+
+			if (nextX < nextY)
+			{
+				x += stepX;
+				nextX += deltaX;
+			}
+			else
+			{
+				y += stepY;
+				nextY += deltaY;
+			}
+		}
+	}
+
+	std::sort(candidateList.begin(), candidateList.end());
+	for (const auto& candidate : candidateList)
+		resultList.push_back(candidate.second);
+}
+
+bool SpatialGrid::Contains(ValueID valueId) const
+{
+	return valueId < entryList.size() && entryList[valueId].inserted;
+}
+
+SpatialGrid::CellRange SpatialGrid::GetCellRange(const sf::FloatRect & bounds) const
+{
+	CellRange cellRange;
+	cellRange.left = static_cast<int>(std::floor(bounds.left / cellSize));
+	cellRange.top = static_cast<int>(std::floor(bounds.top / cellSize));
+	cellRange.right = static_cast<int>(std::floor((bounds.left + bounds.width) / cellSize));
+	cellRange.bottom = static_cast<int>(std::floor((bounds.top + bounds.height) / cellSize));
+	return cellRange;
+}
+
+SpatialGrid::CellRange SpatialGrid::GetCellRange(int x, int y, int extent) const
+{
+	CellRange cellRange;
+	cellRange.left = x - extent;
+	cellRange.top = y - extent;
+	cellRange.right = x + extent;
+	cellRange.bottom = y + extent;
+	return cellRange;
+}
+
+void SpatialGrid::AddToCells(ValueID valueId, const CellRange & cellRange)
+{
+	for (int y = cellRange.top; y <= cellRange.bottom; y++)
+		for (int x = cellRange.left; x <= cellRange.right; x++)
+			cellDictionary[GetCellKey(x, y)].push_back(valueId);
+}
+
+void SpatialGrid::RemoveFromCells(ValueID valueId, const CellRange & cellRange)
+{
+	for (int y = cellRange.top; y <= cellRange.bottom; y++)
+	{
+		for (int x = cellRange.left; x <= cellRange.right; x++)
+		{
+			const auto it = cellDictionary.find(GetCellKey(x, y));
+			assert(it != cellDictionary.end() && "SpatialGrid: The value must be stored in the cell");
+
+			// The order within a cell does not matter, so swap and pop
+			auto& cell = it->second;
+			auto valueIt = std::find(cell.begin(), cell.end(), valueId);
+			*valueIt = cell.back();
+			cell.pop_back();
+
+			// Free empty cells so that the occupied cells can be iterated quickly
+			if (cell.empty())
+				cellDictionary.erase(it);
+		}
+	}
+}
+
+SpatialGrid::CellKey SpatialGrid::GetCellKey(int x, int y)
+{
+	return (static_cast<CellKey>(static_cast<unsigned int>(x)) << 32) | static_cast<CellKey>(static_cast<unsigned int>(y));
+}
+
+size_t SpatialGrid::GetCellCount(const CellRange & cellRange)
+{
+	return static_cast<size_t>(cellRange.right - cellRange.left + 1) * static_cast<size_t>(cellRange.bottom - cellRange.top + 1);
+}
+
+bool SpatialGrid::Intersects(const sf::FloatRect & a, const sf::FloatRect & b)
+{
+	return a.left <= b.left + b.width && b.left <= a.left + a.width
+		&& a.top <= b.top + b.height && b.top <= a.top + a.height;
+}
+
+float SpatialGrid::GetDistance(const sf::FloatRect & bounds, const sf::Vector2f & point)
+{
+	const float distanceX = std::max(std::max(bounds.left - point.x, point.x - (bounds.left + bounds.width)), 0.f);
+	const float distanceY = std::max(std::max(bounds.top - point.y, point.y - (bounds.top + bounds.height)), 0.f);
+	return std::sqrt(distanceX * distanceX + distanceY * distanceY);
+}
+
+bool SpatialGrid::IntersectsRay(const sf::FloatRect & bounds, const sf::Vector2f & origin, const sf::Vector2f & direction, float & distance)
+{
+	// Slab test: Clip the ray against the horizontal and vertical extent of the bounds
+	float entryDistance = 0.f;
+	float exitDistance = std::numeric_limits<float>::infinity();
+
+	const auto clip = [&entryDistance, &exitDistance](float origin, float direction, float min, float max)
+	{
+		if (direction == 0.f)
+			return origin >= min && origin <= max;
+
+		float nearDistance = (min - origin) / direction;
+		float farDistance = (max - origin) / direction;
+		if (nearDistance > farDistance)
+			std::swap(nearDistance, farDistance);
+
+		entryDistance = std::max(entryDistance, nearDistance);
+		exitDistance = std::min(exitDistance, farDistance);
+		return entryDistance <= exitDistance;
+	};
+
+	if (clip(origin.x, direction.x, bounds.left, bounds.left + bounds.width) == false
+		|| clip(origin.y, direction.y, bounds.top, bounds.top + bounds.height) == false)
+		return false;
+
+	distance = entryDistance;
+	return true;
+}
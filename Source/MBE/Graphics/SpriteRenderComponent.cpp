@@ -16,7 +16,60 @@ void SpriteRenderComponent::Draw(sf::RenderTarget& target) const
 	target.draw(sprite, transform);
 }
 
+bool SpriteRenderComponent::AppendToCommandList(RenderCommandList& commandList) const
+{
+	commandList.AddSprite(sprite, transform);
+	return true;
+}
+
 sf::FloatRect SpriteRenderComponent::GetLocalBounds() const
 {
 	return sprite.getLocalBounds();
 }
+
+sf::FloatRect SpriteRenderComponent::GetGlobalBounds() const
+{
+	return transform.transformRect(sprite.getLocalBounds());
+}
+
+bool SpriteRenderComponent::IsRevisionTracked() const
+{
+	return true;
+}
+
+void SpriteRenderComponent::SetColor(const sf::Color& color)
+{
+	if (sprite.getColor() == color)
+		return;
+
+	sprite.setColor(color);
+	IncrementRevision();
+}
+
+void SpriteRenderComponent::SetTexture(const sf::Texture& texture, bool resetRect)
+{
+	if (sprite.getTexture() == &texture && resetRect == false)
+		return;
+
+	sprite.setTexture(texture, resetRect);
+	IncrementRevision();
+}
+
+void SpriteRenderComponent::SetTextureRect(const sf::IntRect& textureRect)
+{
+	if (sprite.getTextureRect() == textureRect)
+		return;
+
+	sprite.setTextureRect(textureRect);
+	IncrementRevision();
+}
+
+void SpriteRenderComponent::SetTransform(const sf::Transform& transform)
+{
+	// This is called every frame by the mbe::SpriteRenderSystem, so only changes must increment the revision
+	if (AreTransformsEqual(this->transform, transform))
+		return;
+
+	this->transform = transform;
+	IncrementRevision();
+}
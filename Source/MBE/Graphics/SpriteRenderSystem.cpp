@@ -2,44 +2,53 @@
 
 using namespace mbe;
 using mbe::event::EntityCreatedEvent;
+using TransformChangedEvent = mbe::event::ComponentValueChangedEvent<TransformComponent>;
+using TextureWrapperChangedEvent = mbe::event::ComponentValueChangedEvent<TextureWrapperComponent>;
 
 SpriteRenderSystem::SpriteRenderSystem(EventManager& eventManager, const EntityManager& entityManager) :
 	BaseComponentRenderSystem(entityManager),
-	eventManager(eventManager)
+	eventManager(eventManager),
+	updatedSpriteCount(0)
 {
 	entityCreatedSubscription = eventManager.Subscribe(EventManager::TCallback<EntityCreatedEvent>([this](const EntityCreatedEvent& event)
 		{
 			OnEntityCreatedEvent(*event.GetEntityID());
 		}));
+
+	transformChangedSubscription = eventManager.Subscribe(EventManager::TCallback<TransformChangedEvent>([this](const TransformChangedEvent& event)
+		{
+			MarkDirty(event.GetComponent().GetParentEntity());
+		}));
+
+	// The texture wrapper, texture rect and active texture affect the sprite
+	textureWrapperChangedSubscription = eventManager.Subscribe(EventManager::TCallback<TextureWrapperChangedEvent>([this](const TextureWrapperChangedEvent& event)
+		{
+			MarkDirty(event.GetComponent().GetParentEntity());
+		}));
 }
 
 SpriteRenderSystem::~SpriteRenderSystem()
 {
 	eventManager.UnSubscribe<EntityCreatedEvent>(entityCreatedSubscription);
+	eventManager.UnSubscribe<TransformChangedEvent>(transformChangedSubscription);
+	eventManager.UnSubscribe<TextureWrapperChangedEvent>(textureWrapperChangedSubscription);
 }
 
 void SpriteRenderSystem::Update()
 {
-	auto& spriteEntityIdList = entityManager.GetComponentGroup<SpriteRenderComponent>();
+	updatedSpriteCount = 0;
 
-	for (auto& entityId : spriteEntityIdList)
+	for (const auto& entityId : dirtyEntityIdSet)
 	{
-		auto& renderComponent = entityId->GetComponent<SpriteRenderComponent>();
-
-		// Set the sprite texture and texture rect if the entity has a mbe::TextureWrapperComponent
-		// This effects the size of the sprite as well hence it should be updated outside of the draw method
-		if (entityId->HasComponent<TextureWrapperComponent>())
-		{
-			renderComponent.SetTexture(entityId->GetComponent<TextureWrapperComponent>().GetTextureWrapper().GetTexture());
-			renderComponent.SetTextureRect(entityId->GetComponent<TextureWrapperComponent>().GetTextureRect());
-		}
+		// The entity may have been deleted since it has been marked
+		if (entityId.Valid() == false)
+			continue;
 
-		// Set the sprite position if the entity has a mbe::TransformComponent
-		auto transform = sf::Transform::Identity;
-		if (entityId->HasComponent<TransformComponent>())
-			transform = entityId->GetComponent<TransformComponent>().GetWorldTransform();
-		renderComponent.SetTransform(transform);
+		UpdateSprite(*entityId);
+		updatedSpriteCount++;
 	}
+
+	dirtyEntityIdSet.clear();
 }
 
 void SpriteRenderSystem::OnEntityCreatedEvent(Entity& entity)
@@ -47,6 +56,17 @@ void SpriteRenderSystem::OnEntityCreatedEvent(Entity& entity)
 	if (!entity.HasComponent<mbe::SpriteRenderComponent>())
 		return;
 
+	UpdateSprite(entity);
+}
+
+void SpriteRenderSystem::MarkDirty(Entity& entity)
+{
+	if (entity.HasComponent<SpriteRenderComponent>())
+		dirtyEntityIdSet.insert(entity.GetHandleID());
+}
+
+void SpriteRenderSystem::UpdateSprite(Entity& entity)
+{
 	auto& renderComponent = entity.GetComponent<SpriteRenderComponent>();
 
 	// Set the sprite texture and texture rect if the entity has a mbe::TextureWrapperComponent
@@ -54,7 +74,7 @@ void SpriteRenderSystem::OnEntityCreatedEvent(Entity& entity)
 	if (entity.HasComponent<TextureWrapperComponent>())
 	{
 		renderComponent.SetTexture(entity.GetComponent<TextureWrapperComponent>().GetTextureWrapper().GetTexture());
-		renderComponent.SetTextureRect(entity.GetComponent<TextureWrapperComponent>().GetTextureRect());
+		renderComponent.SetTextureRect(entity.GetComponent<TextureWrapperComponent>().GetAtlasTextureRect());
 	}
 
 	// Set the sprite position if the entity has a mbe::TransformComponent
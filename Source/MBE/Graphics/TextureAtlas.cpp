@@ -0,0 +1,280 @@
+#include <MBE/Graphics/TextureAtlas.h>
+
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace mbe;
+
+TextureAtlas::TextureAtlas(unsigned int maxPageSize) :
+	maxPageSize(std::min(maxPageSize, sf::Texture::getMaximumSize())),
+	loadedFromCache(false)
+{
+}
+
+void TextureAtlas::AddImage(const std::string & filePath)
+{
+	if (pageList.empty() == false)
+		throw std::runtime_error("TextureAtlas: Images can not be added after the atlas has been packed");
+
+	if (entryIndexDictionary.find(filePath) != entryIndexDictionary.cend())
+		return;
+
+	Entry entry;
+	entry.filePath = filePath;
+	if (entry.image.loadFromFile(filePath) == false)
+		throw std::runtime_error("TextureAtlas: Failed to load: " + filePath);
+
+	entryIndexDictionary.insert({ filePath, entryList.size() });
+	entryList.push_back(std::move(entry));
+}
+
+void TextureAtlas::Pack(const std::string & cacheFilePath)
+{
+	loadedFromCache = LoadLayout(cacheFilePath);
+	if (loadedFromCache == false)
+	{
+		PackShelves();
+		StoreLayout(cacheFilePath);
+	}
+
+	CreatePages();
+}
+
+bool TextureAtlas::Contains(const std::string & filePath) const
+{
+	const auto it = entryIndexDictionary.find(filePath);
+	return it != entryIndexDictionary.cend() && entryList[it->second].packed && pageList.empty() == false;
+}
+
+const TextureAtlas::Region & TextureAtlas::GetRegion(const std::string & filePath) const
+{
+	if (Contains(filePath) == false)
+		throw std::runtime_error("TextureAtlas: The image has not been packed: " + filePath);
+
+	return GetEntry(filePath).region;
+}
+
+const sf::Image & TextureAtlas::GetImage(const std::string & filePath) const
+{
+	return GetEntry(filePath).image;
+}
+
+std::shared_ptr<sf::Texture> TextureAtlas::GetPage(size_t pageIndex) const
+{
+	return pageList.at(pageIndex);
+}
+
+bool TextureAtlas::LoadLayout(const std::string & cacheFilePath)
+{
+	std::ifstream file(cacheFilePath);
+	if (file.is_open() == false)
+		return false;
+
+	// The header must match the current settings
+	std::string magic;
+	unsigned int version, cachedMaxPageSize, padding;
+	if (!(file >> magic >> version >> cachedMaxPageSize >> padding)
+		|| magic != "MBE_TEXTURE_ATLAS"
+		|| version != detail::TEXTURE_ATLAS_CACHE_VERSION
+		|| cachedMaxPageSize != maxPageSize
+		|| padding != detail::TEXTURE_ATLAS_PADDING)
+		return false;
+
+	size_t pageCount;
+	if (!(file >> pageCount))
+		return false;
+
+	std::vector<sf::Vector2u> cachedPageSizeList(pageCount);
+	for (auto& pageSize : cachedPageSizeList)
+	{
+		if (!(file >> pageSize.x >> pageSize.y))
+			return false;
+	}
+
+	// The cache must contain exactly the added images
+	size_t entryCount;
+	if (!(file >> entryCount) || entryCount != entryList.size())
+		return false;
+
+	std::vector<bool> matchedList(entryList.size(), false);
+	std::vector<std::pair<Region, bool>> regionList(entryList.size());
+	for (size_t i = 0; i < entryCount; i++)
+	{
+		int packed;
+		Region region;
+		std::string filePath;
+		if (!(file >> packed >> region.pageIndex >> region.textureRect.left >> region.textureRect.top >> region.textureRect.width >> region.textureRect.height))
+			return false;
+
+		// The file path is the rest of the line (it may contain spaces)
+		file.get();
+		if (!std::getline(file, filePath))
+			return false;
+
+		const auto it = entryIndexDictionary.find(filePath);
+		if (it == entryIndexDictionary.cend() || matchedList[it->second])
+			return false;
+
+		// An image whose size has changed must be packed again
+		const auto& entry = entryList[it->second];
+		if (static_cast<int>(entry.image.getSize().x) != region.textureRect.width || static_cast<int>(entry.image.getSize().y) != region.textureRect.height)
+			return false;
+
+		if (packed != 0 && region.pageIndex >= pageCount)
+			return false;
+
+		matchedList[it->second] = true;
+		regionList[it->second] = { region, packed != 0 };
+	}
+
+	for (size_t i = 0; i < entryList.size(); i++)
+	{
+		entryList[i].region = regionList[i].first;
+		entryList[i].packed = regionList[i].second;
+	}
+	pageSizeList = std::move(cachedPageSizeList);
+
+	return true;
+}
+
+void TextureAtlas::StoreLayout(const std::string & cacheFilePath) const
+{
+	std::ofstream file(cacheFilePath, std::ios::trunc);
+	if (file.is_open() == false)
+		return;
+
+	file << "MBE_TEXTURE_ATLAS " << detail::TEXTURE_ATLAS_CACHE_VERSION << ' ' << maxPageSize << ' ' << detail::TEXTURE_ATLAS_PADDING << '\n';
+
+	file << pageSizeList.size() << '\n';
+	for (const auto& pageSize : pageSizeList)
+		file << pageSize.x << ' ' << pageSize.y << '\n';
+
+	file << entryList.size() << '\n';
+	for (const auto& entry : entryList)
+	{
+		// Unpacked images are stored as well so that the cache matches the added images
+		const auto& textureRect = entry.region.textureRect;
+		file << (entry.packed ? 1 : 0) << ' ' << entry.region.pageIndex << ' '
+			<< textureRect.left << ' ' << textureRect.top << ' ' << textureRect.width << ' ' << textureRect.height << ' '
+			<< entry.filePath << '\n';
+	}
+}
+
+void TextureAtlas::PackShelves()
+{
+	struct Shelf
+	{
+		unsigned int top;
+		unsigned int height;
+		// The x position of the next image on this shelf
+		unsigned int right;
+	};
+
+	struct Page
+	{
+		std::vector<Shelf> shelfList;
+		// The y position of the next shelf
+		unsigned int bottom = 0;
+		sf::Vector2u size;
+	};
+
+	std::vector<Page> packedPageList;
+	const unsigned int padding = detail::TEXTURE_ATLAS_PADDING;
+
+	// Packing the tallest images first keeps the wasted space on each shelf small
+	std::vector<size_t> entryIndexList(entryList.size());
+	std::iota(entryIndexList.begin(), entryIndexList.end(), 0);
+	std::stable_sort(entryIndexList.begin(), entryIndexList.end(), [this](size_t a, size_t b)
+		{
+			const auto sizeA = entryList[a].image.getSize();
+			const auto sizeB = entryList[b].image.getSize();
+			return sizeA.y > sizeB.y || (sizeA.y == sizeB.y && sizeA.x > sizeB.x);
+		});
+
+	for (const auto entryIndex : entryIndexList)
+	{
+		auto& entry = entryList[entryIndex];
+		const auto size = entry.image.getSize();
+		entry.region = { 0, { 0, 0, static_cast<int>(size.x), static_cast<int>(size.y) } };
+		entry.packed = false;
+
+		// Images that do not fit on a page are loaded as separate textures
+		if (size.x == 0 || size.y == 0 || size.x > maxPageSize || size.y > maxPageSize)
+			continue;
+
+		for (size_t pageIndex = 0; pageIndex <= packedPageList.size() && entry.packed == false; pageIndex++)
+		{
+			if (pageIndex == packedPageList.size())
+				packedPageList.emplace_back();
+
+			auto& page = packedPageList[pageIndex];
+
+			// Find a shelf with enough space left or open a new one
+			auto shelfIt = std::find_if(page.shelfList.begin(), page.shelfList.end(), [&](const Shelf& shelf)
+				{
+					return size.y <= shelf.height && shelf.right + size.x <= maxPageSize;
+				});
+
+			if (shelfIt == page.shelfList.end())
+			{
+				if (page.bottom + size.y > maxPageSize)
+					continue;
+
+				page.shelfList.push_back({ page.bottom, size.y, 0 });
+				page.bottom += size.y + padding;
+				shelfIt = page.shelfList.end() - 1;
+			}
+
+			entry.region.pageIndex = pageIndex;
+			entry.region.textureRect.left = static_cast<int>(shelfIt->right);
+			entry.region.textureRect.top = static_cast<int>(shelfIt->top);
+			entry.packed = true;
+
+			page.size.x = std::max(page.size.x, shelfIt->right + size.x);
+			page.size.y = std::max(page.size.y, shelfIt->top + size.y);
+			shelfIt->right += size.x + padding;
+		}
+	}
+
+	pageSizeList.clear();
+	for (const auto& page : packedPageList)
+		pageSizeList.push_back(page.size);
+}
+
+void TextureAtlas::CreatePages()
+{
+	// Compose the pages in memory so that the padding between the images is transparent
+	std::vector<sf::Image> pageImageList(pageSizeList.size());
+	for (size_t pageIndex = 0; pageIndex < pageSizeList.size(); pageIndex++)
+		pageImageList[pageIndex].create(pageSizeList[pageIndex].x, pageSizeList[pageIndex].y, sf::Color::Transparent);
+
+	for (const auto& entry : entryList)
+	{
+		if (entry.packed == false)
+			continue;
+
+		const auto& textureRect = entry.region.textureRect;
+		pageImageList[entry.region.pageIndex].copy(entry.image, static_cast<unsigned int>(textureRect.left), static_cast<unsigned int>(textureRect.top));
+	}
+
+	pageList.clear();
+	for (const auto& pageImage : pageImageList)
+	{
+		auto texture = std::make_shared<sf::Texture>();
+		if (texture->loadFromImage(pageImage) == false)
+			throw std::runtime_error("TextureAtlas: Failed to create a page texture");
+
+		pageList.push_back(std::move(texture));
+	}
+}
+
+const TextureAtlas::Entry & TextureAtlas::GetEntry(const std::string & filePath) const
+{
+	const auto it = entryIndexDictionary.find(filePath);
+	if (it == entryIndexDictionary.cend())
+		throw std::runtime_error("TextureAtlas: The image has not been added: " + filePath);
+
+	return entryList[it->second];
+}
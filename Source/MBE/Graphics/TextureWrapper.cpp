@@ -8,9 +8,35 @@ bool TextureWrapper::loadFromFile(std::string filePath, bool createPixelMask)
 	if (!texture->loadFromFile(filePath))
 		return false;
 
+	// The texture covers the entire image
+	atlasRect = { 0, 0, static_cast<int>(texture->getSize().x), static_cast<int>(texture->getSize().y) };
+	inAtlas = false;
 
 	if (createPixelMask)
 		pixelMask = std::make_shared<PixelMask>(*texture);
 
 	return true;
+}
+
+bool TextureWrapper::loadFromFile(std::string filePath, const TextureAtlas & textureAtlas, bool createPixelMask)
+{
+	// Images that are too large for a page are not packed
+	if (textureAtlas.Contains(filePath) == false)
+		return loadFromFile(filePath, createPixelMask);
+
+	const auto& region = textureAtlas.GetRegion(filePath);
+	texture = textureAtlas.GetPage(region.pageIndex);
+	atlasRect = region.textureRect;
+	inAtlas = true;
+
+	// Create the pixel mask from the original image rather than the atlas page
+	if (createPixelMask)
+		pixelMask = std::make_shared<PixelMask>(textureAtlas.GetImage(filePath));
+
+	return true;
+}
+
+sf::IntRect TextureWrapper::MapTextureRect(const sf::IntRect & textureRect) const
+{
+	return { textureRect.left + atlasRect.left, textureRect.top + atlasRect.top, textureRect.width, textureRect.height };
 }
\ No newline at end of file
@@ -48,7 +48,7 @@ void TextureWrapperComponent::SetTextureWrapper(const std::string& textureWrappe
 
 	// Recompute the texture rect if required
 	if (resetTextureRect)
-		texture.textureRect = { {0, 0}, {static_cast<sf::Vector2i>(texture.textureWrapper->GetTexture().getSize())} };
+		texture.textureRect = { {0, 0}, {static_cast<sf::Vector2i>(texture.textureWrapper->GetSize())} };
 }
 
 void TextureWrapperComponent::SetTextureWrapper(const std::string& textureWrapperId, bool resetTextureRect)
@@ -65,8 +65,9 @@ void TextureWrapperComponent::SetTextureRect(const sf::IntRect& textureRect, Tex
 		return;
 
 	// Make sure that the texture rect is not bigger than the current texture
-	if (textureRect.left + textureRect.width > texture.textureWrapper->GetTexture().getSize().x
-		|| textureRect.top + textureRect.height > texture.textureWrapper->GetTexture().getSize().y)
+	// The texture rect is in the space of the original image (even if the texture is part of an atlas)
+	if (textureRect.left + textureRect.width > texture.textureWrapper->GetSize().x
+		|| textureRect.top + textureRect.height > texture.textureWrapper->GetSize().y)
 		throw std::runtime_error("TextureWrapperComponent: The texture rect must lie within the current texture");
 
 	// Assign the new texture rect
@@ -89,8 +90,9 @@ void TextureWrapperComponent::SetTextureRect(sf::IntRect&& textureRect, TextureI
 		return;
 
 	// Make sure that the texture rect is not bigger than the current texture
-	if (textureRect.left + textureRect.width > texture.textureWrapper->GetTexture().getSize().x
-		|| textureRect.top + textureRect.height > texture.textureWrapper->GetTexture().getSize().y)
+	// The texture rect is in the space of the original image (even if the texture is part of an atlas)
+	if (textureRect.left + textureRect.width > texture.textureWrapper->GetSize().x
+		|| textureRect.top + textureRect.height > texture.textureWrapper->GetSize().y)
 		throw std::runtime_error("TextureWrapperComponent: The texture rect must lie within the current texture");
 
 	// Assign the new texture rect
@@ -143,6 +145,16 @@ const sf::IntRect& TextureWrapperComponent::GetTextureRect() const
 	return GetTextureRect(currentTextureId);
 }
 
+sf::IntRect TextureWrapperComponent::GetAtlasTextureRect(TextureID textureId) const
+{
+	return GetTextureWrapper(textureId).MapTextureRect(GetTextureRect(textureId));
+}
+
+sf::IntRect TextureWrapperComponent::GetAtlasTextureRect() const
+{
+	return GetAtlasTextureRect(currentTextureId);
+}
+
 TextureID TextureWrapperComponent::GetActiveTextureId() const
 {
 	return currentTextureId;
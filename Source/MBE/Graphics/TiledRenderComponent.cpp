@@ -1,5 +1,8 @@
 #include <MBE/Graphics/TiledRenderComponent.h>
 
+#include <cmath>
+#include <algorithm>
+
 using namespace mbe;
 
 MBE_ENABLE_COMPONENT_POLYMORPHISM(TiledRenderComponent, RenderComponent)
@@ -10,16 +13,76 @@ TiledRenderComponent::TiledRenderComponent(EventManager& eventManager, Entity& p
 	tileSize(tileSize),
 	isCreated(false)
 {
+	const unsigned int chunkSize = detail::TILE_CHUNK_SIZE;
+	chunkCount = { (size.x + chunkSize - 1u) / chunkSize, (size.y + chunkSize - 1u) / chunkSize };
 
+	// The chunks are stored row by row
+	chunkList.resize(chunkCount.x * chunkCount.y);
+	for (unsigned int y = 0; y < chunkCount.y; y++)
+	{
+		for (unsigned int x = 0; x < chunkCount.x; x++)
+		{
+			auto& chunk = chunkList[x + y * chunkCount.x];
+			chunk.tileOffset = { x * chunkSize, y * chunkSize };
+			chunk.tileCount = { std::min(chunkSize, size.x - chunk.tileOffset.x), std::min(chunkSize, size.y - chunk.tileOffset.y) };
+			chunk.vertices.setPrimitiveType(sf::Quads);
+			chunk.vertices.resize(chunk.tileCount.x * chunk.tileCount.y * 4); // The 4 because of the quads
+		}
+	}
 }
 
 void TiledRenderComponent::Draw(sf::RenderTarget& target) const
 {
 	// Only draw the vertices if the tiled terrain layer has been created
-	if (this->IsCreated() == false)
+	if (this->IsCreated() == false || chunkList.empty())
+		return;
+
+	// The view rectangle in the local coordinates of this layer (this accounts for view rotation)
+	const auto viewRect = target.getView().getInverseTransform().transformRect({ -1.f, -1.f, 2.f, 2.f });
+	const auto localViewRect = renderStates.transform.getInverse().transformRect(viewRect);
+
+	// Find the range of chunks that intersect the view
+	const sf::Vector2f chunkPixelSize(static_cast<float>(detail::TILE_CHUNK_SIZE * tileSize.x), static_cast<float>(detail::TILE_CHUNK_SIZE * tileSize.y));
+	const auto clampChunk = [](float value, unsigned int count)
+	{
+		return static_cast<unsigned int>(std::max(0.f, std::min(value, static_cast<float>(count - 1u))));
+	};
+
+	const unsigned int left = clampChunk(std::floor(localViewRect.left / chunkPixelSize.x), chunkCount.x);
+	const unsigned int top = clampChunk(std::floor(localViewRect.top / chunkPixelSize.y), chunkCount.y);
+	const unsigned int right = clampChunk(std::floor((localViewRect.left + localViewRect.width) / chunkPixelSize.x), chunkCount.x);
+	const unsigned int bottom = clampChunk(std::floor((localViewRect.top + localViewRect.height) / chunkPixelSize.y), chunkCount.y);
+
+	for (unsigned int y = top; y <= bottom; y++)
+	{
+		for (unsigned int x = left; x <= right; x++)
+		{
+			const auto& chunk = chunkList[x + y * chunkCount.x];
+			if (GetChunkLocalBounds(x + y * chunkCount.x).intersects(localViewRect))
+				target.draw(chunk.vertices, renderStates);
+		}
+	}
+}
+
+sf::FloatRect TiledRenderComponent::GetGlobalBounds() const
+{
+	return renderStates.transform.transformRect(this->GetLocalBounds());
+}
+
+bool TiledRenderComponent::IsRevisionTracked() const
+{
+	return true;
+}
+
+void TiledRenderComponent::SetRenderStates(const sf::RenderStates& states)
+{
+	// This is called every frame by the mbe::TiledTerrainLayerRenderSystem, so only changes must increment the revision
+	if (AreTransformsEqual(renderStates.transform, states.transform) && renderStates.texture == states.texture
+		&& renderStates.shader == states.shader && renderStates.blendMode == states.blendMode)
 		return;
 
-	target.draw(vertices, renderStates);
+	renderStates = states;
+	IncrementRevision();
 }
 
 sf::FloatRect TiledRenderComponent::GetLocalBounds() const
@@ -32,51 +95,63 @@ sf::FloatRect TiledRenderComponent::GetLocalBounds() const
 	return rect;
 }
 
-void TiledRenderComponent::Create(std::vector<size_t> tileIndexList)
+sf::FloatRect TiledRenderComponent::GetChunkLocalBounds(size_t chunkIndex) const
 {
-	sf::Clock clock;
-	clock.restart();
+	const auto& chunk = chunkList[chunkIndex];
+
+	sf::FloatRect rect;
+	rect.left = static_cast<float>(chunk.tileOffset.x * tileSize.x);
+	rect.top = static_cast<float>(chunk.tileOffset.y * tileSize.y);
+	rect.width = static_cast<float>(chunk.tileCount.x * tileSize.x);
+	rect.height = static_cast<float>(chunk.tileCount.y * tileSize.y);
 
+	return rect;
+}
+
+void TiledRenderComponent::Create(const std::vector<size_t>& tileIndexList, ThreadPool* threadPool)
+{
 	// Check whether the tileList has enough items for the size of the tile map layer
 	assert(tileIndexList.size() == size.x * size.y && "The length of the tile list does not match the number of tiles required to create this layer");
 
-	// resize the vertex array to fit the tileMapSize
-	vertices.setPrimitiveType(sf::Quads);
-	vertices.resize(size.x * size.y * 4); // The 4 because of the quads
+	const unsigned int tilesetColumnCount = GetTilesetColumnCount();
 
-										  // Populate the vertex array with one quad per tile
-	for (size_t i = 0; i < size.x; i++)
+	// Populate the vertex arrays with one quad per tile
+	// Every chunk has its own vertex array, so different chunks can be created concurrently
+	const auto createChunks = [this, &tileIndexList, tilesetColumnCount](size_t begin, size_t end)
 	{
-		for (size_t j = 0; j < size.y; j++)
+		for (size_t chunkIndex = begin; chunkIndex < end; chunkIndex++)
 		{
-			// Get the current tile number
-			int tileIndex = tileIndexList[i + j * size.x];
-
-			// Set the tile at position i, j using the tileIndex
-			this->SetTile({ i, j }, tileIndex);
+			auto& chunk = chunkList[chunkIndex];
+			for (unsigned int j = 0; j < chunk.tileCount.y; j++)
+			{
+				for (unsigned int i = 0; i < chunk.tileCount.x; i++)
+				{
+					const sf::Vector2u position(chunk.tileOffset.x + i, chunk.tileOffset.y + j);
+					SetQuad(&chunk.vertices[(i + j * chunk.tileCount.x) * 4], position, tileIndexList[position.x + position.y * size.x], tilesetColumnCount);
+				}
+			}
 		}
-	}
+	};
 
-	isCreated = true;
+	if (threadPool != nullptr)
+		threadPool->ParallelFor(0, chunkList.size(), createChunks);
+	else
+		createChunks(0, chunkList.size());
 
-	std::cout << std::endl << "The tile map layer creation took: " << clock.getElapsedTime().asMicroseconds() << " microseconds";
+	isCreated = true;
+	IncrementRevision();
 }
 
 void TiledRenderComponent::SetTile(sf::Vector2u pos, size_t tileIndex)
 {
-	// Find the tiles position in the tileset texture
-	sf::Vector2u texPos;
-	const auto* tilesetTexture = renderStates.texture;
+	assert(pos.x < size.x && pos.y < size.y && "TiledRenderComponent: The tile position must lie within the layer");
 
-	if (tilesetTexture == nullptr)
-		throw std::runtime_error("TiledRenderComponent: A texture is needed to calculate the tile's vertex texture coordinates");
-
-	texPos.x = tileIndex % (tilesetTexture->getSize().x / tileSize.x);
-	texPos.y = tileIndex / (tilesetTexture->getSize().x / tileSize.x); // integer division
-
-	// Get a pointer to the current tile's quad
-	sf::Vertex* quad = &vertices[(pos.x + pos.y * size.x) * 4]; // The 4 because of the quads
+	SetQuad(GetQuad(pos), pos, tileIndex, GetTilesetColumnCount());
+	IncrementRevision();
+}
 
+void TiledRenderComponent::SetQuad(sf::Vertex* quad, sf::Vector2u pos, size_t tileIndex, unsigned int tilesetColumnCount) const
+{
 	// If the tile is empty (nothing should be drawn on this tile)
 	if (tileIndex == emptyTile)
 	{
@@ -85,6 +160,11 @@ void TiledRenderComponent::SetTile(sf::Vector2u pos, size_t tileIndex)
 		return;
 	}
 
+	// Find the tiles position in the tileset texture
+	sf::Vector2u texPos;
+	texPos.x = static_cast<unsigned int>(tileIndex % tilesetColumnCount);
+	texPos.y = static_cast<unsigned int>(tileIndex / tilesetColumnCount); // integer division
+
 	// Performs pointer arithmetic by increasing the pointer through the index operator
 	// Define its 4 corners
 	quad[0].position = static_cast<sf::Vector2f>(sf::Vector2u(pos.x * tileSize.x, pos.y * tileSize.y));
@@ -97,4 +177,25 @@ void TiledRenderComponent::SetTile(sf::Vector2u pos, size_t tileIndex)
 	quad[1].texCoords = static_cast<sf::Vector2f>(sf::Vector2u((texPos.x + 1u) * tileSize.x, texPos.y * tileSize.y));
 	quad[2].texCoords = static_cast<sf::Vector2f>(sf::Vector2u((texPos.x + 1u) * tileSize.x, (texPos.y + 1u) * tileSize.y));
 	quad[3].texCoords = static_cast<sf::Vector2f>(sf::Vector2u(texPos.x * tileSize.x, (texPos.y + 1u) * tileSize.y));
-}
\ No newline at end of file
+}
+
+unsigned int TiledRenderComponent::GetTilesetColumnCount() const
+{
+	const auto* tilesetTexture = renderStates.texture;
+
+	// Cannot calculate the texture coordinates for the tile without a texture
+	if (tilesetTexture == nullptr)
+		throw std::runtime_error("TiledRenderComponent: A texture is needed to calculate the tile's vertex texture coordinates");
+
+	return tilesetTexture->getSize().x / tileSize.x;
+}
+
+sf::Vertex* TiledRenderComponent::GetQuad(sf::Vector2u position)
+{
+	const unsigned int chunkSize = detail::TILE_CHUNK_SIZE;
+	auto& chunk = chunkList[position.x / chunkSize + (position.y / chunkSize) * chunkCount.x];
+
+	// The position within the chunk
+	const sf::Vector2u localPosition(position.x - chunk.tileOffset.x, position.y - chunk.tileOffset.y);
+	return &chunk.vertices[(localPosition.x + localPosition.y * chunk.tileCount.x) * 4]; // The 4 because of the quads
+}
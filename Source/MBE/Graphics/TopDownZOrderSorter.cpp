@@ -4,24 +4,65 @@ using namespace mbe;
 
 void TopDownZOrderSorter::operator()(std::vector<Entity::ID>& layer)
 {
+	frame++;
+
 	// Loop through this list and assign the zOrder
 	for (auto& topDownEntityId : layer)
 	{
-		// Make sure the entity has a RenderComponent
-		// Should this always be the case (yes when only used by the render system)
-		const bool hasRequiredComponents = topDownEntityId->HasComponents<RenderComponent, RenderInformationComponent>();
-		assert(hasRequiredComponents && "TopDownZOrderSorter: The entity must have a mbe::RenderComponent and mbe::RenderInformationComponent");
+		auto& cacheEntry = cacheEntryDictionary[topDownEntityId];
+		cacheEntry.frame = frame;
+
+		// Look up the components once when the entity is first seen
+		if (cacheEntry.renderComponent == nullptr)
+		{
+			// Make sure the entity has a RenderComponent
+			// Should this always be the case (yes when only used by the render system)
+			const bool hasRequiredComponents = topDownEntityId->HasComponents<RenderComponent, RenderInformationComponent>();
+			assert(hasRequiredComponents && "TopDownZOrderSorter: The entity must have a mbe::RenderComponent and mbe::RenderInformationComponent");
+
+			cacheEntry.renderComponent = &topDownEntityId->GetComponent<RenderComponent>();
+			cacheEntry.renderInformationComponent = &topDownEntityId->GetComponent<RenderInformationComponent>();
+		}
 
 		// Only sort entities with a mbe::TopDownInformationComponent
-		if (topDownEntityId->HasComponent<TopDownInformationComponent>())
+		if (cacheEntry.topDownInformationComponent == nullptr)
 		{
-			// Assign the z-order based on the objects position, height and logicalBottomOffset
-			const auto& topDownInformationComponent = topDownEntityId->GetComponent<TopDownInformationComponent>();
-			auto& renderComponent = topDownEntityId->GetComponent<RenderComponent>();
-			auto& renderInformationComponent = topDownEntityId->GetComponent<RenderInformationComponent>();
+			if (topDownEntityId->HasComponent<TopDownInformationComponent>() == false)
+				continue;
+
+			cacheEntry.topDownInformationComponent = &topDownEntityId->GetComponent<TopDownInformationComponent>();
+		}
 
-			auto zOrder = renderComponent.GetGlobalBounds().top + renderComponent.GetGlobalBounds().height - topDownInformationComponent.GetLogicalBottomOffset();
-			renderInformationComponent.SetZOrder(zOrder);
+		const auto& topDownInformationComponent = *cacheEntry.topDownInformationComponent;
+		const auto& renderComponent = *cacheEntry.renderComponent;
+
+		// Skip the entity if neither its bounds nor its logical bottom offset have changed
+		// The bounds of untracked render components may change at any time
+		if (cacheEntry.calculated
+			&& renderComponent.IsRevisionTracked()
+			&& cacheEntry.revision == renderComponent.GetRevision()
+			&& cacheEntry.logicalBottomOffset == topDownInformationComponent.GetLogicalBottomOffset())
+			continue;
+
+		cacheEntry.calculated = true;
+		cacheEntry.revision = renderComponent.GetRevision();
+		cacheEntry.logicalBottomOffset = topDownInformationComponent.GetLogicalBottomOffset();
+
+		// Assign the z-order based on the objects position, height and logicalBottomOffset
+		const auto globalBounds = renderComponent.GetGlobalBounds();
+		const auto zOrder = globalBounds.top + globalBounds.height - topDownInformationComponent.GetLogicalBottomOffset();
+		cacheEntry.renderInformationComponent->SetZOrder(zOrder);
+	}
+
+	// Forget the entities that have been removed from the layer
+	if (cacheEntryDictionary.size() > layer.size())
+	{
+		for (auto it = cacheEntryDictionary.begin(); it != cacheEntryDictionary.end();)
+		{
+			if (it->second.frame != frame)
+				it = cacheEntryDictionary.erase(it);
+			else
+				++it;
 		}
 	}
 }
@@ -1,17 +1,23 @@
 #include <MBE/Input/ClickableSystem.h>
 
+#include <cassert>
+
 #include <MBE/Input/MouseButtonReleasedEvent.h>
 #include <MBE/Input/EntityClickedEvent.h>
 #include <MBE/Graphics/RenderInformationComponent.h>
 #include <MBE/TransformComponent.h>
 #include <MBE/Graphics/TextureWrapperComponent.h>
+#include <MBE/Graphics/RenderSystem.h>
+#include <MBE/EntitySpatialHash.h>
 
 using namespace mbe;
 using mbe::event::MouseButtonReleasedEvent;
 
 ClickableSystem::ClickableSystem(EventManager& eventManager, EntityManager& entityManager) :
 	eventManager(eventManager),
-	entityManager(entityManager)
+	entityManager(entityManager),
+	spatialHash(nullptr),
+	renderSystem(nullptr)
 {
 	onClickSubscription = eventManager.Subscribe(EventManager::TCallback<MouseButtonReleasedEvent>([this](const MouseButtonReleasedEvent& event)
 		{
@@ -24,35 +30,31 @@ ClickableSystem::~ClickableSystem()
 	eventManager.UnSubscribe<MouseButtonReleasedEvent>(onClickSubscription);
 }
 
+void ClickableSystem::SetSpatialHash(EntitySpatialHash* spatialHash, const RenderSystem* renderSystem)
+{
+	assert((spatialHash == nullptr || renderSystem != nullptr) && "ClickableSystem: The render system must be set to use a spatial hash");
+
+	this->spatialHash = spatialHash;
+	this->renderSystem = renderSystem;
+}
+
 void ClickableSystem::OnClick(sf::Vector2f clickPosition, sf::Mouse::Button button)
 {
 	// Ptr since entity exist
 	std::vector<const Entity*> clickedEntityList;
 
-	for (const auto& entityId : entityManager.GetComponentGroup<ClickableComponent>())
+	if (spatialHash != nullptr)
 	{
-		// The entity must have an mbe::TextureWrapperComponent
-		if (entityId->HasComponent<TextureWrapperComponent>() == false)
-			continue;
+		candidateEntityIdList.clear();
+		FindCandidates(clickPosition);
 
-		const auto& clickableComponent = entityId->GetComponent<ClickableComponent>();
-		const auto& textureWrapperComponent = entityId->GetComponent<TextureWrapperComponent>();
-		const auto& textureRect = textureWrapperComponent.GetTextureRect();
-		const auto pixelMaskPtr = textureWrapperComponent.GetTextureWrapper().GetPixelMask();
-
-		// The pixel mask must be created
-		if (pixelMaskPtr == nullptr)
-			continue;
-
-		if (pixelMaskPtr->Contains(CalculatePosition(*entityId, clickPosition), textureRect))
-			//if (clickableComponent.Contains(CalculatePosition(entity, clickPosition)))
-		{
-			// If the entity has a renderInformationComponent the 'drawing' order + clickAbsorbtion must be taken into account
-			if (entityId->HasComponent<RenderInformationComponent>())
-				clickedEntityList.push_back(&*entityId);
-			else
-				RaiseClickEvents(clickableComponent, button);
-		}
+		for (const auto& entityId : candidateEntityIdList)
+			TestClick(*entityId, clickPosition, button, clickedEntityList);
+	}
+	else
+	{
+		for (const auto& entityId : entityManager.GetComponentGroup<ClickableComponent>())
+			TestClick(*entityId, clickPosition, button, clickedEntityList);
 	}
 
 	// Sort the clicked entity list by render order (in decending order)
@@ -73,6 +75,64 @@ void ClickableSystem::OnClick(sf::Vector2f clickPosition, sf::Mouse::Button butt
 	}
 }
 
+void ClickableSystem::FindCandidates(sf::Vector2f clickPosition)
+{
+	// Entities without a mbe::RenderInformationComponent take the click position directly
+	queryResultList.clear();
+	spatialHash->QueryPoint(clickPosition, queryResultList);
+	for (const auto& entityId : queryResultList)
+	{
+		if (entityId->HasComponent<ClickableComponent>() && entityId->HasComponent<RenderInformationComponent>() == false)
+			candidateEntityIdList.push_back(entityId);
+	}
+
+	// Entities with a mbe::RenderInformationComponent are drawn using the view of their render layer
+	const auto& window = renderSystem->GetRenderWindow();
+	for (auto renderLayer = RenderLayer::Background; renderLayer != RenderLayer::LayerCount; ++renderLayer)
+	{
+		const auto& view = renderSystem->GetView(renderLayer);
+
+		queryResultList.clear();
+		spatialHash->QueryPoint(window.mapPixelToCoords(static_cast<sf::Vector2i>(clickPosition), view), queryResultList);
+		for (const auto& entityId : queryResultList)
+		{
+			if (entityId->HasComponent<ClickableComponent>() == false || entityId->HasComponent<RenderInformationComponent>() == false)
+				continue;
+
+			// Each entity is only a candidate for the view it is drawn with
+			const auto& renderInformationComponent = entityId->GetComponent<RenderInformationComponent>();
+			if (renderInformationComponent.GetRenderLayer() == renderLayer && renderInformationComponent.GetView() == &view)
+				candidateEntityIdList.push_back(entityId);
+		}
+	}
+}
+
+void ClickableSystem::TestClick(const Entity& entity, sf::Vector2f clickPosition, sf::Mouse::Button button, std::vector<const Entity*>& clickedEntityList)
+{
+	// The entity must have an mbe::TextureWrapperComponent
+	if (entity.HasComponent<TextureWrapperComponent>() == false)
+		return;
+
+	const auto& clickableComponent = entity.GetComponent<ClickableComponent>();
+	const auto& textureWrapperComponent = entity.GetComponent<TextureWrapperComponent>();
+	const auto& textureRect = textureWrapperComponent.GetTextureRect();
+	const auto pixelMaskPtr = textureWrapperComponent.GetTextureWrapper().GetPixelMask();
+
+	// The pixel mask must be created
+	if (pixelMaskPtr == nullptr)
+		return;
+
+	if (pixelMaskPtr->Contains(CalculatePosition(entity, clickPosition), textureRect))
+		//if (clickableComponent.Contains(CalculatePosition(entity, clickPosition)))
+	{
+		// If the entity has a renderInformationComponent the 'drawing' order + clickAbsorbtion must be taken into account
+		if (entity.HasComponent<RenderInformationComponent>())
+			clickedEntityList.push_back(&entity);
+		else
+			RaiseClickEvents(clickableComponent, button);
+	}
+}
+
 sf::Vector2f ClickableSystem::CalculatePosition(const Entity& entity, sf::Vector2f clickPosition)
 {
 	if (entity.HasComponent<ClickableComponent>() && entity.HasComponent<TransformComponent>() && entity.HasComponent<RenderInformationComponent>())
@@ -84,14 +144,14 @@ sf::Vector2f ClickableSystem::CalculatePosition(const Entity& entity, sf::Vector
 		// Reverse the view transform
 		clickPosition = renderInformationComponent.GetRenderWindow()->mapPixelToCoords(static_cast<sf::Vector2i>(clickPosition), view);
 		// Reverse the entity transform
-		clickPosition = transformComponent.GetWorldTransform().getInverse().transformPoint(clickPosition);
+		clickPosition = transformComponent.GetInverseWorldTransform().transformPoint(clickPosition);
 	}
 	else if (entity.HasComponent<ClickableComponent>() && entity.HasComponent<TransformComponent>())
 	{
 		const auto& transformComponent = entity.GetComponent<TransformComponent>();
 
 		// Reverse the entity transform
-		clickPosition = transformComponent.GetWorldTransform().getInverse().transformPoint(clickPosition);
+		clickPosition = transformComponent.GetInverseWorldTransform().transformPoint(clickPosition);
 	}
 
 	return clickPosition;
@@ -0,0 +1,24 @@
+#include <MBE/Map/PathFoundEvent.h>
+
+using namespace mbe;
+using namespace mbe::event;
+
+PathFoundEvent::PathFoundEvent() :
+	entityId(Entity::GetNullID())
+{
+}
+
+PathFoundEvent::PathFoundEvent(Entity::ID entityId, Path path) :
+	entityId(entityId),
+	path(std::move(path))
+{
+}
+
+std::ostream& mbe::event::operator<<(std::ostream& stream, const PathFoundEvent& event)
+{
+	stream << "PathFoundEvent:\tEntityId: ";
+	stream << event.GetEntityID();
+	stream << "\tPath length: ";
+	stream << event.GetPath().size();
+	return stream;
+}
@@ -1,8 +1,23 @@
 #include <MBE/Map/TileComponent.h>
 
+#include <cassert>
+
 using namespace mbe;
 
 TileComponent::TileComponent(EventManager & eventManager, Entity & parentEntity)
 	: Component(eventManager, parentEntity)
 {
 }
+
+void TileComponent::SetTile(size_t position, size_t tileIndex)
+{
+	assert(position < indexList.size() && "TileComponent: The position must lie within the index list");
+
+	if (indexList[position] == tileIndex)
+		return;
+
+	indexList[position] = tileIndex;
+	changedTileList.push_back(position);
+
+	eventManager.RaiseEvent(event::ComponentValueChangedEvent<TileComponent>(*this, "Tile"));
+}
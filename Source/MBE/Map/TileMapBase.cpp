@@ -1,7 +1,14 @@
 #include <MBE/Map/TileMapBase.h>
 
+#include <algorithm>
+
 using namespace mbe;
 
+TileMapBase::TileMapBase(EventManager& eventManager)
+{
+	tileMapChangedSubscription.Subscribe(eventManager, *this);
+}
+
 sf::Vector2f TileMapBase::MapTileToCoord(const Position& tilePosition) const
 {
 	sf::Vector2f coordinate;
@@ -61,3 +68,58 @@ bool TileMapBase::IsOffsetFromTileCenter(const sf::Vector2f& coordinate) const
 {
 	return GetOffsetFromTileCenter(coordinate) != sf::Vector2f(0.f, 0.f);
 }
+
+void TileMapBase::InvalidateTiles(Position position, sf::Vector2u size)
+{
+	if (reachableTileMasksCreated.load(std::memory_order_acquire) == false)
+		return;
+
+	const auto mapSize = GetSize();
+	if (mapSize.x != reachableTileMaskWidth || reachableTileMaskList.size() != static_cast<size_t>(mapSize.x) * mapSize.y)
+	{
+		reachableTileMasksCreated.store(false, std::memory_order_release);
+		return;
+	}
+
+	ComputeReachableTileMasks(position, size);
+}
+
+void TileMapBase::CreateReachableTileMasks() const
+{
+	std::lock_guard<std::mutex> lock(reachableTileMaskMutex);
+	if (reachableTileMasksCreated.load(std::memory_order_relaxed))
+		return;
+
+	const auto size = GetSize();
+	reachableTileMaskWidth = size.x;
+	reachableTileMaskList.assign(static_cast<size_t>(size.x) * size.y, 0u);
+	ComputeReachableTileMasks(Position(0, 0), size);
+
+	reachableTileMasksCreated.store(true, std::memory_order_release);
+}
+
+void TileMapBase::ComputeReachableTileMasks(Position position, sf::Vector2u size) const
+{
+	const auto mapSize = GetSize();
+
+	// Include the surrounding tiles and clamp the area to the map
+	const int left = std::max(position.x - 1, 0);
+	const int top = std::max(position.y - 1, 0);
+	const int right = std::min(position.x + static_cast<int>(size.x) + 1, static_cast<int>(mapSize.x));
+	const int bottom = std::min(position.y + static_cast<int>(size.y) + 1, static_cast<int>(mapSize.y));
+
+	for (int y = top; y < bottom; y++)
+	{
+		for (int x = left; x < right; x++)
+		{
+			TileNeighbourMask neighbourMask = 0u;
+			for (const auto& reachablePosition : GetReachableTiles(x, y))
+			{
+				const TileNeighbourMask neighbourBit = detail::GetTileNeighbourBit(reachablePosition.x - x, reachablePosition.y - y);
+				assert(neighbourBit != 0u && "TileMapBase: Only tile maps where every reachable tile is a neighbour can use reachable tile masks");
+				neighbourMask |= neighbourBit;
+			}
+			reachableTileMaskList[static_cast<size_t>(y) * reachableTileMaskWidth + static_cast<size_t>(x)] = neighbourMask;
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#include <MBE/Map/TileMapChangedEvent.h>
+
+using namespace mbe;
+using namespace mbe::event;
+
+TileMapChangedEvent::TileMapChangedEvent() :
+	position(0, 0),
+	size(0u, 0u)
+{
+}
+
+TileMapChangedEvent::TileMapChangedEvent(sf::Vector2i position, sf::Vector2u size) :
+	position(position),
+	size(size)
+{
+}
+
+std::ostream& mbe::event::operator<<(std::ostream& stream, const TileMapChangedEvent& event)
+{
+	stream << "TileMapChangedEvent:\tPosition: " << event.GetPosition().x << ", " << event.GetPosition().y;
+	stream << "\tSize: " << event.GetSize().x << ", " << event.GetSize().y;
+	return stream;
+}
@@ -0,0 +1,23 @@
+#include <MBE/Map/TileMapChangedSubscription.h>
+
+using namespace mbe;
+using namespace mbe::detail;
+
+TileMapChangedSubscription::TileMapChangedSubscription() :
+	eventManager(nullptr)
+{
+}
+
+TileMapChangedSubscription::~TileMapChangedSubscription()
+{
+	UnSubscribe();
+}
+
+void TileMapChangedSubscription::UnSubscribe()
+{
+	if (eventManager == nullptr)
+		return;
+
+	eventManager->UnSubscribe<event::TileMapChangedEvent>(subscriptionId);
+	eventManager = nullptr;
+}
@@ -1,5 +1,8 @@
 #include "..\..\..\Include\MBE\Map\TileMapComponent.h"
 #include <MBE/Map/TileMapComponent.h>
+#include <MBE/Map/TileMapChangedEvent.h>
+
+#include <algorithm>
 
 using namespace mbe;
 
@@ -30,12 +33,33 @@ sf::Vector2u mbe::TileMapComponent::GetSize() const
 	return size;
 }
 
+void TileMapComponent::SetPosition(const Position& position)
+{
+	if (position == this->position)
+		return;
+
+	// Both the tiles that are no longer covered and the newly covered tiles change
+	const Position previousPosition = this->position;
+	this->position = position;
+	RaiseTileMapChangedEvent(previousPosition, GetSize());
+}
+
+void TileMapComponent::SetMovementSpeedShape(MovementSpeedShape&& movementSpeedShape)
+{
+	const sf::Vector2u previousSize = GetSize();
+	this->movementSpeedShape = std::move(movementSpeedShape);
+	RaiseTileMapChangedEvent(position, previousSize);
+}
+
 void TileMapComponent::SetMovementSpeed(unsigned int x, unsigned int y, float speed)
 {
 	if (y >= movementSpeedShape.size() || x >= movementSpeedShape[y].size())
 		throw std::out_of_range("TileMapComponent: The requested position does not fit within the shape");
 
 	movementSpeedShape[y][x] = speed;
+
+	event::TileMapChangedEvent tileMapChangedEvent(Position(position.x + static_cast<int>(x), position.y + static_cast<int>(y)), { 1u, 1u });
+	eventManager.RaiseEvent(tileMapChangedEvent);
 }
 
 void TileMapComponent::Rotate()
@@ -55,5 +79,41 @@ void TileMapComponent::Rotate()
 	}
 
 	movementSpeedShape = std::move(newShape);
+	RaiseTileMapChangedEvent(position, oldSize);
+}
+
+void TileMapComponent::RaiseTileMapChangedEvent(const Position& previousPosition, sf::Vector2u previousSize) const
+{
+	const auto size = GetSize();
+	const bool previousEmpty = previousSize.x == 0u || previousSize.y == 0u;
+	const bool empty = size.x == 0u || size.y == 0u;
+
+	// Overlapping areas are merged, so that the tiles in both are not invalidated twice
+	const bool overlapping = previousEmpty == false && empty == false
+		&& previousPosition.x < position.x + static_cast<int>(size.x) && position.x < previousPosition.x + static_cast<int>(previousSize.x)
+		&& previousPosition.y < position.y + static_cast<int>(size.y) && position.y < previousPosition.y + static_cast<int>(previousSize.y);
+
+	if (overlapping)
+	{
+		const Position topLeft(std::min(previousPosition.x, position.x), std::min(previousPosition.y, position.y));
+		const Position bottomRight(std::max(previousPosition.x + static_cast<int>(previousSize.x), position.x + static_cast<int>(size.x)),
+			std::max(previousPosition.y + static_cast<int>(previousSize.y), position.y + static_cast<int>(size.y)));
+
+		event::TileMapChangedEvent tileMapChangedEvent(topLeft, sf::Vector2u(bottomRight - topLeft));
+		eventManager.RaiseEvent(tileMapChangedEvent);
+		return;
+	}
+
+	if (previousEmpty == false)
+	{
+		event::TileMapChangedEvent tileMapChangedEvent(previousPosition, previousSize);
+		eventManager.RaiseEvent(tileMapChangedEvent);
+	}
+
+	if (empty == false)
+	{
+		event::TileMapChangedEvent tileMapChangedEvent(position, size);
+		eventManager.RaiseEvent(tileMapChangedEvent);
+	}
 }
 
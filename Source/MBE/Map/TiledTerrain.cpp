@@ -9,20 +9,22 @@ using TextureWrapperChangedEvent = mbe::event::ComponentValueChangedEvent<mbe::T
 using IndexListChangedEvent = mbe::event::ComponentValueChangedEvent<mbe::TileComponent>;
 
 // Remember to add subscriptions for the textureChangedEvent and indexListChangedEvent
-TiledTerrain::TiledTerrain(EventManager& eventManager, EntityManager& entityManager, sf::Vector2u size, sf::Vector2u tileSize) :
+TiledTerrain::TiledTerrain(EventManager& eventManager, EntityManager& entityManager, sf::Vector2u size, sf::Vector2u tileSize, ThreadPool* threadPool) :
 	eventManager(eventManager),
 	entityManager(entityManager),
 	size(size),
-	tileSize(tileSize)
+	tileSize(tileSize),
+	threadPool(threadPool)
 {
 	SubscribeEvents();
 }
 
-TiledTerrain::TiledTerrain(EventManager& eventManager, EntityManager& entityManager, Data::Ptr mapData, const std::string& tileMapTextureWrapperId) :
+TiledTerrain::TiledTerrain(EventManager& eventManager, EntityManager& entityManager, Data::Ptr mapData, const std::string& tileMapTextureWrapperId, ThreadPool* threadPool) :
 	eventManager(eventManager),
 	entityManager(entityManager),
 	size(mapData->GetMapSize()),
-	tileSize(mapData->GetTileSize())
+	tileSize(mapData->GetTileSize()),
+	threadPool(threadPool)
 {
 	SubscribeEvents();
 
@@ -34,7 +36,7 @@ TiledTerrain::TiledTerrain(EventManager& eventManager, EntityManager& entityMana
 		try
 		{
 			// Must exist
-			layerId->GetComponent<TiledRenderComponent>().Create(layer);
+			layerId->GetComponent<TiledRenderComponent>().Create(layer, threadPool);
 		}
 		catch (const std::runtime_error & error)
 		{
@@ -105,7 +107,7 @@ void TiledTerrain::RecalculateLayer(Entity& entity)
 	// Recalculate the indecies
 	try
 	{
-		entity.GetComponent<TiledRenderComponent>().Create(entity.GetComponent<TileComponent>().GetIndexList());
+		entity.GetComponent<TiledRenderComponent>().Create(entity.GetComponent<TileComponent>().GetIndexList(), threadPool);
 	}
 	catch (const std::runtime_error & error)
 	{
@@ -126,6 +128,8 @@ void TiledTerrain::SubscribeEvents()
 			}
 			else if (event.IsValueChanged("IndexList"))
 				OnIndexListChangedEvent(event.GetComponent());
+			else if (event.IsValueChanged("Tile"))
+				OnTileChangedEvent(event.GetComponent());
 		}));
 }
 
@@ -164,6 +168,26 @@ void TiledTerrain::OnIndexListChangedEvent(TileComponent& tileComponent)
 	RecalculateLayer(entity);
 }
 
+void TiledTerrain::OnTileChangedEvent(TileComponent& tileComponent)
+{
+	auto& entity = tileComponent.GetParentEntity();
+
+	if (!entity.HasComponent<TiledRenderComponent>())
+		return;
+
+	auto& renderComponent = entity.GetComponent<TiledRenderComponent>();
+
+	// The tiles can only be set once the layer has been created (the texture is known)
+	if (renderComponent.IsCreated())
+	{
+		const auto& indexList = tileComponent.GetIndexList();
+		for (const auto position : tileComponent.GetChangedTileList())
+			renderComponent.SetTile({ static_cast<unsigned int>(position % size.x), static_cast<unsigned int>(position / size.x) }, indexList[position]);
+	}
+
+	tileComponent.ClearChangedTileList();
+}
+
 void TiledTerrain::Data::Load(const std::string& filePath)
 {
 	using namespace tinyxml2;
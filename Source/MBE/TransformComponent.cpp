@@ -1,10 +1,15 @@
 #include <MBE/TransformComponent.h>
 
 using namespace mbe;
+using TransformChangedEvent = mbe::event::ComponentValueChangedEvent<TransformComponent>;
 
 TransformComponent::TransformComponent(EventManager & eventManager, Entity & parentEntity) :
-	Component(eventManager, parentEntity)
+	Component(eventManager, parentEntity),
+	worldTransformDirty(true),
+	inverseWorldTransformDirty(true)
 {
+	// The transforms of existing child entities now depend on this transform
+	MarkChildrenWorldTransformDirty();
 }
 
 sf::Vector2f TransformComponent::GetWorldPosition() const
@@ -14,23 +19,61 @@ sf::Vector2f TransformComponent::GetWorldPosition() const
 	return this->GetWorldTransform().transformPoint({ 0, 0 });
 }
 
-sf::Transform TransformComponent::GetWorldTransform() const
+const sf::Transform & TransformComponent::GetWorldTransform() const
 {
-	// Recursivly transform combine the transforms of all parent entities
+	if (worldTransformDirty == false)
+		return worldTransform;
 
-	sf::Transform transform{ sf::Transform::Identity };
+	// Combine the local transform with the world transform of the parent entity
+	// The parent's world transform is recalculated first if it is dirty as well
+	const auto& parentEntityId = this->parentEntity.GetParentEntityID();
+	if (parentEntityId.Valid() && parentEntityId->HasComponent<TransformComponent>())
+		worldTransform = parentEntityId->GetComponent<TransformComponent>().GetWorldTransform() * GetLocalTransform();
+	else
+		worldTransform = GetLocalTransform();
 
-	for (auto transformEntityId = this->parentEntity.GetHandleID(); transformEntityId.Valid() && transformEntityId->HasComponent<TransformComponent>(); )
-	{
-		// This should be guaranteed by the SetRelativeTo(parentTransformEntityId) method / constructor
-		assert(transformEntityId->HasComponent<TransformComponent>() && "TransformComponent: The entity must have a mbe::TransformComponent");
+	worldTransformDirty = false;
+	return worldTransform;
+}
 
-		// transform = transformComponent->getTransform() * transform;
-		transform = transformEntityId->GetComponent<TransformComponent>().GetLocalTransform() * transform;
+const sf::Transform & TransformComponent::GetInverseWorldTransform() const
+{
+	// Make sure that the world transform is up to date
+	const auto& transform = GetWorldTransform();
 
-		// transformComponent = transformComponent->parent
-		transformEntityId = transformEntityId->GetParentEntityID();
+	if (inverseWorldTransformDirty)
+	{
+		inverseWorldTransform = transform.getInverse();
+		inverseWorldTransformDirty = false;
 	}
 
-	return transform;
+	return inverseWorldTransform;
+}
+
+void TransformComponent::OnParentEntityChanged()
+{
+	MarkWorldTransformDirty();
+}
+
+void TransformComponent::MarkWorldTransformDirty()
+{
+	// The child transforms have already been marked
+	if (worldTransformDirty)
+		return;
+
+	worldTransformDirty = true;
+	inverseWorldTransformDirty = true;
+	MarkChildrenWorldTransformDirty();
+
+	eventManager.RaiseEvent(TransformChangedEvent(*this, "WorldTransform"));
+}
+
+void TransformComponent::MarkChildrenWorldTransformDirty()
+{
+	// Child entities without a transform component do not inherit this transform
+	for (const auto& childEntityId : this->parentEntity.GetChildEntityIDList())
+	{
+		if (childEntityId.Valid() && childEntityId->HasComponent<TransformComponent>())
+			childEntityId->GetComponent<TransformComponent>().MarkWorldTransformDirty();
+	}
 }
@@ -0,0 +1,42 @@
+#include <MBE/TransformSystem.h>
+
+using namespace mbe;
+
+TransformSystem::TransformSystem(const EntityManager & entityManager) :
+	entityManager(entityManager)
+{
+}
+
+void TransformSystem::Update()
+{
+	// Start at the root entities i.e. the entities whose transform does not depend on a parent transform
+	for (const auto& entityId : entityManager.GetComponentGroup<TransformComponent>())
+	{
+		if (entityId.Valid() == false)
+			continue;
+
+		const auto& parentEntityId = entityId->GetParentEntityID();
+		if (parentEntityId.Valid() && parentEntityId->HasComponent<TransformComponent>())
+			continue;
+
+		entityStack.push_back(entityId.GetEntityPtr());
+	}
+
+	// Depth first traversal
+	// Since a parent is always updated before its children, each dirty world transform is calculated using a single multiplication
+	while (entityStack.empty() == false)
+	{
+		const Entity& entity = *entityStack.back();
+		entityStack.pop_back();
+
+		const auto& transformComponent = entity.GetComponent<TransformComponent>();
+		if (transformComponent.IsWorldTransformDirty())
+			transformComponent.GetWorldTransform();
+
+		for (const auto& childEntityId : entity.GetChildEntityIDList())
+		{
+			if (childEntityId.Valid() && childEntityId->HasComponent<TransformComponent>())
+				entityStack.push_back(childEntityId.GetEntityPtr());
+		}
+	}
+}